@@ -0,0 +1,297 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file AMMapTileLoader.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Interface of the tile loaders serving the tiles from a memory
+/// mapped file
+
+#ifndef FASTIMAGE_AMMAPTILELOADER_H
+#define FASTIMAGE_AMMAPTILELOADER_H
+
+#include <memory>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include "FastImage/api/ATileLoader.h"
+#include "FastImage/data/DataType.h"
+#include "FastImage/object/MappedFile.h"
+#include "FastImage/object/PixelConverter.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class AMMapTileLoader AMMapTileLoader.h <FastImage/TileLoaders/AMMapTileLoader.h>
+  *
+  * @brief Tile loader serving the tiles of an uncompressed file mapped in
+  * memory.
+  *
+  * @details The file is mapped once (fi::MappedFile) and the mapping is
+  * shared by the tile loader copies. A tile is found by pointer arithmetic
+  * and copied from the page cache into the cached tile, or converted to
+  * UserType with fi::PixelConverter, without any intermediate buffer. The
+  * pixels outside of the image are set to 0. The kernel read ahead is chosen
+  * from the traversal: sequential for the naive and snake traversals, else
+  * random with an explicit read ahead of each tile.
+  * The file has to be in the machine byte order.
+  * A specialized tile loader has to set the image and tile sizes, the pixel
+  * format, and to implement:
+  * @code
+  *  virtual const uint8_t *getTileAddress(uint32_t indexRowGlobalTile,
+  *                                 uint32_t indexColGlobalTile) const = 0;
+  *  virtual size_t getRowStride() const = 0;
+  *  virtual ATileLoader<UserType> *copyTileLoader() = 0;
+  *  std::string getName() override = 0;
+  * @endcode
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class AMMapTileLoader : public ATileLoader<UserType> {
+ public:
+  /// \brief AMMapTileLoader constructor, map the file
+  /// \param fileName File path
+  /// \param numThreads Number of threads used by the tile loader
+  explicit AMMapTileLoader(const std::string &fileName, size_t numThreads = 1)
+      : ATileLoader<UserType>(fileName, numThreads),
+        _file(std::make_shared<MappedFile>(fileName)) {}
+
+  /// \brief Get Image height
+  /// \return Image height in px
+  uint32_t getImageHeight(uint32_t level = 0) const override {
+    return _imageHeight;
+  }
+
+  /// \brief Get Image width
+  /// \return Image width in px
+  uint32_t getImageWidth(uint32_t level = 0) const override {
+    return _imageWidth;
+  }
+
+  /// \brief Get tile width
+  /// \return Tile width in px
+  uint32_t getTileWidth(uint32_t level = 0) const override {
+    return _tileWidth;
+  }
+
+  /// \brief Get tile height
+  /// \return Tile height in px
+  uint32_t getTileHeight(uint32_t level = 0) const override {
+    return _tileHeight;
+  }
+
+  /// \brief Get the bits per sample from the file
+  /// \return the number of bits per sample
+  short getBitsPerSample() const override { return _bitsPerSample; }
+
+  /// \brief Get the sample format from the file
+  /// \return Sample format as defined by libtiff (1: unsigned integer, 2:
+  /// signed integer, 3: floating point)
+  short getSampleFormat() const { return _sampleFormat; }
+
+  /// \brief Getter to the number of pyramids levels, the image is planar
+  /// \return 1
+  uint32_t getNbPyramidLevels() const override { return 1; }
+
+  /// \brief Get down scale Factor, the image is planar
+  /// \param level level to ask--> Not used
+  /// \return 1
+  float getDownScaleFactor(uint32_t level = 0) override { return 1; }
+
+  /// \brief Set the scale and offset applied to each pixel loaded
+  /// (UserType) (pixel * scale + offset)
+  /// \details Has to be set before the FastImage configuration, so the tile
+  /// loader copies get it.
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  void setNormalization(double scale, double offset) {
+    _scale = scale;
+    _offset = offset;
+  }
+
+  /// \brief Get the identity of the decoding, the loader type and the
+  /// normalization
+  /// \return Identity of the decoding
+  std::string getDecodeIdentity() override {
+    std::stringstream identity;
+    identity << this->getName() << ", scale " << std::setprecision(17)
+             << _scale << ", offset " << _offset;
+    return identity.str();
+  }
+
+  /// \brief Advise the kernel about the file accesses from the traversal
+  /// \param traversalType Traversal used to traverse the image
+  void setTraversalType(TraversalType traversalType) override {
+    _file->advise(traversalType);
+    _readAhead = traversalType != TraversalType::NAIVE
+        && traversalType != TraversalType::SNAKE;
+  }
+
+  /// \brief Load a tile from the mapped file
+  /// \details Copy the tile from the mapping if the file pixel type is
+  /// UserType, else convert it, row by row if the tile rows are not
+  /// contiguous in the file
+  /// \param tile Pointer to a tile already allocated to fill
+  /// \param indexRowGlobalTile Row index tile asked
+  /// \param indexColGlobalTile Column Index tile asked
+  /// \return Duration in nS to load a tile from the page cache (page faults
+  /// included), use for statistics purpose
+  double loadTileFromFile(UserType *tile,
+                          uint32_t indexRowGlobalTile,
+                          uint32_t indexColGlobalTile) override {
+    auto begin = std::chrono::high_resolution_clock::now();
+    const uint8_t *src = getTileAddress(indexRowGlobalTile, indexColGlobalTile);
+    uint32_t
+        height = std::min(_tileHeight,
+                          _imageHeight - indexRowGlobalTile * _tileHeight),
+        width = std::min(_tileWidth,
+                         _imageWidth - indexColGlobalTile * _tileWidth);
+    size_t
+        pixelSize = (size_t) _bitsPerSample / 8,
+        rowStride = getRowStride();
+
+    // Sparse tile, not stored in the file
+    if (src == nullptr) {
+      height = 0;
+      width = 0;
+    } else if (_readAhead) {
+      _file->willNeed((size_t) (src - _file->getData()),
+                      (height - 1) * rowStride + width * pixelSize);
+    }
+
+    if (width == _tileWidth && rowStride == width * pixelSize) {
+      copyPixels(src, tile, (size_t) height * width);
+    } else {
+      for (uint32_t row = 0; row < height; ++row) {
+        copyPixels(src + row * rowStride, tile + row * _tileWidth, width);
+        std::fill_n(tile + row * _tileWidth + width, _tileWidth - width,
+                    (UserType) 0);
+      }
+    }
+    std::fill(tile + (size_t) height * _tileWidth,
+              tile + (size_t) _tileHeight * _tileWidth, (UserType) 0);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - begin).count();
+  }
+
+  /// \brief Get the address of the first pixel of a tile in the mapped file
+  /// \param indexRowGlobalTile Row index tile asked
+  /// \param indexColGlobalTile Column Index tile asked
+  /// \return Address of the tile first pixel, nullptr if the tile is not
+  /// stored in the file
+  virtual const uint8_t *getTileAddress(uint32_t indexRowGlobalTile,
+                                        uint32_t indexColGlobalTile) const = 0;
+
+  /// \brief Get the distance between two rows of a tile in the file
+  /// \return Distance between two rows of a tile in bytes
+  virtual size_t getRowStride() const = 0;
+
+ protected:
+  /// \brief AMMapTileLoader constructor used by the copy operator, share the
+  /// mapping
+  /// \param numThreads Number of threads used by the tile loader
+  /// \param from Origin tile loader
+  AMMapTileLoader(size_t numThreads, const AMMapTileLoader &from)
+      : ATileLoader<UserType>(from.getFilePath(), numThreads),
+        _file(from._file),
+        _imageHeight(from._imageHeight),
+        _imageWidth(from._imageWidth),
+        _tileHeight(from._tileHeight),
+        _tileWidth(from._tileWidth),
+        _scale(from._scale),
+        _offset(from._offset),
+        _sampleFormat(from._sampleFormat),
+        _bitsPerSample(from._bitsPerSample),
+        _readAhead(from._readAhead) {}
+
+  /// \brief Check the pixel format, and that a region is inside the file
+  /// \param offset Region offset in bytes
+  /// \param length Region length in bytes
+  void checkRegion(uint64_t offset, uint64_t length) const {
+    std::stringstream message;
+    if ((_sampleFormat < 1 || _sampleFormat > 3)
+        || (_bitsPerSample != 8 && _bitsPerSample != 16
+            && _bitsPerSample != 32 && _bitsPerSample != 64)
+        || (_sampleFormat == 3
+            && _bitsPerSample != 32 && _bitsPerSample != 64)) {
+      message << "Tile Loader ERROR: The data format is not supported, "
+                 "sample format = " << _sampleFormat
+              << ", number bits per pixel = " << _bitsPerSample << ".";
+    } else if (offset > _file->getSize()
+        || length > _file->getSize() - offset) {
+      message << "Tile Loader ERROR: The region [" << offset << ", "
+              << offset + length << "[ is outside of the file ("
+              << _file->getSize() << " bytes).";
+    } else {
+      return;
+    }
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  std::shared_ptr<MappedFile>
+      _file;                      ///< File mapped, shared by the copies
+
+  uint32_t
+      _imageHeight = 0,           ///< Image height in pixel
+      _imageWidth = 0,            ///< Image width in pixel
+      _tileHeight = 0,            ///< Tile height
+      _tileWidth = 0;             ///< Tile width
+
+  double
+      _scale = 1.,                ///< Scale applied to each pixel
+      _offset = 0.;               ///< Offset added to each pixel
+
+  short
+      _sampleFormat = 1,          ///< Sample format as defined by libtiff
+      _bitsPerSample = 8;         ///< Bit Per Sample as defined by libtiff
+
+ private:
+  /// \brief Private function. Copy or convert pixels from the mapped file
+  /// \param src Source pixels in the mapped file
+  /// \param dest Destination pixels
+  /// \param nbPixels Number of pixels
+  void copyPixels(const uint8_t *src, UserType *dest, size_t nbPixels) const {
+    if (isPixelType<UserType>(_sampleFormat, _bitsPerSample)
+        && _scale == 1. && _offset == 0.) {
+      std::memcpy(dest, src, nbPixels * sizeof(UserType));
+    } else {
+      convertPixels(src, dest, nbPixels, _sampleFormat, _bitsPerSample,
+                    _scale, _offset);
+    }
+  }
+
+  bool
+      _readAhead = false;         ///< True if each tile is read ahead
+};
+}
+#endif //FASTIMAGE_AMMAPTILELOADER_H
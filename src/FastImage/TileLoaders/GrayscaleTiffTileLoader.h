@@ -46,9 +46,12 @@
 #include <tiffio.h>
 #endif
 
+#include <iomanip>
+#include <sstream>
 #include "FastImage/api/ATileLoader.h"
 #include "FastImage/data/DataType.h"
 #include "FastImage/object/FigCache.h"
+#include "FastImage/object/PixelConverter.h"
 
 namespace fi {
 /// \namespace fi FastImage namespace
@@ -61,6 +64,13 @@ namespace fi {
    * @details Tile Loader specialized in grayscale tiff images.
    * It opens the file, test if it is grayscale and tiled, and extract tiles from it.
    * Each tile' pixels are converted to the UserType format.
+   * Each tile loader (one per thread) reuses its own decoding buffer. If the
+   * file pixel type is UserType, the tiles are decoded directly into the
+   * cached tiles, without conversion. Else the pixels are converted with
+   * fi::PixelConverter, optionally scaled and offset (setNormalization).
+   * With libtiff 4.1 or later, the raw tiles can be read and decoded
+   * separately, to split the loading in two stages (fi::RawTileReader), the
+   * raw tiles being possibly read asynchronously from their location.
    * It implements the following functions from the ATileLoader:
    * @code
    *  std::string getName() override = 0;
@@ -125,6 +135,7 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
         _sampleFormat = 1;
       }
 
+      initDecoding();
     } else {
       std::stringstream message;
       message << "Tile Loader ERROR: The image can not be opened.";
@@ -134,8 +145,12 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
   }
 
   /// \brief TiffTileLoader default destructor
-  /// \details Destroy a GrayscaleTiffTileLoader and close the underlined file
+  /// \details Destroy a GrayscaleTiffTileLoader, free the decoding buffer
+  /// and close the underlined file
   ~GrayscaleTiffTileLoader() {
+    if (this->_tiffTile != nullptr) {
+      _TIFFfree(this->_tiffTile);
+    }
     if (this->_tiff != nullptr) {
       TIFFClose(this->_tiff);
     }
@@ -187,12 +202,22 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
   /// \param dest Tile buffer
   template<typename FileType>
   void loadTile(tdata_t src, UserType *dest) {
-    for (uint32_t row = 0; row < _tileHeight; ++row) {
-      for (uint32_t col = 0; col < _tileWidth; ++col) {
-        dest[row * _tileWidth + col] =
-            (UserType) ((FileType *) (src))[row * _tileWidth + col];
-      }
-    }
+    PixelConverter<FileType, UserType>::convert(
+        (const FileType *) src, dest, (size_t) _tileHeight * _tileWidth,
+        _scale, _offset);
+  }
+
+  /// \brief Set the scale and offset applied to each pixel loaded
+  /// (UserType) (pixel * scale + offset)
+  /// \details Has to be set before the FastImage configuration, so the tile
+  /// loader copies get it. With a normalization, the tiles are never decoded
+  /// directly into the cached tiles.
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  void setNormalization(double scale, double offset) {
+    _scale = scale;
+    _offset = offset;
+    initDecoding();
   }
 
   /// \brief Get down scale Factor for pyramid images. The tiff image for this
@@ -202,9 +227,9 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
   float getDownScaleFactor(uint32_t level = 0) override { return 1; }
 
   /// \brief Load a tile from the disk
-  /// \details Allocate a buffer, load a tile from the file into the buffer,
-  /// cast each pixel to the right format into parameter tile, and close
-  /// the buffer.
+  /// \details Load a tile from the file directly into parameter tile if the
+  /// file pixel type is UserType. Else load it into the loader's decoding
+  /// buffer, and cast each pixel to the right format into parameter tile.
   /// \param tile Pointer to a tile already allocated to fill
   /// \param indexRowGlobalTile Row index tile asked
   /// \param indexColGlobalTile Column Index tile asked
@@ -213,11 +238,9 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
   double loadTileFromFile(UserType *tile,
                           uint32_t indexRowGlobalTile,
                           uint32_t indexColGlobalTile) override {
-    tdata_t tiffTile = nullptr;
-    tiffTile = _TIFFmalloc(TIFFTileSize(_tiff));
     auto begin = std::chrono::high_resolution_clock::now();
     TIFFReadTile(_tiff,
-                 tiffTile,
+                 _directDecoding ? (tdata_t) tile : _tiffTile,
                  indexColGlobalTile * _tileWidth,
                  indexRowGlobalTile * _tileHeight,
                  0,
@@ -225,76 +248,102 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
     auto end = std::chrono::high_resolution_clock::now();
     double diskDuration = (std::chrono::duration_cast<std::chrono::nanoseconds>(
         end - begin).count());
-    std::stringstream message;
-    switch (this->_sampleFormat) {
-      case 1 :
-        switch (this->_bitsPerSample) {
-          case 8:loadTile<uint8_t>(tiffTile, tile);
-            break;
-          case 16:loadTile<uint16_t>(tiffTile, tile);
-            break;
-          case 32:loadTile<uint32_t>(tiffTile, tile);
-            break;
-          case 64:loadTile<uint64_t>(tiffTile, tile);
-            break;
-          default:
-            message
-                << "Tile Loader ERROR: The data format is not supported for "
-                   "unsigned integer, number bits per pixel = "
-                << this->_bitsPerSample;
-            std::string m = message.str();
-            throw (FastImageException(m));
-        }
-        break;
-      case 2:
-        switch (this->_bitsPerSample) {
-          case 8:loadTile<int8_t>(tiffTile, tile);
-            break;
-          case 16:loadTile<int16_t>(tiffTile, tile);
-            break;
-          case 32:loadTile<int32_t>(tiffTile, tile);
-            break;
-          case 64:loadTile<int64_t>(tiffTile, tile);
-            break;
-          default:
-            message
-                << "Tile Loader ERROR: The data format is not supported for "
-                   "signed integer, number bits per pixel = "
-                << this->_bitsPerSample;
-            std::string m = message.str();
-            throw (FastImageException(m));
-        }
-        break;
-      case 3:
-        switch (this->_bitsPerSample) {
-          case 8:loadTile<float>(tiffTile, tile);
-            break;
-          case 16:loadTile<float>(tiffTile, tile);
-            break;
-          case 32:loadTile<float>(tiffTile, tile);
-            break;
-          case 64:loadTile<double>(tiffTile, tile);
-            break;
-          default:
-            message
-                << "Tile Loader ERROR: The data format is not supported for "
-                   "float, number bits per pixel = " << this->_bitsPerSample;
-            std::string m = message.str();
-            throw (FastImageException(m));
-        }
-        break;
-      default:
-        message
-            << "Tile Loader ERROR: The data format is not supported, sample "
-               "format = " << this->_sampleFormat;
-        std::string m = message.str();
-        throw (FastImageException(m));
+    if (!_directDecoding) { convertTile(_tiffTile, tile); }
+    return diskDuration;
+  }
+
+  /// \brief Test if the raw tiles can be read and decoded separately, needs
+  /// libtiff 4.1 or later
+  /// \return True if the raw tiles can be read and decoded separately
+  bool hasRawTileReader() const override {
+#if TIFFLIB_VERSION >= 20191103
+    return true;
+#else
+    return false;
+#endif
+  }
+
+#if TIFFLIB_VERSION >= 20191103
+  /// \brief Read a raw (not decoded) tile from the file
+  /// \param indexRowGlobalTile Row index tile asked
+  /// \param indexColGlobalTile Column Index tile asked
+  /// \param rawTile Buffer to fill with the raw tile, resized if needed
+  /// \return Duration in nS to read the raw tile from the disk, use for
+  /// statistics purpose
+  double readRawTile(uint32_t indexRowGlobalTile,
+                     uint32_t indexColGlobalTile,
+                     std::vector<uint8_t> &rawTile) override {
+    ttile_t tileIndex = TIFFComputeTile(_tiff,
+                                        indexColGlobalTile * _tileWidth,
+                                        indexRowGlobalTile * _tileHeight,
+                                        0, 0);
+    rawTile.resize(TIFFGetStrileByteCount(_tiff, tileIndex));
+    auto begin = std::chrono::high_resolution_clock::now();
+    if (TIFFReadRawTile(_tiff, tileIndex, rawTile.data(),
+                        (tsize_t) rawTile.size()) < 0) {
+      std::stringstream message;
+      message << "Tile Loader ERROR: The raw tile (" << indexRowGlobalTile
+              << ", " << indexColGlobalTile << ") can not be read.";
+      std::string m = message.str();
+      throw (FastImageException(m));
     }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - begin).count();
+  }
 
-    _TIFFfree(tiffTile);
-    return diskDuration;
+  /// \brief Get the location of a raw tile in the file
+  /// \param indexRowGlobalTile Row index tile asked
+  /// \param indexColGlobalTile Column Index tile asked
+  /// \param offset Raw tile offset in the file in bytes
+  /// \param length Raw tile length in bytes, 0 if the tile is not stored
+  /// \return True
+  bool getRawTileLocation(uint32_t indexRowGlobalTile,
+                          uint32_t indexColGlobalTile,
+                          uint64_t &offset,
+                          uint64_t &length) override {
+    ttile_t tileIndex = TIFFComputeTile(_tiff,
+                                        indexColGlobalTile * _tileWidth,
+                                        indexRowGlobalTile * _tileHeight,
+                                        0, 0);
+    offset = TIFFGetStrileOffset(_tiff, tileIndex);
+    length = TIFFGetStrileByteCount(_tiff, tileIndex);
+    return true;
   }
 
+  /// \brief Decode a raw tile with the file compression, and convert it to
+  /// UserType
+  /// \param tile Tile to decode into
+  /// \param indexRowGlobalTile Row index tile asked
+  /// \param indexColGlobalTile Column Index tile asked
+  /// \param rawTile Raw tile
+  void decodeTile(UserType *tile,
+                  uint32_t indexRowGlobalTile,
+                  uint32_t indexColGlobalTile,
+                  std::vector<uint8_t> &rawTile) override {
+    // Sparse tile, not stored in the file, let libtiff fill it
+    if (rawTile.empty()) {
+      loadTileFromFile(tile, indexRowGlobalTile, indexColGlobalTile);
+      return;
+    }
+    ttile_t tileIndex = TIFFComputeTile(_tiff,
+                                        indexColGlobalTile * _tileWidth,
+                                        indexRowGlobalTile * _tileHeight,
+                                        0, 0);
+    if (TIFFReadFromUserBuffer(_tiff, tileIndex,
+                               rawTile.data(), (tsize_t) rawTile.size(),
+                               _directDecoding ? (tdata_t) tile : _tiffTile,
+                               TIFFTileSize(_tiff)) == 0) {
+      std::stringstream message;
+      message << "Tile Loader ERROR: The raw tile (" << indexRowGlobalTile
+              << ", " << indexColGlobalTile << ") can not be decoded.";
+      std::string m = message.str();
+      throw (FastImageException(m));
+    }
+    if (!_directDecoding) { convertTile(_tiffTile, tile); }
+  }
+#endif
+
   /// \brief Copy function used by HTGS to use multiple Tile Loader
   /// \return  A new ATileLoader copied
   ATileLoader<UserType> *copyTileLoader() override {
@@ -309,7 +358,40 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
     return "TIFF Tile Loader";
   }
 
+  /// \brief Get the identity of the decoding, the loader type and the
+  /// normalization
+  /// \return Identity of the decoding
+  std::string getDecodeIdentity() override {
+    std::stringstream identity;
+    identity << this->getName() << ", scale " << std::setprecision(17)
+             << _scale << ", offset " << _offset;
+    return identity.str();
+  }
+
  private:
+  /// \brief Private function. Cast each pixel of the decoded tile from the
+  /// file type to UserType
+  /// \param tiffTile Decoded tile
+  /// \param tile Tile buffer to fill
+  void convertTile(tdata_t tiffTile, UserType *tile) {
+    convertPixels(tiffTile, tile, (size_t) _tileHeight * _tileWidth,
+                  _sampleFormat, _bitsPerSample, _scale, _offset);
+  }
+
+  /// \brief Private function. Choose between the direct decoding into the
+  /// cached tiles and the decoding into a buffer followed by a conversion.
+  /// The buffer is allocated once for the loader.
+  void initDecoding() {
+    _directDecoding =
+        isPixelType<UserType>(_sampleFormat, _bitsPerSample)
+            && _scale == 1. && _offset == 0.
+            && (tsize_t) (sizeof(UserType) * _tileHeight * _tileWidth)
+                == TIFFTileSize(_tiff);
+    if (!_directDecoding && _tiffTile == nullptr) {
+      _tiffTile = _TIFFmalloc(TIFFTileSize(_tiff));
+    }
+  }
+
   /// \brief TiffTileLoader constructor used by the copy operator
   /// \param numThreads Number of thread used by the tiff tile loader
   /// \param filePath File path
@@ -325,17 +407,31 @@ class GrayscaleTiffTileLoader : public ATileLoader<UserType> {
     this->_tileHeight = from._tileHeight;
     this->_bitsPerSample = from._bitsPerSample;
     this->_sampleFormat = from._sampleFormat;
+    this->_scale = from._scale;
+    this->_offset = from._offset;
+    initDecoding();
   }
 
   TIFF *
       _tiff = nullptr;             ///< Tiff file pointer
 
+  tdata_t
+      _tiffTile = nullptr;         ///< Decoding buffer, reused for each tile
+
+  bool
+      _directDecoding = false;     ///< True if the tiles are decoded directly
+                                   ///< into the cached tiles
+
   uint32_t
       _imageHeight = 0,           ///< Image height in pixel
       _imageWidth = 0,            ///< Image width in pixel
       _tileHeight = 0,            ///< Tile height
       _tileWidth = 0;             ///< Tile width
 
+  double
+      _scale = 1.,                ///< Scale applied to each pixel
+      _offset = 0.;               ///< Offset added to each pixel
+
   short
       _sampleFormat = 0,          ///< Sample format as defined by libtiff
       _bitsPerSample = 0;         ///< Bit Per Sample as defined by libtiff
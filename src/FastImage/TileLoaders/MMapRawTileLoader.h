@@ -0,0 +1,282 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file MMapRawTileLoader.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Implements the memory mapped raw and numpy (.npy) tile loader class
+
+#ifndef FASTIMAGE_MMAPRAWTILELOADER_H
+#define FASTIMAGE_MMAPRAWTILELOADER_H
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "FastImage/TileLoaders/AMMapTileLoader.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+   * @class MMapRawTileLoader MMapRawTileLoader.h <FastImage/TileLoaders/MMapRawTileLoader.h>
+   *
+   * @brief Tile loader for headerless raw images and numpy (.npy) arrays,
+   * served from a memory mapping.
+   *
+   * @details The pixels are stored row major, without tiles: the tiles are
+   * cut from the image rows by pointer arithmetic in the mapped file (see
+   * fi::AMMapTileLoader). For a volume, one plane is loaded: a plane of a
+   * raw volume is chosen with the offset of its first pixel, a plane of a
+   * numpy volume (shape (depth, height, width)) with its index.
+   * The pixel format is given as in libtiff: the sample format (1: unsigned
+   * integer, 2: signed integer, 3: floating point) and the number of bits
+   * per sample.
+   * @code
+   * // Raw uint16 image of 1024 x 2048 pixels, after a header of 512 bytes
+   * auto rawLoader = new fi::MMapRawTileLoader<float>(
+   *     "image.raw", 1024, 2048, 256, 256, 1, 16, 512);
+   * // Third plane of a numpy volume
+   * auto npyLoader = new fi::MMapRawTileLoader<float>(
+   *     "volume.npy", 256, 256, 2);
+   * @endcode
+   *
+   * @tparam UserType Pixel Type asked by the end user
+   */
+template<typename UserType>
+class MMapRawTileLoader : public AMMapTileLoader<UserType> {
+ public:
+  /// \brief MMapRawTileLoader constructor for a headerless raw image
+  /// \param fileName File path
+  /// \param imageHeight Image height in pixel
+  /// \param imageWidth Image width in pixel
+  /// \param tileHeight Tile height in pixel
+  /// \param tileWidth Tile width in pixel
+  /// \param sampleFormat Sample format (1: unsigned integer, 2: signed
+  /// integer, 3: floating point)
+  /// \param bitsPerSample Number of bits per sample (8, 16, 32 or 64)
+  /// \param offset Offset of the first pixel in the file in bytes
+  /// \param numThreads Number of threads used by the tile loader
+  MMapRawTileLoader(const std::string &fileName,
+                    uint32_t imageHeight,
+                    uint32_t imageWidth,
+                    uint32_t tileHeight,
+                    uint32_t tileWidth,
+                    short sampleFormat,
+                    short bitsPerSample,
+                    uint64_t offset = 0,
+                    size_t numThreads = 1)
+      : AMMapTileLoader<UserType>(fileName, numThreads), _dataOffset(offset) {
+    this->_imageHeight = imageHeight;
+    this->_imageWidth = imageWidth;
+    this->_tileHeight = tileHeight;
+    this->_tileWidth = tileWidth;
+    this->_sampleFormat = sampleFormat;
+    this->_bitsPerSample = bitsPerSample;
+    checkImage();
+  }
+
+  /// \brief MMapRawTileLoader constructor for a numpy array (.npy)
+  /// \details Parse the numpy header to get the image size and the pixel
+  /// format. The array has to be in C order and in the machine byte order.
+  /// \param fileName File path
+  /// \param tileHeight Tile height in pixel
+  /// \param tileWidth Tile width in pixel
+  /// \param plane Plane index for a volume (shape (depth, height, width))
+  /// \param numThreads Number of threads used by the tile loader
+  MMapRawTileLoader(const std::string &fileName,
+                    uint32_t tileHeight,
+                    uint32_t tileWidth,
+                    uint32_t plane = 0,
+                    size_t numThreads = 1)
+      : AMMapTileLoader<UserType>(fileName, numThreads) {
+    this->_tileHeight = tileHeight;
+    this->_tileWidth = tileWidth;
+    parseNpyHeader(plane);
+    checkImage();
+  }
+
+  /// \brief Get the address of the first pixel of a tile in the mapped file
+  /// \param indexRowGlobalTile Row index tile asked
+  /// \param indexColGlobalTile Column Index tile asked
+  /// \return Address of the tile first pixel
+  const uint8_t *getTileAddress(uint32_t indexRowGlobalTile,
+                                uint32_t indexColGlobalTile) const override {
+    return this->_file->getData() + _dataOffset
+        + (uint64_t) indexRowGlobalTile * this->_tileHeight * getRowStride()
+        + (uint64_t) indexColGlobalTile * this->_tileWidth
+            * (this->_bitsPerSample / 8);
+  }
+
+  /// \brief Get the distance between two rows of a tile, an image row
+  /// \return Image width in bytes
+  size_t getRowStride() const override {
+    return (size_t) this->_imageWidth * this->_bitsPerSample / 8;
+  }
+
+  /// \brief Copy function used by HTGS to use multiple Tile Loader, the
+  /// mapping is shared
+  /// \return  A new ATileLoader copied
+  ATileLoader<UserType> *copyTileLoader() override {
+    return new MMapRawTileLoader<UserType>(this->getNumThreads(), *this);
+  }
+
+  /// \brief Get the name of the tile loader
+  /// \return Name of the tile loader
+  std::string getName() override { return "MMap Raw Tile Loader"; }
+
+ private:
+  /// \brief MMapRawTileLoader constructor used by the copy operator
+  /// \param numThreads Number of threads used by the tile loader
+  /// \param from Origin MMapRawTileLoader
+  MMapRawTileLoader(size_t numThreads, const MMapRawTileLoader &from)
+      : AMMapTileLoader<UserType>(numThreads, from),
+        _dataOffset(from._dataOffset) {}
+
+  /// \brief Private function. Check the sizes, the pixel format, and that
+  /// the image is inside of the file
+  void checkImage() const {
+    if (this->_imageHeight == 0 || this->_imageWidth == 0
+        || this->_tileHeight == 0 || this->_tileWidth == 0) {
+      std::stringstream message;
+      message << "Tile Loader ERROR: The image and tile sizes can not be 0.";
+      std::string m = message.str();
+      throw (FastImageException(m));
+    }
+    this->checkRegion(_dataOffset,
+                      (uint64_t) this->_imageHeight * getRowStride());
+  }
+
+  /// \brief Private function. Parse the numpy header, and set the image size,
+  /// the pixel format and the offset of the plane
+  /// \details The header is a python dictionary, as
+  /// {'descr': '<u2', 'fortran_order': False, 'shape': (512, 1024), }
+  /// \param plane Plane index for a volume
+  void parseNpyHeader(uint32_t plane) {
+    const char *file = (const char *) this->_file->getData();
+    size_t fileSize = this->_file->getSize();
+    std::vector<uint64_t> shape;
+    std::string header;
+    uint64_t headerEnd = 0;
+
+    // Magic string, version, header length (16 bits in version 1, else 32)
+    if (fileSize >= 10 && std::memcmp(file, "\x93NUMPY", 6) == 0) {
+      const auto *length = (const uint8_t *) file + 8;
+      headerEnd = file[6] == 1 ?
+                  10 + (length[0] | (uint64_t) length[1] << 8) :
+                  12 + (length[0] | (uint64_t) length[1] << 8
+                      | (uint64_t) length[2] << 16
+                      | (uint64_t) length[3] << 24);
+    }
+    if (headerEnd == 0 || headerEnd > fileSize) {
+      throwNpyError("The file is not a numpy array");
+    }
+    header.assign(file, headerEnd);
+
+    // Pixel format: byte order, kind and size, as '<u2'
+    std::string descr = getNpyValue(header, "descr");
+    if (descr.size() < 4 || descr.front() != '\'') {
+      throwNpyError("The data type can not be read");
+    }
+    char byteOrder = descr[1], kind = descr[2];
+    this->_bitsPerSample = (short) (8 * std::atoi(descr.c_str() + 3));
+    uint16_t one = 1;
+    bool littleEndian = *(const uint8_t *) &one == 1;
+    if (this->_bitsPerSample > 8
+        && ((byteOrder == '<' && !littleEndian)
+            || (byteOrder == '>' && littleEndian))) {
+      throwNpyError("The byte order is not the machine byte order");
+    }
+    switch (kind) {
+      case 'u':
+      case 'b':this->_sampleFormat = 1;
+        break;
+      case 'i':this->_sampleFormat = 2;
+        break;
+      case 'f':this->_sampleFormat = 3;
+        if (this->_bitsPerSample != 32 && this->_bitsPerSample != 64) {
+          throwNpyError("The data type " + descr + " is not supported");
+        }
+        break;
+      default:throwNpyError("The data type " + descr + " is not supported");
+    }
+
+    if (getNpyValue(header, "fortran_order").compare(0, 4, "True") == 0) {
+      throwNpyError("The array is in fortran order");
+    }
+
+    // Shape, as (512, 1024) or (16, 512, 1024) for a volume
+    std::string shapeValue = getNpyValue(header, "shape");
+    for (size_t pos = shapeValue.find_first_of("0123456789");
+         pos < shapeValue.find(')');
+         pos = shapeValue.find_first_of("0123456789",
+                                        shapeValue.find(',', pos))) {
+      shape.push_back(std::strtoull(shapeValue.c_str() + pos, nullptr, 10));
+    }
+    if (shape.size() < 2 || shape.size() > 3) {
+      throwNpyError("The array is not an image or a volume");
+    }
+    if (shape.size() == 2) { shape.insert(shape.begin(), 1); }
+    if (plane >= shape[0]) {
+      throwNpyError("The plane " + std::to_string(plane)
+                        + " is outside of the volume");
+    }
+    this->_imageHeight = (uint32_t) shape[1];
+    this->_imageWidth = (uint32_t) shape[2];
+    _dataOffset =
+        headerEnd + (uint64_t) plane * this->_imageHeight * getRowStride();
+  }
+
+  /// \brief Private function. Get a value of the numpy header dictionary
+  /// \param header Numpy header
+  /// \param key Dictionary key
+  /// \return Value following the key, up to the end of the header
+  static std::string getNpyValue(const std::string &header,
+                                 const std::string &key) {
+    size_t pos = header.find("'" + key + "'");
+    if (pos == std::string::npos) { return ""; }
+    pos = header.find_first_not_of(" :", pos + key.size() + 2);
+    return pos == std::string::npos ? "" : header.substr(pos);
+  }
+
+  /// \brief Private function. Throw an exception for a numpy file not
+  /// supported
+  /// \param reason Reason of the error
+  [[noreturn]] void throwNpyError(const std::string &reason) const {
+    std::stringstream message;
+    message << "Tile Loader ERROR: " << reason << " ("
+            << this->getFilePath() << ").";
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  uint64_t
+      _dataOffset = 0;            ///< Offset of the first pixel in the file
+};
+}
+#endif //FASTIMAGE_MMAPRAWTILELOADER_H
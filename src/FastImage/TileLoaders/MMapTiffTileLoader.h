@@ -0,0 +1,195 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file MMapTiffTileLoader.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Implements the memory mapped tiff tile loader class
+
+#ifndef FASTIMAGE_MMAPTIFFTILELOADER_H
+#define FASTIMAGE_MMAPTIFFTILELOADER_H
+
+////Handle type incompatibility between libtiff and openCV in MACOS
+#ifdef __APPLE__
+#define uint64 uint64_hack_
+#define int64 int64_hack_
+#include <tiffio.h>
+#undef uint64
+#undef int64
+#else
+#include <tiffio.h>
+#endif
+
+#include <vector>
+#include "FastImage/TileLoaders/AMMapTileLoader.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+   * @class MMapTiffTileLoader MMapTiffTileLoader.h <FastImage/TileLoaders/MMapTiffTileLoader.h>
+   *
+   * @brief Tile loader specialized in uncompressed grayscale tiled tiff file,
+   * served from a memory mapping.
+   *
+   * @details The tiff header is parsed once with libtiff to get the tiles
+   * offsets (TIFFTAG_TILEOFFSETS) and sizes (TIFFTAG_TILEBYTECOUNTS), then
+   * the file is closed and the tiles are served from the mapped file (see
+   * fi::AMMapTileLoader), without going through libtiff. Compressed files
+   * have to be loaded with fi::GrayscaleTiffTileLoader.
+   *
+   * @tparam UserType Pixel Type asked by the end user
+   */
+template<typename UserType>
+class MMapTiffTileLoader : public AMMapTileLoader<UserType> {
+ public:
+  /// \brief MMapTiffTileLoader constructor
+  /// \details Parse the file header with libtiff, test if the file is tiled,
+  /// grayscale, uncompressed and in the machine byte order, and map it.
+  /// \param fileName File path
+  /// \param numThreads Number of threads used by the tile loader
+  explicit MMapTiffTileLoader(const std::string &fileName,
+                              size_t numThreads = 1)
+      : AMMapTileLoader<UserType>(fileName, numThreads) {
+    short
+        samplesPerPixel = 0,
+        compression = 0;
+    toff_t
+        *tileOffsets = nullptr,
+        *tileByteCounts = nullptr;
+    std::stringstream message;
+
+    TIFF *tiff = TIFFOpen(fileName.c_str(), "r");
+    if (tiff == nullptr) {
+      message << "Tile Loader ERROR: The image can not be opened.";
+    } else if (TIFFIsTiled(tiff) == 0) {
+      message << "Tile Loader ERROR: The image is not tiled.";
+    } else {
+      // Load/parse header
+      TIFFGetField(tiff, TIFFTAG_IMAGEWIDTH, &(this->_imageWidth));
+      TIFFGetField(tiff, TIFFTAG_IMAGELENGTH, &(this->_imageHeight));
+      TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &(this->_tileWidth));
+      TIFFGetField(tiff, TIFFTAG_TILELENGTH, &(this->_tileHeight));
+      TIFFGetField(tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+      TIFFGetField(tiff, TIFFTAG_BITSPERSAMPLE, &(this->_bitsPerSample));
+      TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLEFORMAT, &(this->_sampleFormat));
+      TIFFGetFieldDefaulted(tiff, TIFFTAG_COMPRESSION, &compression);
+      TIFFGetField(tiff, TIFFTAG_TILEOFFSETS, &tileOffsets);
+      TIFFGetField(tiff, TIFFTAG_TILEBYTECOUNTS, &tileByteCounts);
+
+      if (samplesPerPixel != 1) {
+        message << "Tile Loader ERROR: The image is not greyscale: "
+                   "SamplesPerPixel = " << samplesPerPixel << ".";
+      } else if (compression != COMPRESSION_NONE) {
+        message << "Tile Loader ERROR: The image is compressed (compression = "
+                << compression << "), it can not be memory mapped.";
+      } else if (TIFFIsByteSwapped(tiff) != 0 && this->_bitsPerSample > 8) {
+        message << "Tile Loader ERROR: The image byte order is not the "
+                   "machine byte order.";
+      } else if (tileOffsets == nullptr || tileByteCounts == nullptr) {
+        message << "Tile Loader ERROR: The tile offsets can not be read.";
+      } else {
+        _numberTilesWidth =
+            (this->_imageWidth + this->_tileWidth - 1) / this->_tileWidth;
+        _tileOffsets.assign(tileOffsets, tileOffsets + TIFFNumberOfTiles(tiff));
+        _tileByteCounts.assign(tileByteCounts,
+                               tileByteCounts + TIFFNumberOfTiles(tiff));
+      }
+    }
+    if (tiff != nullptr) { TIFFClose(tiff); }
+    if (!message.str().empty()) {
+      std::string m = message.str();
+      throw (FastImageException(m));
+    }
+
+    // Check the pixel format, and every tile stored is inside of the file
+    this->checkRegion(0, 0);
+    for (size_t tile = 0; tile < _tileOffsets.size(); ++tile) {
+      if (_tileByteCounts[tile] != 0) {
+        this->checkRegion(_tileOffsets[tile], getTileSize());
+      }
+    }
+  }
+
+  /// \brief Get the address of the first pixel of a tile in the mapped file
+  /// \param indexRowGlobalTile Row index tile asked
+  /// \param indexColGlobalTile Column Index tile asked
+  /// \return Address of the tile first pixel, nullptr for a sparse tile
+  const uint8_t *getTileAddress(uint32_t indexRowGlobalTile,
+                                uint32_t indexColGlobalTile) const override {
+    size_t tile = (size_t) indexRowGlobalTile * _numberTilesWidth
+        + indexColGlobalTile;
+    if (_tileByteCounts[tile] == 0) { return nullptr; }
+    return this->_file->getData() + _tileOffsets[tile];
+  }
+
+  /// \brief Get the distance between two rows of a tile, the tiles are
+  /// stored contiguously
+  /// \return Tile width in bytes
+  size_t getRowStride() const override {
+    return (size_t) this->_tileWidth * this->_bitsPerSample / 8;
+  }
+
+  /// \brief Copy function used by HTGS to use multiple Tile Loader, the
+  /// mapping is shared
+  /// \return  A new ATileLoader copied
+  ATileLoader<UserType> *copyTileLoader() override {
+    return new MMapTiffTileLoader<UserType>(this->getNumThreads(), *this);
+  }
+
+  /// \brief Get the name of the tile loader
+  /// \return Name of the tile loader
+  std::string getName() override { return "MMap TIFF Tile Loader"; }
+
+ private:
+  /// \brief MMapTiffTileLoader constructor used by the copy operator
+  /// \param numThreads Number of threads used by the tile loader
+  /// \param from Origin MMapTiffTileLoader
+  MMapTiffTileLoader(size_t numThreads, const MMapTiffTileLoader &from)
+      : AMMapTileLoader<UserType>(numThreads, from),
+        _tileOffsets(from._tileOffsets),
+        _tileByteCounts(from._tileByteCounts),
+        _numberTilesWidth(from._numberTilesWidth) {}
+
+  /// \brief Private function. Get the size of a tile in the file
+  /// \return Tile size in bytes
+  uint64_t getTileSize() const {
+    return (uint64_t) this->_tileHeight * getRowStride();
+  }
+
+  std::vector<uint64_t>
+      _tileOffsets{},             ///< Offset of each tile in the file
+      _tileByteCounts{};          ///< Size of each tile in the file, 0 if
+                                  ///< the tile is not stored
+
+  uint32_t
+      _numberTilesWidth = 0;      ///< Number of tiles in a row
+};
+}
+#endif //FASTIMAGE_MMAPTIFFTILELOADER_H
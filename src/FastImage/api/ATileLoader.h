@@ -36,10 +36,15 @@
 
 #include <htgs/api/ITask.hpp>
 #include <algorithm>
+#include <chrono>
 #include <utility>
 #include <cstring>
+#include <sstream>
 #include "FastImage/data/TileRequestData.h"
+#include "FastImage/exception/FastImageException.h"
 #include "FastImage/data/DataType.h"
+#include "FastImage/object/CacheBudget.h"
+#include "FastImage/object/NumaTopology.h"
 
 namespace fi {
 /// \namespace fi FastImage namespace
@@ -67,6 +72,21 @@ namespace fi {
 /// The overloaded copy function should also copy the following:
 /// _cache / _filePath / _bitsPerSample / numThreads, which can be taken from
 /// the available getters.
+/// To split the tile reading and the tile decoding into two graph stages
+/// (see fi::RawTileReader), the tile loader has to override:
+/// \code
+///     virtual bool hasRawTileReader() const;
+///     virtual double readRawTile(uint32_t indexRowGlobalTile,
+///         uint32_t indexColGlobalTile, std::vector<uint8_t> &rawTile);
+///     virtual void decodeTile(UserType *tile, uint32_t indexRowGlobalTile,
+///         uint32_t indexColGlobalTile, std::vector<uint8_t> &rawTile);
+/// \endcode
+/// To read the raw tiles asynchronously, in batches, the tile loader has to
+/// give the raw tiles location in the file by overriding:
+/// \code
+///     virtual bool getRawTileLocation(uint32_t indexRowGlobalTile,
+///         uint32_t indexColGlobalTile, uint64_t &offset, uint64_t &length);
+/// \endcode
 /// \tparam UserType Data Type wanted by the user,
 /// which is stored within a fi::View
 template<typename UserType>
@@ -90,39 +110,122 @@ class ATileLoader : public htgs::ITask<fi::TileRequestData<UserType>,
 
   // Function needed by HTGS
   /// \brief Initialize function
-  /// \details Associate a cache from the pool to a specific tile loader
+  /// \details Associate a cache from the pool to a specific tile loader. In
+  /// NUMA mode, pin the tile loader thread on its node.
   void initialize() final {
     _cache = _allCache[this->getPipelineId()];
+    if (_numaNode >= 0) {
+      NumaTopology::getInstance().pinThread((uint32_t) _numaNode);
+    }
   };
 
   /// \brief Load a tile from a file, populate the current view, and send the
   /// view to the view counter.
-  /// \details Processes the requested tile by first checking the cache,
-  /// if it is not in the cache, then the
-  /// tile is loaded from the disk. The data is copied into a fi::View and sent
-  /// to the view counter.
+  /// \details Processes the requested tile by first checking the cache, if
+  /// it is not in the cache, then the tile is loaded from the cache tier if
+  /// any, or from the disk. The views sharing a tile already loaded copy it
+  /// at the same time, without lock. The data is copied into a fi::View and
+  /// sent to the view counter. A prefetch request only loads the tile in the
+  /// cache. If the raw tile has already been read by a fi::RawTileReader,
+  /// it is only decoded. With the zero-copy views, a view covering the whole
+  /// tile references the pinned tile instead of copying it. The tile request
+  /// completing the view fills its ghost region and is the only one sent to
+  /// the view counter.
   /// \param tileRequestData the requested tile to load
   void executeTask
       (std::shared_ptr<fi::TileRequestData<UserType>> tileRequestData) final {
-    CachedTile<UserType> *cachedTile;
     uint32_t row = tileRequestData->getIndexRowTileAsked();
     uint32_t col = tileRequestData->getIndexColTileAsked();
+    CachedTile<UserType> *cachedTile =
+        getReadyTile(_cache, row, col, tileRequestData);
+    tileRequestData->releaseRawTile();
 
-    // Get locked tile from the cache, can be empty or not
-    cachedTile = _cache->getLockedTile(row, col);
+    // The prefetched tile is in the cache, no view to fill
+    if (tileRequestData->isPrefetch()) {
+      cachedTile->release();
+      return;
+    }
 
-    // Set the tile if empty
-    if (cachedTile->isNewTile()) {
-      cachedTile->setNewTile(false);
-      _cache->addTimeDisk(loadTileFromFile(cachedTile->getData(), row, col));
+    View<UserType> *view = tileRequestData->getViewData()->get();
+    if (_zeroCopyViews && coversView(tileRequestData)) {
+      // Reference the tile in the view, released with the view
+      view->referenceTile(cachedTile);
+    } else {
+      // Copy the tile or part of it into the view, the tile is only read
+      auto begin = std::chrono::high_resolution_clock::now();
+      copyTileToView(tileRequestData, cachedTile);
+      auto end = std::chrono::high_resolution_clock::now();
+      cachedTile->release();
+      _cache->recordLatency(
+          LatencyType::COPY,
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              end - begin).count());
     }
 
-    // Copy the tile or part of it into the view
-    copyTileToView(tileRequestData, cachedTile);
-    cachedTile->unlock();
+    // The loader of the view's last tile fills the ghost region and sends
+    // the view
+    if (view->tileLoaded()) {
+      view->fillGhostRegion(_fillingType);
+      this->addResult(tileRequestData);
+    }
+  }
+
+  /// \brief Get a pinned tile from a cache, loaded if needed
+  /// \details The tile is loaded from the cache tier if one holds it, else
+  /// from the file, or decoded if the raw tile is attached to the tile
+  /// request. If an other thread is loading the tile, wait for it to be
+  /// ready. The tile has to be released once used. If the loading throws,
+  /// the tile is set back to EMPTY and released before the exception is
+  /// propagated, the threads waiting for it claiming the loading.
+  /// \param cache Cache of the tile's pyramid level
+  /// \param row Tile row index
+  /// \param col Tile column index
+  /// \param tileRequestData Tile request, nullptr if the tile is not asked by
+  /// the graph
+  /// \return Pinned tile, ready to be read
+  CachedTile<UserType> *getReadyTile(
+      FigCache<UserType> *cache, uint32_t row, uint32_t col,
+      const std::shared_ptr<fi::TileRequestData<UserType>> &tileRequestData
+      = nullptr) {
+    // Get pinned tile from the cache, can be empty or not
+    CachedTile<UserType> *cachedTile = cache->getPinnedTile(
+        row, col, tileRequestData != nullptr ?
+                  tileRequestData->getAccessPosition() :
+                  std::numeric_limits<uint64_t>::max());
+    if (_cacheBudget != nullptr) { _cacheBudget->tileAccessed(); }
 
-    htgs::m_data_t<View<UserType>> viewData = tileRequestData->getViewData();
-    this->addResult(tileRequestData);
+    // Load the tile if empty, from a cache tier if one holds it, else wait
+    // for it to be ready
+    bool waited;
+    if (cachedTile->beginLoading(waited)) {
+      LoadingGuard loadingGuard(cachedTile);
+      if (!cache->loadFromTier(row, col, cachedTile->getData())) {
+        bool hasRawTile =
+            tileRequestData != nullptr && tileRequestData->hasRawTile();
+        auto begin = std::chrono::high_resolution_clock::now();
+        double timeDisk;
+        if (hasRawTile) {
+          timeDisk = tileRequestData->getRawTileReadDuration();
+          decodeTile(cachedTile->getData(), row, col,
+                     tileRequestData->getRawTile());
+        } else {
+          timeDisk = loadTileFromFile(cachedTile->getData(), row, col);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double timeLoad = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end - begin).count();
+
+        // The decoding time is the loading time outside of the disk read
+        cache->addTimeDisk(timeDisk);
+        cache->recordLatency(
+            LatencyType::DECODE,
+            hasRawTile ? timeLoad : std::max(timeLoad - timeDisk, 0.));
+        cache->tileLoaded(row, col, cachedTile->getData());
+      }
+      loadingGuard.loaded = true;
+      cachedTile->setReady();
+    } else if (waited) { cache->recordInFlightWait(); }
+    return cachedTile;
   }
 
   /// \brief Copy (part of or all) the cached tile to the view
@@ -153,18 +256,72 @@ class ATileLoader : public htgs::ITask<fi::TileRequestData<UserType>,
     }
   }
 
+  /// \brief Test if the view is exactly the tile, so it can reference the
+  /// cached tile
+  /// \details The view has no radius and the whole tile is in the image, so
+  /// there is no ghost region to fill.
+  /// \param tileRequestData Tile request
+  /// \return True if the view pixels are the tile pixels, else False
+  static bool coversView(
+      const std::shared_ptr<fi::TileRequestData<UserType>> &tileRequestData) {
+    return tileRequestData->getViewRequest()->getRadius() == 0
+        && tileRequestData->getHeightToCopy()
+            == tileRequestData->getTileHeight()
+        && tileRequestData->getWidthToCopy() == tileRequestData->getTileWidth()
+        && tileRequestData->getViewHeight() == tileRequestData->getTileHeight()
+        && tileRequestData->getViewWidth() == tileRequestData->getTileWidth();
+  }
+
   /// \brief Set the caches
   /// \param allCache Caches to set
   void setCache(std::vector<fi::FigCache<UserType> *> &allCache) {
     _allCache = allCache;
   }
 
+  /// \brief Set the memory budget shared by the caches, rebalanced while the
+  /// tiles are accessed
+  /// \param cacheBudget Memory budget shared by the caches, nullptr if the
+  /// caches have a fixed number of tiles
+  void setCacheBudget(std::shared_ptr<CacheBudget<UserType>> cacheBudget) {
+    _cacheBudget = std::move(cacheBudget);
+  }
+
+  /// \brief Set the NUMA node the tile loader threads are pinned on
+  /// \param numaNode NUMA node, -1 for no pinning
+  void setNumaNode(int32_t numaNode) { _numaNode = numaNode; }
+
+  /// \brief Get the NUMA node the tile loader threads are pinned on
+  /// \return NUMA node, -1 if not pinned
+  int32_t getNumaNode() const { return _numaNode; }
+
+  /// \brief Set the filling of the views' ghost region
+  /// \param fillingType Filling used to complete the ghost region
+  void setFillingType(FillingType fillingType) { _fillingType = fillingType; }
+
+  /// \brief Get the filling of the views' ghost region
+  /// \return Filling used to complete the ghost region
+  FillingType getFillingType() const { return _fillingType; }
+
+  /// \brief Set if the views covering a whole tile reference the pinned
+  /// cached tile instead of copying it
+  /// \param zeroCopyViews True to reference the cached tiles in the views
+  void setZeroCopyViews(bool zeroCopyViews) { _zeroCopyViews = zeroCopyViews; }
+
+  /// \brief Test if the views covering a whole tile reference the pinned
+  /// cached tile instead of copying it
+  /// \return True if the cached tiles are referenced in the views
+  bool isZeroCopyViews() const { return _zeroCopyViews; }
+
   /// \brief ATileLoader copy function used by HTGS to create a new ATileLoader,
   /// will call copyTileLoader more specialize
   /// \return ATileLoader copied
   ATileLoader *copy() final {
     auto tileLoader = copyTileLoader();
     tileLoader->setCache(this->_allCache);
+    tileLoader->setCacheBudget(this->_cacheBudget);
+    tileLoader->setNumaNode(this->_numaNode);
+    tileLoader->setZeroCopyViews(this->_zeroCopyViews);
+    tileLoader->setFillingType(this->_fillingType);
     return tileLoader;
   }
 
@@ -173,6 +330,14 @@ class ATileLoader : public htgs::ITask<fi::TileRequestData<UserType>,
   /// \return Task name
   std::string getName() override = 0;
 
+  /// \brief Get the identity of the decoding, the loader type and the
+  /// settings changing the decoded pixels
+  /// \details Part of the identity of the tiles kept by the persistent cache
+  /// tiers, so the tiles decoded differently are not shared. A tile loader
+  /// with settings changing the pixels (normalization) adds them.
+  /// \return Identity of the decoding
+  virtual std::string getDecodeIdentity() { return getName(); }
+
   /// \brief Copy Function
   /// \return ATileLoader copied
   virtual ATileLoader *copyTileLoader() = 0;
@@ -218,16 +383,109 @@ class ATileLoader : public htgs::ITask<fi::TileRequestData<UserType>,
                                   uint32_t indexRowGlobalTile,
                                   uint32_t indexColGlobalTile) = 0;
 
+  /// \brief Set the traversal used to traverse the image, called before the
+  /// tile loader is copied
+  /// \details Hint for the tile loaders reading ahead in the file, does
+  /// nothing by default
+  /// \param traversalType Traversal used to traverse the image
+  virtual void setTraversalType(TraversalType traversalType) {}
+
+  /// \brief Test if the tile loader can read the raw tiles and decode them
+  /// separately
+  /// \return True if readRawTile and decodeTile are implemented, else False
+  virtual bool hasRawTileReader() const { return false; }
+
+  /// \brief Read a specific raw (not decoded) tile from the file
+  /// \param indexRowGlobalTile Tile row index
+  /// \param indexColGlobalTile Tile col index
+  /// \param rawTile Buffer to fill with the raw tile, resized if needed
+  /// \return Duration in nS to read the raw tile from the disk, use for
+  /// statistics purpose
+  virtual double readRawTile(uint32_t indexRowGlobalTile,
+                             uint32_t indexColGlobalTile,
+                             std::vector<uint8_t> &rawTile) {
+    std::stringstream message;
+    message << "Tile Loader ERROR: " << getName()
+            << " can not read raw tiles.";
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  /// \brief Get the location of a raw tile in the file, to read it
+  /// asynchronously without the tile loader
+  /// \param indexRowGlobalTile Tile row index
+  /// \param indexColGlobalTile Tile col index
+  /// \param offset Raw tile offset in the file in bytes
+  /// \param length Raw tile length in bytes, 0 if the tile is not stored
+  /// \return True if the location is known, else False (the raw tile is read
+  /// with readRawTile)
+  virtual bool getRawTileLocation(uint32_t indexRowGlobalTile,
+                                  uint32_t indexColGlobalTile,
+                                  uint64_t &offset,
+                                  uint64_t &length) {
+    return false;
+  }
+
+  /// \brief Decode a raw tile read with readRawTile into a tile
+  /// \param tile Tile to decode into
+  /// \param indexRowGlobalTile Tile row index
+  /// \param indexColGlobalTile Tile col index
+  /// \param rawTile Raw tile
+  virtual void decodeTile(UserType *tile,
+                          uint32_t indexRowGlobalTile,
+                          uint32_t indexColGlobalTile,
+                          std::vector<uint8_t> &rawTile) {
+    std::stringstream message;
+    message << "Tile Loader ERROR: " << getName()
+            << " can not decode raw tiles.";
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
  protected:
   std::string
       _filePath;          ///< Path to file to load
 
  private:
+  /// \brief Abort the loading of a tile, if not loaded when going out of
+  /// scope, the tile being set back to EMPTY and released
+  struct LoadingGuard {
+    /// \brief LoadingGuard constructor
+    /// \param tile Tile being loaded
+    explicit LoadingGuard(CachedTile<UserType> *tile) : tile(tile) {}
+
+    /// \brief LoadingGuard destructor, abort the loading if not loaded
+    ~LoadingGuard() {
+      if (!loaded) {
+        tile->abortLoading();
+        tile->release();
+      }
+    }
+
+    CachedTile<UserType> *
+        tile;             ///< Tile being loaded
+    bool
+        loaded = false;   ///< True once the tile is loaded
+  };
+
   std::vector<fi::FigCache<UserType> *>
       _allCache;          ///< All caches for each pyramid levels
 
   FigCache<UserType> *
       _cache = nullptr;   ///< Tile Cache
+
+  std::shared_ptr<CacheBudget<UserType>>
+      _cacheBudget;       ///< Memory budget shared by the caches
+
+  int32_t
+      _numaNode = -1;     ///< NUMA node the threads are pinned on
+
+  bool
+      _zeroCopyViews = false; ///< True if the views covering a tile reference
+                              ///< the cached tile
+
+  FillingType
+      _fillingType = FillingType::FILL; ///< Filling of the ghost region
 };
 }
 #endif //FASTIMAGE_TILELOADER_H
@@ -39,19 +39,31 @@
 #include <cstdint>
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <mutex>
 
 #include <htgs/api/TaskGraphConf.hpp>
 #include <htgs/api/TaskGraphRuntime.hpp>
 #include <htgs/api/ExecutionPipeline.hpp>
 #include <htgs/api/TGTask.hpp>
+#include <htgs/api/Bookkeeper.hpp>
 
 #include "ATileLoader.h"
+#include "RegionView.h"
 #include "FastImage/tasks/ViewLoader.h"
+#include "FastImage/tasks/RawTileReader.h"
 #include "FastImage/tasks/ViewCounter.h"
 #include "../memory/ViewAllocator.h"
 #include "../memory/VariableMemoryManager.h"
+#include "../memory/RequestPool.h"
 #include "../rules/DistributePyramidRule.h"
+#include "../rules/NumaNodeRule.h"
 #include "../object/FigCache.h"
+#include "../object/CacheRegistry.h"
+#include "../object/CacheSimulator.h"
+#include "../object/tier/CompactMemoryTier.h"
+#include "../object/tier/SharedMemoryTier.h"
+#include "../object/tier/DiskSpillTier.h"
 #include "../object/Traversal.h"
 #include "../FeatureCollection/Feature.h"
 #include "../exception/FastImageException.h"
@@ -81,10 +93,25 @@ namespace fi {
  *
  * @code
  * fi->getFastImageOptions()->setPreserveOrder(preserveOrder);
+ * fi->getFastImageOptions()->setReorderWindow(reorderWindow);
  * fi->getFastImageOptions()->setFinishRequestingViews(finishRequestingViews);
  * fi->getFastImageOptions()->setNumberOfViewParallel(numberOfViewParallel);
  * fi->getFastImageOptions()->setNumberOfTilesToCache(numberOfTilesToCache);
+ * fi->getFastImageOptions()->setTargetCacheHitRate(targetCacheHitRate);
+ * fi->getFastImageOptions()->setCacheMemoryBudget(cacheMemoryBudget);
+ * fi->getFastImageOptions()->setCompactTierMemory(compactTierMemory);
+ * fi->getFastImageOptions()->setSharedTierMemory(sharedTierMemory);
+ * fi->getFastImageOptions()->setSpillDirectory(spillDirectory);
+ * fi->getFastImageOptions()->setShareCache(shareCache);
+ * fi->getFastImageOptions()->setUseHugePages(useHugePages);
+ * fi->getFastImageOptions()->setNumaAware(numaAware);
+ * fi->getFastImageOptions()->setZeroCopyViews(zeroCopyViews);
  * fi->getFastImageOptions()->setNumberOfTileLoader(numberOfTileLoader);
+ * fi->getFastImageOptions()->setNumberOfCacheShards(numberOfCacheShards);
+ * fi->getFastImageOptions()->setEvictionPolicy(evictionPolicy);
+ * fi->getFastImageOptions()->setPrefetchDepth(prefetchDepth);
+ * fi->getFastImageOptions()->setNumberOfRawTileReader(numberOfRawTileReader);
+ * fi->getFastImageOptions()->setAsyncReadQueueDepth(asyncReadQueueDepth);
  * fi->getFastImageOptions()->setTraversalType(traversalType);
  * fi->getFastImageOptions()->setFillingType(fillingType);
  * fi->getFastImageOptions()->setNbReleasePyramid(pyramidLvl, nbRelease);
@@ -107,6 +134,13 @@ namespace fi {
  * NOTE: The boolean parameter indicate to the system that no more views will be
  * requested.
  *
+ * A region of interest of any position and size is assembled directly from
+ * the cached tiles, and returned without going through the views:
+ *
+ * @code
+ * auto region = fi->requestRegion(level, row, col, height, width);
+ * @endcode
+ *
  * Once the views are requested they can be acquired and can be used:
  *
  * @code
@@ -153,9 +187,25 @@ class FastImage {
     /// @code
     ///  finishRequestingViews = false;
     ///  preserveOrder = false;
+    ///  reorderWindow = 0;
     ///  numberOfViewParallel = 1;
     ///  numberOfTilesToCache = 0;
+    ///  targetCacheHitRate = 0;
+    ///  cacheMemoryBudget = 0;
+    ///  compactTierMemory = 0;
+    ///  sharedTierMemory = 0;
+    ///  spillDirectory = "";
+    ///  spillLimit = 0;
+    ///  shareCache = false;
+    ///  useHugePages = false;
+    ///  numaAware = false;
+    ///  zeroCopyViews = false;
     ///  numberOfTileLoader = 1;
+    ///  numberOfCacheShards = 1;
+    ///  evictionPolicy = EvictionPolicyType::LRU;
+    ///  prefetchDepth = 0;
+    ///  numberOfRawTileReader = 0;
+    ///  asyncReadQueueDepth = 0;
     ///  traversalType = TraversalType::SNAKE;
     ///  fillingType = FillingType::FILL;
     ///  nbReleasePyramid = 1; // 1 for each level
@@ -174,6 +224,10 @@ class FastImage {
     /// \return
     bool isOrderPreserved() const { return _preserveOrder; }
 
+    /// \brief Get the number of views held to restore the requested order
+    /// \return Reorder window, 0 for the number of views in parallel
+    uint32_t getReorderWindow() const { return _reorderWindow; }
+
     /// \brief Get number of view in parallel
     /// \return Number of view in parallel
     uint32_t getNumberOfViewParallel() const { return _numberOfViewParallel; }
@@ -182,10 +236,76 @@ class FastImage {
     /// \return Number of tiles to cache
     uint32_t getNumberOfTilesToCache() const { return _numberOfTilesToCache; }
 
+    /// \brief Get the cache hit rate the number of tiles to cache is sized for
+    /// \return Target cache hit rate, 0 if disabled
+    double getTargetCacheHitRate() const { return _targetCacheHitRate; }
+
+    /// \brief Get the memory budget in bytes shared by the caches
+    /// \return Memory budget shared by the caches, 0 if not set
+    uint64_t getCacheMemoryBudget() const { return _cacheMemoryBudget; }
+
+    /// \brief Get the memory in bytes of the compact cache tiers
+    /// \return Memory of the compact cache tiers, 0 if disabled
+    uint64_t getCompactTierMemory() const { return _compactTierMemory; }
+
+    /// \brief Get the memory in bytes of the shared memory cache tiers
+    /// \return Memory of the shared memory cache tiers, 0 if disabled
+    uint64_t getSharedTierMemory() const { return _sharedTierMemory; }
+
+    /// \brief Get the directory of the spill files
+    /// \return Directory of the spill files, empty if disabled
+    const std::string &getSpillDirectory() const { return _spillDirectory; }
+
+    /// \brief Get the maximum size in bytes of the spill files
+    /// \return Maximum size of the spill files, 0 if not limited
+    uint64_t getSpillLimit() const { return _spillLimit; }
+
+    /// \brief Get if the caches are shared with the other FastImage on the
+    /// same file
+    /// \return True if the caches are shared
+    bool isCacheShared() const { return _shareCache; }
+
+    /// \brief Get if the tiles and the views are backed by huge pages
+    /// \return True if the huge pages are used
+    bool isUsingHugePages() const { return _useHugePages; }
+
+    /// \brief Get if the tile loaders and the caches are partitioned per NUMA
+    /// node
+    /// \return True if in NUMA mode
+    bool isNumaAware() const { return _numaAware; }
+
+    /// \brief Get if the views reference the cached tiles instead of copying
+    /// them
+    /// \return True if the zero-copy views are enabled
+    bool isZeroCopyViews() const { return _zeroCopyViews; }
+
     /// \brief Get number of tiles loader
     /// \return number of tiles loader
     uint32_t getNumberOfTileLoader() const { return _numberOfTileLoader; }
 
+    /// \brief Get number of shards for each level's cache
+    /// \return Number of shards for each level's cache
+    uint32_t getNumberOfCacheShards() const { return _numberOfCacheShards; }
+
+    /// \brief Get the caches eviction policy
+    /// \return Caches eviction policy
+    EvictionPolicyType getEvictionPolicy() const { return _evictionPolicy; }
+
+    /// \brief Get the number of views prefetched ahead
+    /// \return Number of views prefetched ahead
+    uint32_t getPrefetchDepth() const { return _prefetchDepth; }
+
+    /// \brief Get the number of raw tile reader threads
+    /// \return Number of raw tile reader threads
+    uint32_t getNumberOfRawTileReader() const {
+      return _numberOfRawTileReader;
+    }
+
+    /// \brief Get the maximum number of asynchronous raw tile reads in flight
+    /// per raw tile reader thread
+    /// \return Asynchronous read queue depth
+    uint32_t getAsyncReadQueueDepth() const { return _asyncReadQueueDepth; }
+
     /// \brief Get traversal type
     /// \return Traversal type
     TraversalType getTraversalType() const { return _traversalType; }
@@ -212,6 +332,18 @@ class FastImage {
     /// \param preserveOrder true if the order has to be preserved, else false
     void setPreserveOrder(bool preserveOrder) { _preserveOrder = preserveOrder; }
 
+    /// \brief Set the number of views held to restore the requested order
+    /// \details The views are numbered per level when requested, and the
+    /// views completed ahead of the next one to send are held in a ring
+    /// buffer of this size, so each view is ordered in constant time. The
+    /// buffer grows if a view completes further ahead. 0 sets it to the
+    /// number of views in parallel, the most views that can be out of order.
+    /// \param reorderWindow Reorder window, 0 for the number of views in
+    /// parallel
+    void setReorderWindow(uint32_t reorderWindow) {
+      _reorderWindow = reorderWindow;
+    }
+
     /// \brief Set if has finish requesting views
     /// \param finishRequestingViews True if finish requesting views, False else
     void setFinishRequestingViews(bool finishRequestingViews) {
@@ -230,12 +362,198 @@ class FastImage {
       _numberOfTilesToCache = numberOfTilesToCache;
     }
 
+    /// \brief Set the cache hit rate the number of tiles to cache is sized for
+    /// \details If superior to 0, replaces the number of tiles to cache. Before
+    /// the graph starts, the traversal is replayed for each level with the
+    /// radius, the number of tile loader threads and the eviction policy
+    /// (fi::CacheSimulator), and the smallest cache reaching the hit rate is
+    /// picked. The whole level is cached if the hit rate can not be reached.
+    /// The memory budget, if set, still takes precedence.
+    /// \param targetCacheHitRate Target cache hit rate, between 0 and 1
+    void setTargetCacheHitRate(double targetCacheHitRate) {
+      _targetCacheHitRate = targetCacheHitRate;
+    }
+
+    /// \brief Set the memory budget in bytes shared by the caches of all the
+    /// pyramid levels
+    /// \details If superior to 0, replaces the number of tiles to cache. The
+    /// budget is divided between the levels following their size, and
+    /// rebalanced while the views are loaded toward the levels with the most
+    /// misses (fi::CacheBudget). Each level keeps at least one tile per
+    /// cache shard. 0 uses the number of tiles to cache for every level.
+    /// \param cacheMemoryBudget Memory budget shared by the caches in bytes
+    void setCacheMemoryBudget(uint64_t cacheMemoryBudget) {
+      _cacheMemoryBudget = cacheMemoryBudget;
+    }
+
+    /// \brief Set the memory in bytes of the compact cache tiers, keeping the
+    /// tiles recycled by the caches
+    /// \details If superior to 0, each level's cache gets a
+    /// fi::CompactMemoryTier. The tiles recycled are kept in a compact form,
+    /// packed on the bits needed by their pixels (e.g. 8 bits per pixel for a
+    /// float view of a 8 bits image), and expanded back instead of being
+    /// loaded from the file. The memory is divided between the levels
+    /// following their size. 0 disables the tiers.
+    /// \param compactTierMemory Memory of the compact cache tiers in bytes
+    void setCompactTierMemory(uint64_t compactTierMemory) {
+      _compactTierMemory = compactTierMemory;
+    }
+
+    /// \brief Set the memory in bytes of the shared memory cache tiers,
+    /// serving the tiles decoded by a process to the other processes of the
+    /// node
+    /// \details If superior to 0, each level's cache gets a
+    /// fi::SharedMemoryTier, after the compact tier if any. The tiles decoded
+    /// are written in a POSIX shared memory segment named after the image file
+    /// identity, the level and the decoding, and copied back by the processes
+    /// opening the same image with the same options instead of being loaded
+    /// from the file. The memory is divided between the levels following
+    /// their size, and taken from /dev/shm. The segments stay in /dev/shm
+    /// until FastImage::removeSharedTierSegments is called. 0 disables the
+    /// tiers.
+    /// \param sharedTierMemory Memory of the shared memory cache tiers in
+    /// bytes
+    void setSharedTierMemory(uint64_t sharedTierMemory) {
+      _sharedTierMemory = sharedTierMemory;
+    }
+
+    /// \brief Set the directory of the spill files, keeping the decoded tiles
+    /// on disk for the next passes and the next processes
+    /// \details If not empty, each level's cache gets a fi::DiskSpillTier,
+    /// after the memory tiers if any. The tiles decoded are written in a
+    /// sparse spill file named after the image file identity, the level and
+    /// the decoding, and copied back instead of being decoded again. The
+    /// directory has to exist, on a fast local drive, and can hold up to the
+    /// decoded image size or the spill limit. The tiles are not spilled once
+    /// the drive is full. Empty disables the spill files.
+    /// \param spillDirectory Directory of the spill files
+    void setSpillDirectory(const std::string &spillDirectory) {
+      _spillDirectory = spillDirectory;
+    }
+
+    /// \brief Set the maximum size in bytes of the spill files
+    /// \details The limit is split between the pyramid levels as their
+    /// pixels. 0 does not limit the spill files, up to the decoded image size.
+    /// \param spillLimit Maximum size of the spill files in bytes
+    void setSpillLimit(uint64_t spillLimit) { _spillLimit = spillLimit; }
+
+    /// \brief Set if the caches are shared with the other FastImage on the
+    /// same file
+    /// \details If true, the caches and their memory budget are taken from
+    /// the fi::CacheRegistry, keyed by the file path, the level, the tile
+    /// size, the decoding and the UserType: the tiles loaded by a FastImage
+    /// are found by the others opened on the same file with this option and
+    /// decoding the tiles the same way. The first FastImage configured
+    /// creates the caches with its options, the next ones use them as they
+    /// are, grown to their minimum number of tiles.
+    /// \param shareCache True to share the caches
+    void setShareCache(bool shareCache) { _shareCache = shareCache; }
+
+    /// \brief Set if the tiles and the views are backed by huge pages
+    /// \details The tiles of each cache shard and the views of each level are
+    /// allocated in a single region, aligned on 64 bytes (fi::TileArena). If
+    /// true, the regions are mapped with the huge pages reserved by the
+    /// system (MAP_HUGETLB), else advised for the transparent huge pages
+    /// (MADV_HUGEPAGE), cutting the TLB misses of large caches.
+    /// \param useHugePages True to use the huge pages
+    void setUseHugePages(bool useHugePages) { _useHugePages = useHugePages; }
+
+    /// \brief Set if the tile loaders and the caches are partitioned per NUMA
+    /// node
+    /// \details If true and the machine has several NUMA nodes
+    /// (fi::NumaTopology), the columns of tiles are split in a band per node.
+    /// Each node gets a copy of the tile loader, with its threads pinned on
+    /// the node's cpus, and its own cache shards, allocated on the node. The
+    /// tile requests are routed to the node owning the tile (fi::NumaNodeRule),
+    /// so the tiles are loaded, cached and copied to the views on the same
+    /// socket. The views are interleaved on the nodes. The number of tile
+    /// loader threads is then per node, and the number of cache shards
+    /// raised to at least one per node and rounded up to a multiple of the
+    /// number of nodes.
+    /// \param numaAware True to enable the NUMA mode
+    void setNumaAware(bool numaAware) { _numaAware = numaAware; }
+
+    /// \brief Set if the views reference the cached tiles instead of copying
+    /// them
+    /// \details Only used with a radius of 0. A view covering a whole tile
+    /// then references the cached tile (View::referenceTile), saving a tile
+    /// copy per view. The tile stays pinned in the cache until the view is
+    /// released, and the view pixels must only be read. The views of the
+    /// partial tiles on the image borders are still copied. Each cache shard
+    /// keeps at least one tile per view in parallel and per tile loader
+    /// thread, plus one for the regions (requestRegion).
+    /// \param zeroCopyViews True to enable the zero-copy views
+    void setZeroCopyViews(bool zeroCopyViews) {
+      _zeroCopyViews = zeroCopyViews;
+    }
+
     /// \brief Set number of tile loader
     /// \param numberOfTileLoader Number of tile loader
     void setNumberOfTileLoader(uint32_t numberOfTileLoader) {
       _numberOfTileLoader = numberOfTileLoader;
     }
 
+    /// \brief Set number of shards each level's cache is split into
+    /// \details Each shard has its own lock and LRU, so the cache accesses
+    /// scale with the number of tile loaders. A value around the number of
+    /// tile loaders is a good start. The number of tiles to cache is
+    /// distributed between the shards. 0 sets one shard per tile loader
+    /// thread.
+    /// \param numberOfCacheShards Number of shards per cache
+    void setNumberOfCacheShards(uint32_t numberOfCacheShards) {
+      _numberOfCacheShards = numberOfCacheShards;
+    }
+
+    /// \brief Set the eviction policy used by the caches
+    /// \details LRU is the default. CLOCK approximates LRU without moving
+    /// tiles on a hit. ARC resists to scans by keeping the tiles accessed
+    /// more than once. MIN uses the requested views to recycle the tile used
+    /// the farthest in the future; it is the best choice when all the views
+    /// are requested ahead, as with requestAllTiles.
+    /// \param evictionPolicy Caches eviction policy
+    void setEvictionPolicy(EvictionPolicyType evictionPolicy) {
+      _evictionPolicy = evictionPolicy;
+    }
+
+    /// \brief Set the number of views prefetched ahead of the views loaded
+    /// \details When the views are requested with requestAllTiles or
+    /// requestFeature, the tiles (halo included) of the views prefetchDepth
+    /// steps ahead in the traversal are loaded in the cache, so the disk reads
+    /// overlap with the views being loaded from the cache. The depth is
+    /// limited so the prefetched tiles and the tiles of the views in
+    /// progress fit in the cache. 0 disables the prefetching.
+    /// \param prefetchDepth Number of views prefetched ahead
+    void setPrefetchDepth(uint32_t prefetchDepth) {
+      _prefetchDepth = prefetchDepth;
+    }
+
+    /// \brief Set the number of threads reading the raw tiles
+    /// \details If superior to 0 and if the tile loader supports it
+    /// (ATileLoader::hasRawTileReader), the tile loading is split in two
+    /// stages: a fi::RawTileReader with numberOfRawTileReader threads reads
+    /// the raw tiles from the file, and the tile loader threads only decode
+    /// them. A few reader threads are enough for a local disk, the tile
+    /// loader threads can be set to the number of cores for compressed
+    /// images. 0 disables the split.
+    /// \param numberOfRawTileReader Number of raw tile reader threads
+    void setNumberOfRawTileReader(uint32_t numberOfRawTileReader) {
+      _numberOfRawTileReader = numberOfRawTileReader;
+    }
+
+    /// \brief Set the maximum number of asynchronous raw tile reads in flight
+    /// per raw tile reader thread
+    /// \details If superior to 0 and if the tile loader gives the raw tiles
+    /// location (ATileLoader::getRawTileLocation), the fi::RawTileReader
+    /// reads the raw tiles asynchronously in batches, with io_uring or a pool
+    /// of pread threads, instead of one blocking read per thread. A single
+    /// raw tile reader thread is then enough, it is created if
+    /// numberOfRawTileReader is 0. 32 to 128 reads in flight keep a NVMe
+    /// drive busy. 0 disables the asynchronous reads.
+    /// \param asyncReadQueueDepth Asynchronous read queue depth
+    void setAsyncReadQueueDepth(uint32_t asyncReadQueueDepth) {
+      _asyncReadQueueDepth = asyncReadQueueDepth;
+    }
+
     /// \brief Set traversal pattern to traverse the image
     /// \param traversalType Traversal pattern to traverse the image
     void setTraversalType(TraversalType traversalType) {
@@ -257,15 +575,57 @@ class FastImage {
    private:
     bool
         _finishRequestingViews = false,         ///< Is Finish sent
-        _preserveOrder = false;                 ///< True if output order is
+        _preserveOrder = false,                 ///< True if output order is
                                                 ///< the same as the requested
                                                 ///< order
+        _shareCache = false,                    ///< True if the caches are
+                                                ///< shared between FastImage
+        _useHugePages = false,                  ///< True if the tiles and
+                                                ///< views use huge pages
+        _numaAware = false,                     ///< True if partitioned per
+                                                ///< NUMA node
+        _zeroCopyViews = false;                 ///< True if the views
+                                                ///< reference the cached tiles
 
     uint32_t
         _numberOfViewParallel = 1,              ///< Number of views available
                                                 ///< in parallel
         _numberOfTilesToCache = 0,              ///< Number of tiles to cache
-        _numberOfTileLoader = 1;                ///< Number of tiles loader
+        _reorderWindow = 0,                     ///< Views held to restore
+                                                ///< the requested order
+        _numberOfTileLoader = 1,                ///< Number of tiles loader
+        _numberOfCacheShards = 1,               ///< Number of shards per
+                                                ///< cache
+        _prefetchDepth = 0,                     ///< Number of views
+                                                ///< prefetched ahead
+        _numberOfRawTileReader = 0,             ///< Number of raw tile
+                                                ///< reader threads
+        _asyncReadQueueDepth = 0;               ///< Asynchronous reads in
+                                                ///< flight per reader
+
+    uint64_t
+        _cacheMemoryBudget = 0,                 ///< Memory budget shared by
+                                                ///< the caches in bytes
+        _compactTierMemory = 0,                 ///< Memory of the compact
+                                                ///< cache tiers in bytes
+        _sharedTierMemory = 0;                  ///< Memory of the shared
+                                                ///< memory cache tiers in
+                                                ///< bytes
+
+    double
+        _targetCacheHitRate = 0;                ///< Cache hit rate the caches
+                                                ///< are sized for
+
+    std::string
+        _spillDirectory;                        ///< Directory of the spill
+                                                ///< files
+
+    uint64_t
+        _spillLimit = 0;                        ///< Maximum size of the spill
+                                                ///< files in bytes
+
+    EvictionPolicyType
+        _evictionPolicy = EvictionPolicyType::LRU; ///< Caches eviction policy
 
     TraversalType
         _traversalType = TraversalType::SNAKE;  ///< Traversal type
@@ -278,6 +638,9 @@ class FastImage {
                                                 ///< release a view per levels
   };
  public:
+  static constexpr size_t
+      regionPoolsMax = 8;             ///< Number of region sizes pooled
+
   /// \brief FastImage constructor
   /// \param tileLoader Image TileLoader
   /// \param radius Number of pixel around the central tile
@@ -315,11 +678,16 @@ class FastImage {
   ~FastImage() {
     waitForGraphComplete();
     delete _fastImageOptions;
-    // Delete the cache
-    for (auto &cache: _allCache) { delete cache; }
 
-    // Delete the graph
+    // Delete the graph, the views release the cached tiles they reference
     delete _runtime;
+    for (auto regionTileLoader : _regionTileLoaders) {
+      delete regionTileLoader;
+    }
+
+    // Release the caches, deleted if not shared with an other FastImage
+    _allCache.clear();
+    _cacheHandles.clear();
   }
 
   /// \brief Set up and run the graph.
@@ -464,6 +832,50 @@ class FastImage {
     return _allCache[level]->getHitMissCache();
   }
 
+  /// \brief Get a snapshot of the metrics of a level's cache and its tile
+  /// loaders, thread safe
+  /// \details The snapshot holds the hits, misses, evictions, reloads of
+  /// tiles cached before and waits for tiles being loaded by an other tile
+  /// loader, with the latency histograms of the cache lookups, the disk
+  /// reads, the decoding and the copies into the views. It can be taken
+  /// while the graph is running.
+  /// \param level Pyramid level
+  /// \return Snapshot of the level's cache metrics
+  CacheMetrics getCacheMetrics(uint32_t level = 0) {
+    CacheMetrics metrics = _allCache[level]->getMetrics();
+    metrics.level = level;
+    return metrics;
+  }
+
+  /// \brief Get the Hit and miss accesses of a cache tier
+  /// \param level Pyramid level
+  /// \param tier Tier index, in the order compact, shared memory then spill
+  /// tier
+  /// \return pair<hit, miss>, {0, 0} if the cache has no such tier
+  std::pair<uint64_t, uint64_t>
+  getHitMissCacheTier(uint32_t level = 0, size_t tier = 0) {
+    ACacheTier<UserType> *cacheTier = _allCache[level]->getTier(tier);
+    if (cacheTier == nullptr) { return {0, 0}; }
+    return {cacheTier->getHit(), cacheTier->getMiss()};
+  }
+
+  /// \brief Remove the shared memory segments of the levels' caches from
+  /// /dev/shm
+  /// \details The segments outlive the processes to serve the next ones. Once
+  /// removed, their memory is released when the last process using them
+  /// unmaps them, and the next processes opening the image create new
+  /// segments. To be called after FastImage::configureAndRun, by the last
+  /// process needing the image.
+  void removeSharedTierSegments() {
+    for (auto cache : _allCache) {
+      for (size_t tier = 0; tier < cache->getNbTiers(); ++tier) {
+        auto sharedTier =
+            dynamic_cast<SharedMemoryTier<UserType> *>(cache->getTier(tier));
+        if (sharedTier != nullptr) { sharedTier->removeSegment(); }
+      }
+    }
+  }
+
   /// \brief Get the image size in Bytes
   /// \param level Pyramid level
   /// \return The image size in Bytes
@@ -548,9 +960,6 @@ class FastImage {
       return;
     }
 
-    std::queue<std::pair<uint32_t, uint32_t>> fifo;
-    fifo.push(std::make_pair(rowIndex, colIndex));
-    _viewCounter->addTraversal(fifo);
     sendRequest(rowIndex, colIndex, level);
     if (finishRequestingTiles) {
       this->finishedRequestingTiles();
@@ -586,21 +995,13 @@ class FastImage {
     this->setNumberTilesFeatureTotal(
         (indexRowMax - indexRowMin) * (indexColMax - indexColMin));
 
-    std::queue<std::pair<uint32_t, uint32_t>> fifo;
-
+    std::vector<std::pair<uint32_t, uint32_t>> steps;
     for (auto indexRow = indexRowMin; indexRow < indexRowMax; ++indexRow) {
       for (auto indexCol = indexColMin; indexCol < indexColMax; ++indexCol) {
-        fifo.push(std::make_pair(indexRow, indexCol));
-      }
-    }
-
-    _viewCounter->addTraversal(fifo);
-
-    for (auto indexRow = indexRowMin; indexRow < indexRowMax; ++indexRow) {
-      for (auto indexCol = indexColMin; indexCol < indexColMax; ++indexCol) {
-        sendRequest(indexRow, indexCol, level);
+        steps.emplace_back(indexRow, indexCol);
       }
     }
+    sendRequests(steps, level);
   }
 
   /// \brief Request all tiles following a traversal
@@ -616,17 +1017,81 @@ class FastImage {
                                     getNumberTilesHeight(level),
                                     getNumberTilesWidth(level));
 
-    _viewCounter->addTraversal(traversal.getQueue());
-
-    for (auto step : traversal.getTraversal()) {
-      sendRequest(step.first, step.second, level);
-    }
+    sendRequests(traversal.getTraversal(), level);
 
     if (finishRequestingTiles) {
       this->finishedRequestingTiles();
     }
   }
 
+  /// \brief Request a region of interest of any position and size
+  /// \details The region is assembled on the calling thread from exactly the
+  /// parts of the cached tiles it overlaps, the missing tiles are loaded in
+  /// the cache by a copy of the tile loader bound to the level's pipeline.
+  /// The regions are requested one at a time, while the graph keeps producing
+  /// the views. The pixels of the first regionPoolsMax region sizes requested
+  /// are allocated from a pool of getNumberOfViewParallel() regions per size.
+  /// \param level Pyramid level
+  /// \param row Row of the region upper left pixel, in the level
+  /// \param col Column of the region upper left pixel, in the level
+  /// \param height Region height in px
+  /// \param width Region width in px
+  /// \return The region, with the image pixels
+  /// \throw FastImageException if the region is empty or not in the image
+  std::unique_ptr<RegionView<UserType>> requestRegion(uint32_t level,
+                                                      uint32_t row,
+                                                      uint32_t col,
+                                                      uint32_t height,
+                                                      uint32_t width) {
+    assert(_hasBeenConfigured);
+    if (height == 0 || width == 0
+        || level >= _tileLoader->getNbPyramidLevels()
+        || (uint64_t) row + height > getImageHeight(level)
+        || (uint64_t) col + width > getImageWidth(level)) {
+      std::stringstream message;
+      message << "FastImage ERROR: The region (" << row << ", " << col
+              << ") of " << height << "x" << width << " px is not in the "
+              << "image at the level " << level << ".";
+      std::string m = message.str();
+      throw (FastImageException(m));
+    }
+    uint32_t
+        tileHeight = getTileHeight(level),
+        tileWidth = getTileWidth(level);
+
+    std::lock_guard<std::mutex> lock(_regionMutex);
+    ATileLoader<UserType> *regionTileLoader = getRegionTileLoader(level);
+    std::unique_ptr<RegionView<UserType>> region(
+        new RegionView<UserType>(row, col, height, width, level,
+                                 getRegionArena(height, width)));
+
+    // Copy the part of each tile overlapped by the region
+    for (uint32_t r = row / tileHeight; r <= (row + height - 1) / tileHeight;
+         ++r) {
+      uint32_t
+          minRow = std::max(row, r * tileHeight),
+          maxRow = std::min(row + height, (r + 1) * tileHeight);
+      for (uint32_t c = col / tileWidth; c <= (col + width - 1) / tileWidth;
+           ++c) {
+        uint32_t
+            minCol = std::max(col, c * tileWidth),
+            maxCol = std::min(col + width, (c + 1) * tileWidth);
+        CachedTile<UserType> *tile =
+            regionTileLoader->getReadyTile(_allCache[level], r, c);
+        for (uint32_t pixelRow = minRow; pixelRow < maxRow; ++pixelRow) {
+          std::copy_n(
+              tile->getData() + ((size_t) (pixelRow - r * tileHeight)
+                  * tileWidth + (minCol - c * tileWidth)),
+              maxCol - minCol,
+              region->getData() + ((size_t) (pixelRow - row) * width
+                  + (minCol - col)));
+        }
+        tile->release();
+      }
+    }
+    return region;
+  }
+
   /// \brief Increment the number of tiles for a region already computed
   void incrementTileFeatureComputed() {
     std::mutex mtx;
@@ -649,6 +1114,153 @@ class FastImage {
     return _taskGraph;
   }
 
+  /// \brief Create and initialize the cache of a level, with its tiers
+  /// \param level Pyramid level
+  /// \return The new cache
+  FigCache<UserType> *createCache(uint32_t level) {
+    // Size the cache for the target hit rate from the simulated traversal
+    uint32_t nbTilesToCache = _fastImageOptions->getNumberOfTilesToCache();
+    if (_fastImageOptions->getTargetCacheHitRate() > 0) {
+      CacheSimulator simulator(
+          getImageHeight(level), getImageWidth(level),
+          getTileHeight(level), getTileWidth(level), getRadius(),
+          _fastImageOptions->getTraversalType(),
+          (uint32_t) _tileLoader->getNumThreads(),
+          _fastImageOptions->getEvictionPolicy(),
+          _fastImageOptions->getNumberOfCacheShards());
+      nbTilesToCache =
+          simulator.findCacheSize(_fastImageOptions->getTargetCacheHitRate());
+    }
+
+    if (isZeroCopy() && nbTilesToCache == 0) {
+      nbTilesToCache = 2 * getNumberTilesWidth(level);
+    }
+
+    std::unique_ptr<FigCache<UserType>> cache(
+        new FigCache<UserType>(
+            nbTilesToCache,
+            this->_fastImageOptions->getNumberOfCacheShards(),
+            this->_fastImageOptions->getEvictionPolicy()));
+    cache->setNumaNodes(getNbNumaNodes());
+    cache->initCache(this->getNumberTilesHeight(level),
+                     this->getNumberTilesWidth(level),
+                     this->getTileHeight(level),
+                     this->getTileWidth(level),
+                     this->_fastImageOptions->isUsingHugePages());
+
+    // The zero-copy views keep their tile pinned, keep tiles for the loaders
+    // in each shard, the NUMA mode possibly adding shards
+    if (isZeroCopy()) {
+      cache->setMinNbTilesCache(getMinNbTilesPerShard() * cache->getNbShards());
+      cache->resize(cache->getNbTilesCache());
+    }
+
+    // Add the compact and shared memory tiers, the memory divided following
+    // the levels size
+    double levelRatio = 0;
+    for (uint32_t l = 0; l < getNbPyramidLevels(); ++l) {
+      levelRatio += (double) getImageHeight(l) * getImageWidth(l);
+    }
+    levelRatio = (double) getImageHeight(level) * getImageWidth(level)
+        / levelRatio;
+    if (_fastImageOptions->getCompactTierMemory() > 0) {
+      cache->addTier(std::unique_ptr<ACacheTier<UserType>>(
+          new CompactMemoryTier<UserType>((uint64_t) (
+              (double) _fastImageOptions->getCompactTierMemory()
+                  * levelRatio))));
+    }
+    if (_fastImageOptions->getSharedTierMemory() > 0) {
+      cache->addTier(std::unique_ptr<ACacheTier<UserType>>(
+          new SharedMemoryTier<UserType>(
+              _tileLoader->getFilePath(), level,
+              getNumberTilesHeight(level), getNumberTilesWidth(level),
+              getTileHeight(level), getTileWidth(level),
+              (uint64_t) ((double) _fastImageOptions->getSharedTierMemory()
+                  * levelRatio),
+              _tileLoader->getDecodeIdentity())));
+    }
+
+    // Add the spill tier, after the memory tiers
+    if (!_fastImageOptions->getSpillDirectory().empty()) {
+      cache->addTier(std::unique_ptr<ACacheTier<UserType>>(
+          new DiskSpillTier<UserType>(
+              _fastImageOptions->getSpillDirectory(),
+              _tileLoader->getFilePath(), level,
+              getNumberTilesHeight(level), getNumberTilesWidth(level),
+              getTileHeight(level), getTileWidth(level),
+              (uint64_t) ((double) _fastImageOptions->getSpillLimit()
+                  * levelRatio),
+              _tileLoader->getDecodeIdentity())));
+    }
+    return cache.release();
+  }
+
+  /// \brief Get the minimum number of tiles of each cache shard
+  /// \details The zero-copy views keep their tile pinned, each shard needs a
+  /// tile per view in parallel, per tile loader thread, and for the tile
+  /// pinned by the region loader (requestRegion).
+  /// \return Minimum number of tiles per shard, 0 if not zero-copy
+  uint32_t getMinNbTilesPerShard() const {
+    if (!isZeroCopy()) { return 0; }
+    return _fastImageOptions->getNumberOfViewParallel()
+        + (uint32_t) _tileLoader->getNumThreads() + 1;
+  }
+
+  /// \brief Test if the views reference the cached tiles
+  /// \return True if the zero-copy views are enabled and the radius is 0
+  bool isZeroCopy() const {
+    return _fastImageOptions->isZeroCopyViews() && getRadius() == 0;
+  }
+
+  /// \brief Get the number of NUMA nodes the graph is partitioned into
+  /// \return Number of NUMA nodes, 1 if not in NUMA mode
+  uint32_t getNbNumaNodes() const {
+    return _fastImageOptions->isNumaAware() ?
+           NumaTopology::getInstance().getNbNodes() : 1;
+  }
+
+  /// \brief Connect the tile loaders between the task producing the tile
+  /// requests and the view counter
+  /// \details In NUMA mode, a bookkeeper routes each tile request to the tile
+  /// loader of the node owning the tile (fi::NumaNodeRule). Each node gets a
+  /// copy of the tile loader, its threads pinned on the node.
+  /// \tparam ProducerTask Type of the task producing the tile requests
+  /// \param graph Graph to connect the tile loaders in
+  /// \param producer Task producing the tile requests
+  template<class ProducerTask>
+  void connectTileLoaders(
+      htgs::TaskGraphConf<ViewRequestData<UserType>,
+                          htgs::MemoryData<View<UserType>>> *graph,
+      ProducerTask *producer) {
+    uint32_t nbNumaNodes = getNbNumaNodes();
+    if (nbNumaNodes == 1) {
+      graph->addEdge(producer, _tileLoader);
+      graph->addEdge(_tileLoader, _viewCounter);
+      return;
+    }
+    auto bookkeeper = new htgs::Bookkeeper<TileRequestData<UserType>>();
+    graph->addEdge(producer, bookkeeper);
+    for (uint32_t node = 0; node < nbNumaNodes; ++node) {
+      ATileLoader<UserType> *tileLoader =
+          node == 0 ? _tileLoader : _tileLoader->copy();
+      tileLoader->setNumaNode((int32_t) node);
+      graph->addRuleEdge(bookkeeper,
+                         new NumaNodeRule<UserType>(node, nbNumaNodes),
+                         tileLoader);
+      graph->addEdge(tileLoader, _viewCounter);
+    }
+  }
+
+  /// \brief Create the memory budget of the caches, and divide it between them
+  /// \return The new memory budget
+  CacheBudget<UserType> *createCacheBudget() {
+    std::unique_ptr<CacheBudget<UserType>> cacheBudget(
+        new CacheBudget<UserType>(_fastImageOptions->getCacheMemoryBudget()));
+    for (auto cache : _allCache) { cacheBudget->addCache(cache); }
+    cacheBudget->distribute();
+    return cacheBudget.release();
+  }
+
   /// \brief Set up the graph.
   /// \details Configure the FastImage object. The options are parsed and
   /// applied. The different graph's tasks (ViewLoader, ATileLoader,
@@ -659,8 +1271,12 @@ class FastImage {
       _hasBeenConfigured = true;
       if (_fastImageOptions->getNumberOfTileLoader() == 0)
         _fastImageOptions->setNumberOfTileLoader(1);
+      if (_fastImageOptions->getNumberOfCacheShards() == 0)
+        _fastImageOptions->setNumberOfCacheShards(
+            (uint32_t) _tileLoader->getNumThreads());
 
       ViewLoader<UserType> *viewLoader = nullptr;
+      RawTileReader<UserType> *rawTileReader = nullptr;
       _viewCounter = nullptr;
 
       std::vector<size_t> numViewsParallel;
@@ -668,17 +1284,19 @@ class FastImage {
           viewAllocators;
 
       for (uint32_t level = 0; level < _tileLoader->getNbPyramidLevels(); level++) {
-        // Create the cache
-        auto cache =
-            new FigCache<UserType>(
-                this->_fastImageOptions->getNumberOfTilesToCache()
-            );
-        // Init the cache
-        cache->initCache(this->getNumberTilesHeight(level),
-                         this->getNumberTilesWidth(level),
-                         this->getTileHeight(level),
-                         this->getTileWidth(level));
-        _allCache.push_back(cache);
+        // Create the cache, or get the one shared by the FastImage on the file
+        std::shared_ptr<FigCache<UserType>> cache;
+        if (_fastImageOptions->isCacheShared()) {
+          cache = CacheRegistry<UserType>::getInstance().getCache(
+              _tileLoader->getFilePath(), level,
+              getTileHeight(level), getTileWidth(level),
+              _tileLoader->getDecodeIdentity(), getMinNbTilesPerShard(),
+              [this, level]() { return createCache(level); });
+        } else {
+          cache = std::shared_ptr<FigCache<UserType>>(createCache(level));
+        }
+        _cacheHandles.push_back(cache);
+        _allCache.push_back(cache.get());
 
         size_t
             numViewParallelTemp = _fastImageOptions->getNumberOfViewParallel();
@@ -695,7 +1313,10 @@ class FastImage {
             std::shared_ptr<ViewAllocator<UserType>>(
                 new ViewAllocator<UserType>(
                     getViewHeight(level),
-                    getViewWidth(level)
+                    getViewWidth(level),
+                    numViewParallelTemp,
+                    _fastImageOptions->isUsingHugePages(),
+                    getNbNumaNodes() > 1
                 )
             );
         viewAllocators.push_back(viewAllocator);
@@ -711,23 +1332,61 @@ class FastImage {
       _taskGraph = new htgs::TaskGraphConf<ViewRequestData<UserType>,
                                            htgs::MemoryData<View<UserType>>>();
 
-      // Set the cache
+      // Share the memory budget between the caches
+      if (_fastImageOptions->getCacheMemoryBudget() > 0) {
+        std::shared_ptr<CacheBudget<UserType>> cacheBudget;
+        if (_fastImageOptions->isCacheShared()) {
+          cacheBudget = CacheRegistry<UserType>::getInstance().getCacheBudget(
+              _tileLoader->getFilePath(), _tileLoader->getDecodeIdentity(),
+              [this]() { return createCacheBudget(); });
+        } else {
+          cacheBudget =
+              std::shared_ptr<CacheBudget<UserType>>(createCacheBudget());
+        }
+        if (_allCache.size() > 1) { _tileLoader->setCacheBudget(cacheBudget); }
+      }
+
+      // Set the cache and the traversal
       _tileLoader->setCache(_allCache);
+      _tileLoader->setTraversalType(_fastImageOptions->getTraversalType());
+      _tileLoader->setZeroCopyViews(isZeroCopy());
+      _tileLoader->setFillingType(_fastImageOptions->getFillingType());
 
       // Init the graph's parts
       viewLoader =
           new ViewLoader<UserType>(
               this->_fastImageOptions->getNbReleasePyramid()
           );
+      // The views out of order are at most the views in parallel of a level
+      uint32_t reorderWindow = _fastImageOptions->getReorderWindow();
+      if (reorderWindow == 0) {
+        reorderWindow = (uint32_t) *std::max_element(numViewsParallel.begin(),
+                                                     numViewsParallel.end());
+      }
+      _nbViewsRequested.assign(_tileLoader->getNbPyramidLevels(), 0);
       _viewCounter =
-          new ViewCounter<UserType>(_fastImageOptions->getFillingType(),
-                                    _fastImageOptions->isOrderPreserved());
+          new ViewCounter<UserType>(_fastImageOptions->isOrderPreserved(),
+                                    reorderWindow);
+      uint32_t numberOfRawTileReader =
+          _fastImageOptions->getAsyncReadQueueDepth() > 0 ?
+          std::max(_fastImageOptions->getNumberOfRawTileReader(),
+                   (uint32_t) 1) :
+          _fastImageOptions->getNumberOfRawTileReader();
+      if (numberOfRawTileReader > 0 && _tileLoader->hasRawTileReader()) {
+        rawTileReader = new RawTileReader<UserType>(
+            numberOfRawTileReader, _tileLoader, _allCache,
+            _fastImageOptions->getAsyncReadQueueDepth());
+      }
 
       if (this->getNbPyramidLevels() == 1) {
         // Set graph parts
         _taskGraph->setGraphConsumerTask(viewLoader);
-        _taskGraph->addEdge(viewLoader, _tileLoader);
-        _taskGraph->addEdge(_tileLoader, _viewCounter);
+        if (rawTileReader != nullptr) {
+          _taskGraph->addEdge(viewLoader, rawTileReader);
+          connectTileLoaders(_taskGraph, rawTileReader);
+        } else {
+          connectTileLoaders(_taskGraph, viewLoader);
+        }
         _taskGraph->addGraphProducerTask(_viewCounter);
 
         _taskGraph->addCustomMemoryManagerEdge(viewLoader, memManager);
@@ -736,8 +1395,12 @@ class FastImage {
             new htgs::TaskGraphConf<ViewRequestData<UserType>,
                                     htgs::MemoryData<View<UserType>>>();
         pyramidGraph->setGraphConsumerTask(viewLoader);
-        pyramidGraph->addEdge(viewLoader, _tileLoader);
-        pyramidGraph->addEdge(_tileLoader, _viewCounter);
+        if (rawTileReader != nullptr) {
+          pyramidGraph->addEdge(viewLoader, rawTileReader);
+          connectTileLoaders(pyramidGraph, rawTileReader);
+        } else {
+          connectTileLoaders(pyramidGraph, viewLoader);
+        }
         pyramidGraph->addGraphProducerTask(_viewCounter);
         pyramidGraph->addCustomMemoryManagerEdge(viewLoader, memManager);
         auto
@@ -764,17 +1427,134 @@ class FastImage {
   /// \param indexTileRow Row's index of the view's center tile asked
   /// \param indexTileCol Col's index of the view's center tile asked
   /// \param level Pyramid level
+  /// \param prefetch True to only prefetch the view's tiles in the cache
   void sendRequest(uint32_t indexTileRow,
                    uint32_t indexTileCol,
-                   uint32_t level = 0) {
+                   uint32_t level = 0,
+                   bool prefetch = false) {
     assert(level <= this->_tileLoader->getNbPyramidLevels());
-    _taskGraph->produceData(
-        new ViewRequestData<UserType>(
-            indexTileRow, indexTileCol,
-            getNumberTilesHeight(level), getNumberTilesWidth(level),
-            this->getRadius(), getTileHeight(level), getTileWidth(level),
-            getImageHeight(level), getImageWidth(level), level)
-    );
+    auto viewRequest = makePooled<ViewRequestData<UserType>>(
+        indexTileRow, indexTileCol,
+        getNumberTilesHeight(level), getNumberTilesWidth(level),
+        this->getRadius(), getTileHeight(level), getTileWidth(level),
+        getImageHeight(level), getImageWidth(level), level);
+    viewRequest->setPrefetch(prefetch);
+
+    // Number the views per level, to send them in the requested order
+    if (!prefetch) {
+      viewRequest->setSequenceNumber(_nbViewsRequested[level]++);
+    }
+
+    // Register the view's tiles for the policies using the future accesses,
+    // in the order the ViewLoader asks them. The tile requests give their
+    // position from the view's first access
+    FigCache<UserType> *cache = _allCache[level];
+    if (cache->needsFutureAccesses()) {
+      for (uint32_t r = viewRequest->getIndexRowMinTile();
+           r < viewRequest->getIndexRowMaxTile(); r++) {
+        for (uint32_t c = viewRequest->getIndexColMinTile();
+             c < viewRequest->getIndexColMaxTile(); c++) {
+          uint64_t position = cache->addFutureAccess(r, c);
+          if (r == viewRequest->getIndexRowMinTile()
+              && c == viewRequest->getIndexColMinTile()) {
+            viewRequest->setFirstAccess(position);
+          }
+        }
+      }
+    }
+    _taskGraph->produceData(viewRequest);
+  }
+
+  /// \brief Send the View requests following a traversal, interleaved with
+  /// the prefetch requests of the views getPrefetchDepth(level) steps ahead
+  /// \details The ViewLoader treats the requests in order and waits for an
+  /// available view before treating a view request. The prefetch requests
+  /// are then generated at most prefetch depth views ahead of the views
+  /// being loaded.
+  /// \param steps Views center tile indexes in the traversal order
+  /// \param level Pyramid level
+  void sendRequests(const std::vector<std::pair<uint32_t, uint32_t>> &steps,
+                    uint32_t level) {
+    size_t
+        depth = std::min((size_t) getPrefetchDepth(level), steps.size()),
+        step = 0;
+
+    for (step = 0; step < depth; ++step) {
+      sendRequest(steps[step].first, steps[step].second, level, true);
+    }
+    for (step = 0; step < steps.size(); ++step) {
+      if (step + depth < steps.size()) {
+        sendRequest(steps[step + depth].first, steps[step + depth].second,
+                    level, true);
+      }
+      sendRequest(steps[step].first, steps[step].second, level);
+    }
+  }
+
+  /// \brief Get the tile loader of the regions of a level, the regionMutex
+  /// has to be held
+  /// \details Created once per level by copying the tile loader, and
+  /// initialized as the graph initializes its copies in the level's pipeline:
+  /// its pipeline id is the level, so it loads the tiles of the level. Its
+  /// threads are not pinned on a NUMA node, the regions being loaded on the
+  /// calling thread.
+  /// \param level Pyramid level
+  /// \return Tile loader of the regions of the level
+  ATileLoader<UserType> *getRegionTileLoader(uint32_t level) {
+    if (_regionTileLoaders.empty()) {
+      _regionTileLoaders.assign(getNbPyramidLevels(), nullptr);
+    }
+    ATileLoader<UserType> *&regionTileLoader = _regionTileLoaders[level];
+    if (regionTileLoader == nullptr) {
+      regionTileLoader = _tileLoader->copy();
+      regionTileLoader->setNumaNode(-1);
+      regionTileLoader->htgs::AnyITask::initialize(
+          level, getNbPyramidLevels(), "");
+    }
+    return regionTileLoader;
+  }
+
+  /// \brief Get the pool of the regions of a size, created for the first
+  /// regionPoolsMax sizes requested, the regionMutex has to be held
+  /// \param height Region height in px
+  /// \param width Region width in px
+  /// \return Arena of the regions of this size, nullptr to allocate the
+  /// region on the heap
+  std::shared_ptr<TileArena<UserType>> getRegionArena(uint32_t height,
+                                                      uint32_t width) {
+    auto size = std::make_pair(height, width);
+    auto arena = _regionArenas.find(size);
+    if (arena != _regionArenas.end()) { return arena->second; }
+    if (_regionArenas.size() >= regionPoolsMax) { return nullptr; }
+    auto newArena = std::make_shared<TileArena<UserType>>(
+        (size_t) height * width,
+        _fastImageOptions->getNumberOfViewParallel(),
+        _fastImageOptions->isUsingHugePages());
+    _regionArenas.emplace(size, newArena);
+    return newArena;
+  }
+
+  /// \brief Get the prefetch depth bounded by the cache capacity
+  /// \details The tiles of the views prefetched and of the views in progress
+  /// have to fit in the cache, else the prefetched tiles would be recycled
+  /// before being used.
+  /// \param level Pyramid level
+  /// \return Number of views to prefetch ahead
+  uint32_t getPrefetchDepth(uint32_t level) const {
+    auto tilesSpanned = [this](uint32_t tileSize) {
+      return 2 * (uint32_t) ceil((double) this->getRadius() / tileSize) + 1;
+    };
+    uint32_t
+        tilesPerView =
+        std::min(tilesSpanned(getTileHeight(level)),
+                 getNumberTilesHeight(level))
+            * std::min(tilesSpanned(getTileWidth(level)),
+                       getNumberTilesWidth(level)),
+        viewsInCache = _allCache[level]->getNbTilesCache() / tilesPerView,
+        viewsInProgress = _fastImageOptions->getNumberOfViewParallel();
+    if (viewsInCache <= viewsInProgress) { return 0; }
+    return std::min(_fastImageOptions->getPrefetchDepth(),
+                    viewsInCache - viewsInProgress);
   }
 
   uint32_t
@@ -801,9 +1581,28 @@ class FastImage {
   std::vector<FigCache<UserType> *>
       _allCache;                      ///< Tile Caches given to each tile loader
 
+  std::vector<std::shared_ptr<FigCache<UserType>>>
+      _cacheHandles;                  ///< Caches ownership, shared with the
+                                      ///< FastImage on the same file
+
   Options *
       _fastImageOptions = nullptr;    ///< Fast Image Options
 
+  std::vector<uint64_t>
+      _nbViewsRequested;              ///< Number of views requested per
+                                      ///< level, numbering the views
+
+  std::vector<ATileLoader<UserType> *>
+      _regionTileLoaders;             ///< Tile loaders of the regions' tiles,
+                                      ///< per level
+
+  std::map<std::pair<uint32_t, uint32_t>,
+           std::shared_ptr<TileArena<UserType>>>
+      _regionArenas;                  ///< Pools of the regions per size
+
+  std::mutex
+      _regionMutex;                   ///< Serializes the region requests
+
   bool
       _hasBeenConfigured = false;     ///< Private flag to be sure the FI is
                                       ///< configure
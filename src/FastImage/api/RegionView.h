@@ -0,0 +1,162 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+
+/// @file RegionView.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Image's region of interest, not aligned on the tiles
+
+#ifndef FASTIMAGE_REGIONVIEW_H
+#define FASTIMAGE_REGIONVIEW_H
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include "../memory/TileArena.h"
+
+/// \namespace fi FastImage namespace
+namespace fi {
+
+/**
+ * @class RegionView RegionView.h <FastImage/api/RegionView.h>
+ * @brief Region of interest of the image, of any position and size.
+ * @details Returned by FastImage::requestRegion, the region view holds
+ * exactly the pixels of the region asked, copied from the needed parts of
+ * the cached tiles. Unlike a fi::View, it is not centred on a tile and has
+ * no ghost region. The pixels are located by their local coordinate where
+ * the position (0/0) is the upper left pixel of the region.
+ *
+ * @code
+ * auto region = fi->requestRegion(level, y, x, 300, 300);
+ * for (uint32_t r = 0; r < region->getRegionHeight(); ++r) {
+ *   for (uint32_t c = 0; c < region->getRegionWidth(); ++c) {
+ *     pixValue = region->getPixel(r, c);
+ *     ...
+ *   }
+ * }
+ * @endcode
+ *
+ * @tparam UserType Pixel Type asked by the end user
+ */
+template<typename UserType>
+class RegionView {
+ public:
+  /// \brief Create the region view, allocate the array of pixel
+  /// \param globalRow Row of the region upper left pixel in the image
+  /// \param globalCol Column of the region upper left pixel in the image
+  /// \param regionHeight Region height in pixel
+  /// \param regionWidth Region width in pixel
+  /// \param level Pyramid level
+  /// \param arena Arena allocating the array of pixel, nullptr to allocate it
+  /// on the heap
+  RegionView(uint32_t globalRow, uint32_t globalCol,
+             uint32_t regionHeight, uint32_t regionWidth, uint32_t level,
+             std::shared_ptr<TileArena<UserType>> arena = nullptr)
+      : _data(arena != nullptr ? arena->allocate()
+                               : new UserType[(size_t) regionHeight
+                                   * regionWidth]),
+        _arena(std::move(arena)),
+        _globalRow(globalRow), _globalCol(globalCol),
+        _regionHeight(regionHeight), _regionWidth(regionWidth),
+        _level(level) {}
+
+  /// \brief RegionView destructor, deallocate the array of pixel
+  ~RegionView() {
+    if (_arena != nullptr) { _arena->deallocate(_data); }
+    else { delete[] _data; }
+  }
+
+  RegionView(const RegionView &) = delete;
+  RegionView &operator=(const RegionView &) = delete;
+
+  /// \brief Get the row of the region upper left pixel in the image
+  /// \return Row in global coordinate
+  uint32_t getGlobalRow() const { return _globalRow; }
+
+  /// \brief Get the column of the region upper left pixel in the image
+  /// \return Column in global coordinate
+  uint32_t getGlobalCol() const { return _globalCol; }
+
+  /// \brief Get region height in px
+  /// \return Region height in px
+  uint32_t getRegionHeight() const { return _regionHeight; }
+
+  /// \brief Get region width in px
+  /// \return Region width in px
+  uint32_t getRegionWidth() const { return _regionWidth; }
+
+  /// \brief Get the pyramid level the region come from
+  /// \return Pyramid level
+  uint32_t getPyramidLevel() const { return _level; }
+
+  /// \brief Get the leading dimension
+  /// \return Leading dimension
+  uint32_t getLeadingDimension() const { return _regionWidth; }
+
+  /// \brief Get the pointer to the region
+  /// \return The pointer to the region
+  UserType *getData() const { return _data; }
+
+  /// \brief Get the pixel value from it local coordinate
+  /// \param rowAsked Row coordinate's pixel
+  /// \param colAsked Column coordinate's pixel
+  /// \return The pixel value
+  UserType getPixel(uint32_t rowAsked, uint32_t colAsked) const {
+    assert(rowAsked < _regionHeight && colAsked < _regionWidth);
+    return _data[(size_t) rowAsked * _regionWidth + colAsked];
+  }
+
+  /// \brief Set a pixel in the region
+  /// \param rowAsked Pixel's row
+  /// \param colAsked Pixel's col
+  /// \param value value to set
+  void setPixel(uint32_t rowAsked, uint32_t colAsked, const UserType &value) {
+    assert(rowAsked < _regionHeight && colAsked < _regionWidth);
+    _data[(size_t) rowAsked * _regionWidth + colAsked] = value;
+  }
+
+ private:
+  UserType *
+      _data;                  ///< Array of pixel of the region
+
+  std::shared_ptr<TileArena<UserType>>
+      _arena;                 ///< Arena of the array of pixel, nullptr if on
+                              ///< the heap
+
+  uint32_t
+      _globalRow,             ///< Upper left row in global coordinate
+      _globalCol,             ///< Upper left column in global coordinate
+      _regionHeight,          ///< Region height in pixel
+      _regionWidth,           ///< Region width in pixel
+      _level;                 ///< Image Pyramid level
+};
+}
+
+#endif //FASTIMAGE_REGIONVIEW_H
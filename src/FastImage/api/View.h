@@ -38,10 +38,12 @@
 #include <sstream>
 #include <iomanip>
 #include <vector>
+#include <atomic>
 #include "FastImage/data/CachedTile.h"
 #include "../data/DataType.h"
 #include "FastImage/data/ViewRequestData.h"
 #include "../object/FigCache.h"
+#include "../memory/TileArena.h"
 #include "../exception/FastImageException.h"
 
 /// \namespace fi FastImage namespace
@@ -71,6 +73,11 @@ namespace fi {
  * }
  * @endcode
  *
+ * With a radius of 0, a view covering a whole tile can reference the pinned
+ * cached tile instead of copying it (zero-copy views, see
+ * FastImage::Options::setZeroCopyViews). The view pixels are then the cache
+ * pixels: they must only be read. The tile is released with the view.
+ *
  * @tparam UserType Pixel Type asked by the end user
  */
 template<typename UserType>
@@ -79,11 +86,48 @@ class View : public htgs::IData {
   /// \brief Create the View, allocate the array of pixel.
   /// \param row Number of pixel in a view
   /// \param col Number of pixel in a view
-  View(const uint32_t &row, const uint32_t &col)
-      : _data(new UserType[row * col]), _viewHeight(row), _viewWidth(col) {}
+  /// \param arena Arena allocating the array of pixel, nullptr to allocate it
+  /// on the heap
+  View(const uint32_t &row, const uint32_t &col,
+       std::shared_ptr<TileArena<UserType>> arena = nullptr)
+      : _ownData(arena != nullptr ? arena->allocate()
+                                  : new UserType[row * col]),
+        _arena(std::move(arena)), _viewHeight(row), _viewWidth(col) {
+    _data = _ownData;
+  }
 
-  /// \brief View destructor, deallocate the array of pixel.
-  ~View() override { delete[] _data; }
+  /// \brief View destructor, release the referenced tile and deallocate the
+  /// array of pixel.
+  ~View() override {
+    releaseTile();
+    if (_arena != nullptr) { _arena->deallocate(_ownData); }
+    else { delete[] _ownData; }
+  }
+
+  /// \brief Reference a pinned cached tile as the view pixels, instead of
+  /// copying it
+  /// \details The tile stays pinned until releaseTile, so it can not be
+  /// evicted while the view is used. The tile must have the view size.
+  /// \param tile Pinned cached tile, released by the view
+  void referenceTile(CachedTile<UserType> *tile) {
+    releaseTile();
+    _pinnedTile = tile;
+    _data = tile->getData();
+  }
+
+  /// \brief Release the referenced cached tile, if any, and use back the
+  /// view's own array of pixel
+  void releaseTile() {
+    if (_pinnedTile != nullptr) {
+      _pinnedTile->release();
+      _pinnedTile = nullptr;
+      _data = _ownData;
+    }
+  }
+
+  /// \brief Test if the view references a cached tile
+  /// \return True if the view pixels are the pixels of a cached tile
+  bool isReferencingTile() const { return _pinnedTile != nullptr; }
 
   /// \brief Get view width in px
   /// \return View width in px
@@ -141,6 +185,12 @@ class View : public htgs::IData {
     return this->_viewRequestData->getIndexColCenterTile();
   }
 
+  /// \brief Get the position of the view in the sequence of views requested
+  /// \return Sequence number of the view
+  uint64_t getSequenceNumber() const {
+    return this->_viewRequestData->getSequenceNumber();
+  }
+
   /// \brief Get the View Radius
   /// \return View Radius
   uint32_t getRadius() const { return _viewRequestData->getRadius(); }
@@ -208,6 +258,8 @@ class View : public htgs::IData {
       const std::shared_ptr<fi::ViewRequestData<UserType>> &viewRequest,
       FillingType fillingType = FillingType::FILL) {
 
+    releaseTile();
+    _nbTilesLoaded.store(0, std::memory_order_relaxed);
     auto
         tileHeight = viewRequest->getTileHeight(),
         tileWidth = viewRequest->getTileWidth();
@@ -225,6 +277,30 @@ class View : public htgs::IData {
     _maxColRealPixelLocal = viewRequest->getMaxColFile() - _minColCenterTileGlobal;
   }
 
+  /// \brief Count a tile copied in the view, thread safe
+  /// \details The tile loaders copy the tiles of the view at the same time,
+  /// the loader of the last tile completes the view.
+  /// \return True if the tile was the last one of the view, else False
+  bool tileLoaded() {
+    return _nbTilesLoaded.fetch_add(1, std::memory_order_acq_rel) + 1
+        == _viewRequestData->getNumberTilesToLoad();
+  }
+
+  /// \brief Fill the ghost region, once every tile is copied
+  /// \param fillingType Filling used to complete the ghost region
+  void fillGhostRegion(FillingType fillingType = FillingType::FILL) {
+    if (_viewRequestData->getTopFill() == 0
+        && _viewRequestData->getBottomFill() == 0
+        && _viewRequestData->getLeftFill() == 0
+        && _viewRequestData->getRightFill() == 0) {
+      return;
+    }
+    switch (fillingType) {
+      case FillingType::FILL:fill();
+        break;
+    }
+  }
+
   /// \brief Output operator stream to print a view
   /// \param os Stream to put the view information
   /// \param data The ViewData to print
@@ -298,11 +374,23 @@ class View : public htgs::IData {
 
  private:
   UserType *
-      _data;                  ///< Augmented Tile, Tile w/ a ghost region
+      _data,                  ///< Augmented Tile, Tile w/ a ghost region
+      *_ownData;              ///< Array of pixel owned by the view
+
+  CachedTile<UserType> *
+      _pinnedTile = nullptr;  ///< Cached tile referenced, nullptr if the
+                              ///< pixels are copied in _ownData
+
+  std::shared_ptr<TileArena<UserType>>
+      _arena;                 ///< Arena of the array of pixel, nullptr if on
+                              ///< the heap
 
   std::shared_ptr<fi::ViewRequestData<UserType>>
       _viewRequestData;       ///< ViewRequest creating the view
 
+  std::atomic<uint32_t>
+      _nbTilesLoaded{0};      ///< Number of tiles copied in the view
+
   uint32_t
       _viewHeight,            ///< Tile height in pixel
       _viewWidth,             ///< Tile width in pixel
@@ -330,6 +418,77 @@ class View : public htgs::IData {
       _maxColCenterTileLocal
       {};           ///< Column maximum in the central tile in local coordinate
 
+  /// \brief Private function. Filling type where the data are duplicated from
+  /// the nearest border :
+  /// radius 1 for a 3x3 tile with only ghost region
+  ///      a  abc  c
+  ///
+  ///      a  abc  c
+  ///      d  def  f
+  ///      g  ghi  i
+  ///
+  ///      g  ghi  i
+  ///
+  void fill() {
+
+    UserType *tile = _data;
+
+    uint32_t
+        topFill = _viewRequestData->getTopFill(),
+        bottomFill = _viewRequestData->getBottomFill(),
+        leftFill = _viewRequestData->getLeftFill(),
+        rightFill = _viewRequestData->getRightFill(),
+        viewHeight = _viewHeight,
+        viewWidth = _viewWidth;
+
+    for (uint32_t row = topFill; row < viewHeight - bottomFill; ++row) {
+      // L
+      std::fill_n(
+          tile + (row * viewWidth),
+          leftFill,
+          tile[row * viewWidth + leftFill]);
+      // R
+      std::fill_n(
+          tile + (row * viewWidth + viewWidth - rightFill),
+          rightFill,
+          tile[row * viewWidth + viewWidth - rightFill - 1]);
+    }
+    for (uint32_t row = 0; row < topFill; ++row) {
+      // UL
+      std::fill_n(
+          tile + (row * viewWidth),
+          leftFill,
+          tile[topFill * viewWidth + leftFill]);
+      // U
+      std::copy_n(
+          tile + (topFill * viewWidth + leftFill),
+          viewWidth - leftFill - rightFill,
+          tile + (row * viewWidth + leftFill));
+      // UR
+      std::fill_n(
+          tile + (row * viewWidth + viewWidth - rightFill),
+          rightFill,
+          tile[row * viewWidth + viewWidth - rightFill - 1]);
+    }
+    for (uint32_t row = viewHeight - bottomFill; row < viewHeight; ++row) {
+      // BL
+      std::fill_n(
+          tile + (row * viewWidth),
+          leftFill,
+          tile[(viewHeight - bottomFill - 1) * viewWidth + leftFill]);
+      // B
+      std::copy_n(
+          tile + ((viewHeight - bottomFill - 1) * viewWidth + leftFill),
+          viewWidth - leftFill - rightFill,
+          tile + (row * viewWidth + leftFill));
+      // BR
+      std::fill_n(
+          tile + (row * viewWidth + viewWidth - rightFill),
+          rightFill,
+          tile[(viewHeight - bottomFill) * viewWidth - rightFill - 1]);
+    }
+  }
+
   /// \brief Test if the local coordinate is in the view
   /// \param rowAsked Row asked in picture coordinate
   /// \param colAsked Global asked in picture coordinate
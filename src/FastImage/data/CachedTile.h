@@ -39,6 +39,11 @@
 #include <cassert>
 #include <ostream>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "FastImage/data/DataType.h"
+#include "FastImage/memory/TileArena.h"
+#include "FastImage/object/UnpinSignal.h"
 
 namespace fi {
 /// \namespace fi FastImage namespace
@@ -48,6 +53,22 @@ namespace fi {
  * @brief Tile Cached from the file.
  * @details The cached tile is used to prevent excess IO (i.e. from disk).
  * Once a tile has been loaded from the file it is saved to the cache.
+ * A tile handed out by the cache is pinned: it can not be recycled by the
+ * cache until every user has released (or unlocked) it. The pin count is the
+ * tile reference count.
+ * A tile goes from EMPTY to LOADING to READY (fi::TileState). Only the user
+ * claiming the loading with beginLoading writes the tile; the other users
+ * wait for it to be READY. Once READY, the tile is only read, so the users
+ * read it at the same time, without lock.
+ * @code
+ * auto tile = cache->getPinnedTile(row, col);
+ * if (tile->beginLoading()) {
+ *   // load the tile data
+ *   tile->setReady();
+ * }
+ * // read the tile data
+ * tile->release();
+ * @endcode
  *
  * @tparam UserType Pixel Type asked by the end user
  *
@@ -58,16 +79,27 @@ class CachedTile {
   /// \brief CachedTile Constructor, allocate the data buffer
   /// \param tileWidth Tile width in px
   /// \param tileHeight Tile height in px
-  explicit CachedTile(uint32_t tileWidth, uint32_t tileHeight) :
-      _data(new UserType[tileWidth * tileHeight]),
+  /// \param arena Arena allocating the data buffer, nullptr to allocate it
+  /// on the heap
+  /// \param unpinSignal Signal notified when the last pin is released,
+  /// nullptr for none
+  explicit CachedTile(uint32_t tileWidth, uint32_t tileHeight,
+                      TileArena<UserType> *arena = nullptr,
+                      UnpinSignal *unpinSignal = nullptr) :
+      _data(arena != nullptr ? arena->allocate()
+                             : new UserType[tileWidth * tileHeight]),
       _indexRow(0),
       _indexCol(0),
-      _newTile(true),
+      _arena(arena),
+      _unpinSignal(unpinSignal),
       _tileWidth(tileWidth),
       _tileHeight(tileHeight) {}
 
   /// \brief CachedTile Destructor, deallocate the data buffer.
-  ~CachedTile() { delete[] _data; };
+  ~CachedTile() {
+    if (_arena != nullptr) { _arena->deallocate(_data); }
+    else { delete[] _data; }
+  };
 
   /// \brief Get pointer to the data buffer
   /// \return Pointer to the data buffer
@@ -82,8 +114,12 @@ class CachedTile {
   uint32_t getIndexColGlobal() const { return _indexCol; }
 
   /// \brief Test is the tile is a new tile
-  /// \return True if the tile new, else False
-  bool isNewTile() const { return _newTile; }
+  /// \return True if the tile new (not READY), else False
+  bool isNewTile() const { return getState() != TileState::READY; }
+
+  /// \brief Get the tile loading state
+  /// \return Tile loading state
+  TileState getState() const { return _state.load(std::memory_order_acquire); }
 
   /// \brief Get the width of the tile
   /// \return Tile width
@@ -105,15 +141,110 @@ class CachedTile {
     _indexRow = indexRowGlobal;
   }
 
-  /// \brief Set if the tile is a new  tile
+  /// \brief Set if the tile is a new  tile, the tile being locked or not
+  /// used
+  /// \details A tile not new is READY, the users waiting for it are
+  /// notified
   /// \param newTile True if the tile is new, else False
-  void setNewTile(bool newTile) { _newTile = newTile; }
+  void setNewTile(bool newTile) {
+    _state.store(newTile ? TileState::EMPTY : TileState::READY,
+                 std::memory_order_release);
+    if (!newTile) { _readyCondition.notify_all(); }
+  }
+
+  /// \brief Wait for the tile to be READY, or claim its loading if EMPTY
+  /// \details A READY tile is returned without lock. If the caller claims
+  /// the loading, it has to load the tile data and call setReady.
+  /// \return True if the caller has to load the tile, else False (the tile
+  /// is READY)
+  bool beginLoading() {
+    bool waited;
+    return beginLoading(waited);
+  }
+
+  /// \brief Wait for the tile to be READY, or claim its loading if EMPTY
+  /// \details Same as beginLoading(), telling if the caller waited for the
+  /// tile being loaded by an other user.
+  /// \param waited Set to true if the caller waited for the tile, else false
+  /// \return True if the caller has to load the tile, else False (the tile
+  /// is READY)
+  bool beginLoading(bool &waited) {
+    waited = false;
+    if (getState() == TileState::READY) { return false; }
+    std::unique_lock<std::mutex> lock(_accessMutex);
+    // The loading is claimed again if the loader aborted it
+    while (true) {
+      TileState expected = TileState::EMPTY;
+      if (_state.compare_exchange_strong(expected, TileState::LOADING,
+                                         std::memory_order_acq_rel)) {
+        return true;
+      }
+      if (expected == TileState::READY) { return false; }
+      waited = true;
+      _readyCondition.wait(lock, [this]() {
+        return getState() != TileState::LOADING;
+      });
+    }
+  }
+
+  /// \brief Set the tile READY once loaded, and notify the users waiting
+  /// for it
+  void setReady() {
+    {
+      std::lock_guard<std::mutex> lock(_accessMutex);
+      _state.store(TileState::READY, std::memory_order_release);
+    }
+    _readyCondition.notify_all();
+  }
+
+  /// \brief Set the tile back to EMPTY if its loading failed, and notify the
+  /// users waiting for it, one of them claiming the loading
+  void abortLoading() {
+    {
+      std::lock_guard<std::mutex> lock(_accessMutex);
+      _state.store(TileState::EMPTY, std::memory_order_release);
+    }
+    _readyCondition.notify_all();
+  }
+
+  /// \brief Release the pin taken by the cache, the tile can be recycled
+  /// once released by all its users
+  void release() { unpin(); }
+
+  /// \brief Get the index used by the eviction policy
+  /// \return Index used by the eviction policy
+  uint32_t getEvictionIndex() const { return _evictionIndex; }
+
+  /// \brief Set the index used by the eviction policy
+  /// \param evictionIndex Index used by the eviction policy
+  void setEvictionIndex(uint32_t evictionIndex) {
+    _evictionIndex = evictionIndex;
+  }
 
-  /// \brief Lock the tile
+  /// \brief Get the flag used by the eviction policy
+  /// \return Flag used by the eviction policy
+  bool getEvictionBit() const { return _evictionBit; }
+
+  /// \brief Set the flag used by the eviction policy
+  /// \param evictionBit Flag used by the eviction policy
+  void setEvictionBit(bool evictionBit) { _evictionBit = evictionBit; }
+
+  /// \brief Test if the tile is pinned, i.e. used by at least one loader
+  /// \return True if the tile is pinned, else False
+  bool isPinned() const { return _pinCount.load() != 0; }
+
+  /// \brief Pin the tile, prevent the cache to recycle it
+  /// \note Called by the cache while holding the cache lock
+  void pin() { _pinCount.fetch_add(1); }
+
+  /// \brief Lock the tile for an exclusive access
   void lock() { _accessMutex.lock(); }
 
-  /// \brief Unlock the tile
-  void unlock() { _accessMutex.unlock(); }
+  /// \brief Unlock the tile and release the pin taken by the cache
+  void unlock() {
+    _accessMutex.unlock();
+    unpin();
+  }
 
   /// \brief Output stream to print a tile
   /// \param os Stream to put the tile information
@@ -122,7 +253,7 @@ class CachedTile {
   friend std::ostream &operator<<(std::ostream &os, const CachedTile &tile) {
     os << "CachedTile " << tile._data << "_indexRow: " << tile._indexRow
        << " _indexCol: " << tile._indexCol
-       << " _newTile: " << tile._newTile << " _tileWidth: "
+       << " _newTile: " << tile.isNewTile() << " _tileWidth: "
        << tile._tileWidth << " _tileHeight: " << tile._tileHeight << std::endl;
 
     for (uint32_t r = 0; r < tile._tileHeight; ++r) {
@@ -135,6 +266,16 @@ class CachedTile {
     return os;
   }
  protected:
+  /// \brief Release a pin, notifying the unpin signal if it was the last one
+  /// \details The signal is read before, the tile being possibly deleted by
+  /// the cache once not pinned.
+  void unpin() {
+    UnpinSignal *unpinSignal = _unpinSignal;
+    if (_pinCount.fetch_sub(1) == 1 && unpinSignal != nullptr) {
+      unpinSignal->notify();
+    }
+  }
+
   UserType
       *_data;         ///< Tile data.
 
@@ -142,11 +283,29 @@ class CachedTile {
       _indexRow,      ///< Row index tile asked in global coordinate
       _indexCol;      ///< Column index tile asked in global coordinate
 
-  bool
-      _newTile;       ///< True if the tile is a new tile, else not
+  TileArena<UserType> *
+      _arena;         ///< Arena of the data buffer, nullptr if on the heap
+
+  UnpinSignal *
+      _unpinSignal;   ///< Signal notified when the last pin is released
+
+  std::atomic<TileState>
+      _state{TileState::EMPTY}; ///< Loading state
 
   std::mutex
-      _accessMutex;   ///< Access mutex
+      _accessMutex;   ///< Access mutex, exclusive access and loading wait
+
+  std::condition_variable
+      _readyCondition; ///< Notify the tile is READY
+
+  std::atomic<uint32_t>
+      _pinCount{0};   ///< Number of users holding the tile
+
+  uint32_t
+      _evictionIndex = 0; ///< Index used by the eviction policy
+
+  bool
+      _evictionBit = false; ///< Flag used by the eviction policy
 
   uint32_t
       _tileWidth,     ///< Tile width
@@ -58,6 +58,29 @@ enum class Direction {
   EAST,
   WEST
 };
+
+/// \brief Loading state of a cached tile
+enum class TileState {
+  EMPTY,    ///< The tile has no data
+  LOADING,  ///< The tile is being loaded by a tile loader
+  READY     ///< The tile data is loaded, and only read
+};
+
+/// \brief Eviction policies of the cache
+enum class EvictionPolicyType {
+  LRU,
+  CLOCK,
+  ARC,
+  MIN
+};
+
+/// \brief Stages of a tile access timed in the cache metrics
+enum class LatencyType {
+  LOOKUP,     ///< Get the pinned tile from the cache
+  DISK_READ,  ///< Read the tile from the file
+  DECODE,     ///< Decode the tile into the cache
+  COPY        ///< Copy the tile into the view
+};
 }
 
 #endif //FASTIMAGE_DATATYPE_H
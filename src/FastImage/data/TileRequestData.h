@@ -35,6 +35,7 @@
 #define FASTIMAGE_TILEREQUESTDATA_H
 
 #include <ostream>
+#include <vector>
 #include <htgs/api/IData.hpp>
 #include <htgs/types/Types.hpp>
 
@@ -151,6 +152,53 @@ class TileRequestData : public htgs::IData {
     return _viewRequest;
   }
 
+  /// \brief Test if the tile is only prefetched in the cache, no view is
+  /// attached to the request
+  /// \return True if the tile is only prefetched, else False
+  bool isPrefetch() const { return _viewRequest->isPrefetch(); }
+
+  /// \brief Get the position of the tile access in the sequence of accesses
+  /// registered in the cache, following the view's first access row by row
+  /// \return Position of the tile access, max uint64_t if not registered
+  uint64_t getAccessPosition() const {
+    if (_viewRequest == nullptr
+        || _viewRequest->getFirstAccess()
+            == std::numeric_limits<uint64_t>::max()) {
+      return std::numeric_limits<uint64_t>::max();
+    }
+    return _viewRequest->getFirstAccess()
+        + (uint64_t) (_indexRowTileAsked - _viewRequest->getIndexRowMinTile())
+            * (_viewRequest->getIndexColMaxTile()
+                - _viewRequest->getIndexColMinTile())
+        + (_indexColTileAsked - _viewRequest->getIndexColMinTile());
+  }
+
+  /// \brief Test if the raw (not decoded) tile has been read from the file
+  /// by a fi::RawTileReader
+  /// \return True if the raw tile is attached to the request, else False
+  bool hasRawTile() const { return _hasRawTile; }
+
+  /// \brief Get the raw tile read from the file
+  /// \return Raw tile
+  std::vector<uint8_t> &getRawTile() { return _rawTile; }
+
+  /// \brief Get the duration to read the raw tile from the file
+  /// \return Duration to read the raw tile in ns
+  double getRawTileReadDuration() const { return _rawTileReadDuration; }
+
+  /// \brief Set the raw tile has been read from the file
+  /// \param readDuration Duration to read the raw tile in ns
+  void setRawTileRead(double readDuration) {
+    _hasRawTile = true;
+    _rawTileReadDuration = readDuration;
+  }
+
+  /// \brief Release the raw tile memory, once decoded
+  void releaseRawTile() {
+    _hasRawTile = false;
+    std::vector<uint8_t>().swap(_rawTile);
+  }
+
   /// \brief Get tile Height
   /// \return Tile height
   uint32_t getTileHeight() const { return _viewRequest->getTileHeight(); }
@@ -237,6 +285,15 @@ class TileRequestData : public htgs::IData {
 
   std::shared_ptr<ViewRequestData<UserType>>
       _viewRequest;       ///<View request generating the view data
+
+  std::vector<uint8_t>
+      _rawTile;           ///< Raw tile read from the file, not decoded
+
+  double
+      _rawTileReadDuration = 0; ///< Duration to read the raw tile in ns
+
+  bool
+      _hasRawTile = false;  ///< True if the raw tile has been read
 };
 }
 #endif //FASTIMAGE_TILEREQUESTDATA_H
@@ -37,6 +37,7 @@
 #include <htgs/api/IData.hpp>
 #include <ostream>
 #include <cmath>
+#include <limits>
 
 namespace fi {
 /// \namespace fi FastImage namespace
@@ -222,6 +223,39 @@ class ViewRequestData : public htgs::IData {
   /// \return Pyramid level
   uint32_t getLevel() const { return _level; }
 
+  /// \brief Test if the request only prefetches the view's tiles in the cache
+  /// \return True if the request is a prefetch request, else False
+  bool isPrefetch() const { return _prefetch; }
+
+  /// \brief Set if the request only prefetches the view's tiles in the cache
+  /// \details A prefetch request does not produce any view, the ViewLoader
+  /// asks the view's tiles to the ATileLoader which only loads them in the
+  /// cache.
+  /// \param prefetch True if the request is a prefetch request, else False
+  void setPrefetch(bool prefetch) { _prefetch = prefetch; }
+
+  /// \brief Get the position of the view in the sequence of views requested
+  /// \return Sequence number of the view
+  uint64_t getSequenceNumber() const { return _sequenceNumber; }
+
+  /// \brief Set the position of the view in the sequence of views requested,
+  /// used to send the views in the requested order
+  /// \param sequenceNumber Sequence number of the view
+  void setSequenceNumber(uint64_t sequenceNumber) {
+    _sequenceNumber = sequenceNumber;
+  }
+
+  /// \brief Get the position of the view's first tile access, registered in
+  /// the cache for the policies needing the future accesses
+  /// \return Position of the first tile access, max uint64_t if not
+  /// registered
+  uint64_t getFirstAccess() const { return _firstAccess; }
+
+  /// \brief Set the position of the view's first tile access, the next tiles
+  /// following row by row
+  /// \param firstAccess Position of the first tile access
+  void setFirstAccess(uint64_t firstAccess) { _firstAccess = firstAccess; }
+
   /// \brief Output stream operator
   /// \param os output stream
   /// \param data data to print
@@ -274,6 +308,16 @@ class ViewRequestData : public htgs::IData {
       _bottomFill,            ///< Bottom rows to fill with ghost data
       _rightFill,             ///< Right columns to fill with ghost data
       _level;                 ///< Image Pyramid level
+
+  uint64_t
+      _sequenceNumber = 0,    ///< Position in the sequence of views requested
+      _firstAccess =
+      std::numeric_limits<uint64_t>::max(); ///< Position of the first tile
+                                            ///< access, max if not registered
+
+  bool
+      _prefetch = false;      ///< True if the request only prefetches the
+                              ///< view's tiles
 };
 }
 
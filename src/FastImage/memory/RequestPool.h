@@ -0,0 +1,293 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+
+/// @file RequestPool.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Pool of recycled blocks for the requests sent through the graph
+
+#ifndef FASTIMAGE_REQUESTPOOL_H
+#define FASTIMAGE_REQUESTPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class RequestPool RequestPool.h <FastImage/memory/RequestPool.h>
+  *
+  * @brief Process-wide pool of recycled memory blocks of BlockSize bytes, for
+  * the requests sent through the graph.
+  *
+  * @details A view request is created by FastImage for each view, and a tile
+  * request by the ViewLoader for each tile a view overlaps. These small
+  * objects are held by std::shared_ptr and released by other threads once
+  * treated. Created with fi::makePooled, the object and its shared_ptr
+  * control block are placed in a single block of the pool. A released block
+  * goes back to the pool and is given to the next request, without going
+  * through the heap.
+  *
+  * Each thread keeps its own list of free blocks, linked through the blocks,
+  * so an allocation or a deallocation takes neither a lock nor an atomic
+  * operation. A thread holding more than 2 * blocksPerBatch free blocks, the
+  * one releasing the requests, gives blocksPerBatch of them to the pool; a
+  * thread without free block, the one creating the requests, takes back a
+  * batch from the pool, or carves a new one. Only these exchanges take the
+  * pool mutex, once every blocksPerBatch requests. The free blocks of a
+  * thread go back to the pool when the thread exits.
+  *
+  * There is one pool per block size, living as long as the process: the
+  * blocks are kept for the next requests and never go back to the heap.
+  *
+  * @tparam BlockSize Block size in bytes, a multiple of the maximum alignment
+  **/
+template<size_t BlockSize>
+class RequestPool {
+  static_assert(BlockSize % alignof(std::max_align_t) == 0,
+                "The block size has to keep the blocks aligned");
+
+ public:
+  static constexpr size_t
+      blocksPerBatch = 64;            ///< Number of blocks exchanged at once
+                                      ///< between a thread and the pool
+
+  RequestPool(const RequestPool &) = delete;
+  RequestPool &operator=(const RequestPool &) = delete;
+
+  /// \brief Allocate a block, recycled if one has been released, else from a
+  /// new batch
+  /// \return Block of BlockSize bytes
+  static void *allocate() {
+    LocalBlocks &local = localBlocks();
+    if (local.head == nullptr) {
+      local.head = instance().takeBatch(local.nbBlocks);
+    }
+    FreeBlock *block = local.head;
+    local.head = block->next;
+    --local.nbBlocks;
+    return block;
+  }
+
+  /// \brief Deallocate a block allocated by a pool of the same block size,
+  /// from any thread
+  /// \param block Block to deallocate
+  static void deallocate(void *block) {
+    LocalBlocks &local = localBlocks();
+    if (local.nbBlocks == 2 * blocksPerBatch) {
+      // Keep the last blocksPerBatch blocks, give the first ones to the pool
+      FreeBlock *last = local.head;
+      for (size_t i = 1; i < blocksPerBatch; ++i) { last = last->next; }
+      FreeBlock *kept = last->next;
+      last->next = nullptr;
+      instance().giveBatch(local.head, blocksPerBatch);
+      local.head = kept;
+      local.nbBlocks -= blocksPerBatch;
+    }
+    local.head = new(block) FreeBlock{local.head};
+    ++local.nbBlocks;
+  }
+
+  /// \brief Get the number of blocks carved from the heap
+  /// \return Number of blocks
+  static size_t getNbBlocks() { return instance()._nbBlocks.load(); }
+
+  /// \brief Get the number of free blocks held by the calling thread
+  /// \return Number of free blocks of the thread
+  static size_t getNbLocalFreeBlocks() { return localBlocks().nbBlocks; }
+
+ private:
+  /// \struct FreeBlock
+  /// \brief Free block, holding the next free block
+  struct FreeBlock {
+    FreeBlock *next;                  ///< Next free block, nullptr if last
+  };
+
+  /// \struct LocalBlocks
+  /// \brief Free blocks of a thread, given to the pool when the thread exits
+  struct LocalBlocks {
+    /// \brief LocalBlocks destructor, give the blocks to the pool
+    ~LocalBlocks() {
+      if (head != nullptr) { instance().giveBatch(head, nbBlocks); }
+    }
+
+    FreeBlock *
+        head = nullptr;               ///< First free block
+    size_t
+        nbBlocks = 0;                 ///< Number of free blocks
+  };
+
+  /// \brief Private RequestPool constructor, the pool is created by instance()
+  RequestPool() = default;
+
+  /// \brief Private function. Get the pool of the process
+  /// \details The pool is never destroyed, the threads exiting after the
+  /// static destructors giving it their blocks.
+  /// \return The pool
+  static RequestPool &instance() {
+    static auto pool = new RequestPool();
+    return *pool;
+  }
+
+  /// \brief Private function. Get the free blocks of the calling thread
+  /// \return Free blocks of the thread
+  static LocalBlocks &localBlocks() {
+    static thread_local LocalBlocks local;
+    return local;
+  }
+
+  /// \brief Private function. Take a batch of free blocks, carved from the
+  /// heap if the pool has none
+  /// \param nbBlocks Set to the number of blocks in the batch
+  /// \return First block of the batch
+  FreeBlock *takeBatch(size_t &nbBlocks) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_batches.empty()) {
+        auto batch = _batches.back();
+        _batches.pop_back();
+        nbBlocks = batch.second;
+        return batch.first;
+      }
+    }
+    auto blocks = static_cast<char *>(
+        ::operator new(BlockSize * blocksPerBatch));
+    FreeBlock *head = nullptr;
+    for (size_t i = blocksPerBatch; i > 0; --i) {
+      head = new(blocks + (i - 1) * BlockSize) FreeBlock{head};
+    }
+    _nbBlocks += blocksPerBatch;
+    nbBlocks = blocksPerBatch;
+    return head;
+  }
+
+  /// \brief Private function. Give a batch of free blocks to the pool
+  /// \param head First block of the batch
+  /// \param nbBlocks Number of blocks in the batch
+  void giveBatch(FreeBlock *head, size_t nbBlocks) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _batches.emplace_back(head, nbBlocks);
+  }
+
+  std::mutex
+      _mutex;                         ///< Batches mutex
+
+  std::vector<std::pair<FreeBlock *, size_t>>
+      _batches;                       ///< Batches of free blocks, with their
+                                      ///< number of blocks
+
+  std::atomic<size_t>
+      _nbBlocks{0};                   ///< Number of blocks carved
+};
+
+/**
+  * @class PoolAllocator RequestPool.h <FastImage/memory/RequestPool.h>
+  *
+  * @brief Standard allocator taking its memory from the fi::RequestPool of
+  * the size of T.
+  *
+  * @details Given to std::allocate_shared, which rebinds it to its control
+  * block holding the object. The allocator is stateless, copying it costs
+  * nothing. An allocation of more than one object, or of an over-aligned
+  * type, is made on the heap.
+  *
+  * @tparam T Type allocated
+  **/
+template<typename T>
+class PoolAllocator {
+ public:
+  using value_type = T; ///< Type allocated
+
+  /// \brief Pool of the blocks holding a T
+  using Pool = RequestPool<(sizeof(T) + alignof(std::max_align_t) - 1)
+      / alignof(std::max_align_t) * alignof(std::max_align_t)>;
+
+  /// \brief PoolAllocator default constructor
+  PoolAllocator() = default;
+
+  /// \brief PoolAllocator copy constructor from an allocator of another type
+  /// \tparam U Type allocated by the other allocator
+  template<typename U>
+  PoolAllocator(const PoolAllocator<U> &) {}
+
+  /// \brief Allocate memory for n objects
+  /// \param n Number of objects
+  /// \return Memory allocated
+  T *allocate(size_t n) {
+    if (n == 1 && alignof(T) <= alignof(std::max_align_t)) {
+      return static_cast<T *>(Pool::allocate());
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  /// \brief Deallocate the memory of n objects
+  /// \param p Memory to deallocate
+  /// \param n Number of objects
+  void deallocate(T *p, size_t n) {
+    if (n == 1 && alignof(T) <= alignof(std::max_align_t)) {
+      Pool::deallocate(p);
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  /// \brief Equality operator, the allocators share the pools
+  /// \tparam U Type allocated by the other allocator
+  /// \return True
+  template<typename U>
+  bool operator==(const PoolAllocator<U> &) const { return true; }
+
+  /// \brief Inequality operator
+  /// \tparam U Type allocated by the other allocator
+  /// \return False
+  template<typename U>
+  bool operator!=(const PoolAllocator<U> &) const { return false; }
+};
+
+/// \brief Create an object held by a std::shared_ptr, the object and the
+/// control block placed in a block of a fi::RequestPool
+/// \tparam T Type of the object
+/// \tparam Args Types of the constructor arguments
+/// \param args Constructor arguments
+/// \return Object created
+template<typename T, typename ...Args>
+std::shared_ptr<T> makePooled(Args &&...args) {
+  return std::allocate_shared<T>(PoolAllocator<T>(),
+                                 std::forward<Args>(args)...);
+}
+}
+
+#endif //FASTIMAGE_REQUESTPOOL_H
@@ -0,0 +1,233 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file TileArena.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Arena of aligned pixel buffers allocated in a single region
+
+#ifndef FASTIMAGE_TILEARENA_H
+#define FASTIMAGE_TILEARENA_H
+
+#include <sys/mman.h>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <mutex>
+#include <vector>
+#include <sstream>
+
+#include "FastImage/exception/FastImageException.h"
+#include "FastImage/object/NumaTopology.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class TileArena TileArena.h <FastImage/memory/TileArena.h>
+  *
+  * @brief Arena of pixel buffers of the same size, allocated in a single
+  * region.
+  *
+  * @details The buffers of a pool (the tiles of a cache shard, the views of a
+  * pyramid level) are carved from one anonymous mapping, each buffer aligned
+  * on a cache line (alignment bytes). The region is allocated with a single
+  * call, and the pages are only backed when first written.
+  *
+  * With huge pages, the region is first mapped with MAP_HUGETLB (needs huge
+  * pages reserved by the system), else mapped with regular pages and advised
+  * with MADV_HUGEPAGE for the transparent huge pages. The copy and compute
+  * kernels walking the buffers then need fewer TLB entries.
+  *
+  * When the region is exhausted (a cache growing after a resize), the buffers
+  * are allocated on the heap with the same alignment. The pixel type has to be
+  * trivial, the buffers are not initialized.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class TileArena {
+ public:
+  static constexpr size_t
+      alignment = 64,                   ///< Buffers alignment in bytes
+      hugePageSize = 2 * 1024 * 1024;   ///< Huge page size in bytes
+
+  /// \brief TileArena constructor, map the region
+  /// \param nbPixels Number of pixels of a buffer
+  /// \param nbBuffers Number of buffers in the region
+  /// \param hugePages True to back the region with huge pages
+  TileArena(size_t nbPixels, size_t nbBuffers, bool hugePages = false)
+      : _stride(roundUp(nbPixels * sizeof(UserType), alignment)),
+        _nbBuffers(nbBuffers) {
+    if (_nbBuffers == 0 || _stride == 0) { return; }
+    _regionBytes = roundUp(_stride * _nbBuffers,
+                           hugePages ? hugePageSize : (size_t) 4096);
+#ifdef MAP_HUGETLB
+    if (hugePages) {
+      _region = mmap(nullptr, _regionBytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      _hugeTLB = _region != MAP_FAILED;
+    }
+#endif
+    if (!_hugeTLB) {
+      _region = mmap(nullptr, _regionBytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (_region == MAP_FAILED) {
+        std::stringstream message;
+        message << "Tile Arena ERROR: The region of " << _regionBytes
+                << " bytes can not be mapped: " << strerror(errno) << ".";
+        std::string m = message.str();
+        throw (FastImageException(m));
+      }
+#ifdef MADV_HUGEPAGE
+      if (hugePages) { madvise(_region, _regionBytes, MADV_HUGEPAGE); }
+#endif
+    }
+    // The buffers are given in the region order
+    _freeBuffers.reserve(_nbBuffers);
+    for (size_t buffer = _nbBuffers; buffer > 0; --buffer) {
+      _freeBuffers.push_back(reinterpret_cast<UserType *>(
+          (uint8_t *) _region + (buffer - 1) * _stride));
+    }
+  }
+
+  /// \brief TileArena destructor, unmap the region
+  /// \details Every buffer of the region has to be deallocated before.
+  ~TileArena() {
+    if (_region != nullptr && _region != MAP_FAILED) {
+      munmap(_region, _regionBytes);
+    }
+  }
+
+  TileArena(const TileArena &) = delete;
+  TileArena &operator=(const TileArena &) = delete;
+
+  /// \brief Allocate a buffer, from the region if not exhausted, else from
+  /// the heap
+  /// \return Aligned buffer of nbPixels pixels
+  UserType *allocate() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_freeBuffers.empty()) {
+        UserType *buffer = _freeBuffers.back();
+        _freeBuffers.pop_back();
+        return buffer;
+      }
+    }
+    void *buffer = nullptr;
+    if (posix_memalign(&buffer, alignment, _stride) != 0) {
+      throw std::bad_alloc();
+    }
+    return reinterpret_cast<UserType *>(buffer);
+  }
+
+  /// \brief Deallocate a buffer allocated by the arena
+  /// \param buffer Buffer to deallocate
+  void deallocate(UserType *buffer) {
+    if (isInRegion(buffer)) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _freeBuffers.push_back(buffer);
+    } else {
+      free(buffer);
+    }
+  }
+
+  /// \brief Place the region on a NUMA node, before the buffers are written
+  /// \param node NUMA node index
+  /// \return True if the region has been bound, else False
+  bool bindToNumaNode(uint32_t node) {
+    return _regionBytes > 0
+        && NumaTopology::getInstance().bindMemory(_region, _regionBytes, node);
+  }
+
+  /// \brief Interleave the region on every NUMA node, before the buffers are
+  /// written
+  /// \return True if the region has been interleaved, else False
+  bool interleaveOnNumaNodes() {
+    return _regionBytes > 0
+        && NumaTopology::getInstance().interleaveMemory(_region, _regionBytes);
+  }
+
+  /// \brief Test if a buffer is in the region
+  /// \param buffer Buffer
+  /// \return True if the buffer is in the region, else False
+  bool isInRegion(const UserType *buffer) const {
+    auto address = (const uint8_t *) buffer;
+    return _region != nullptr && _region != MAP_FAILED
+        && address >= (const uint8_t *) _region
+        && address < (const uint8_t *) _region + _stride * _nbBuffers;
+  }
+
+  /// \brief Get the distance in bytes between two buffers of the region
+  /// \return Buffers stride
+  size_t getStride() const { return _stride; }
+
+  /// \brief Get the number of buffers of the region
+  /// \return Number of buffers of the region
+  size_t getNbBuffers() const { return _nbBuffers; }
+
+  /// \brief Get the region size in bytes
+  /// \return Region size
+  size_t getRegionBytes() const { return _regionBytes; }
+
+  /// \brief Test if the region is mapped with MAP_HUGETLB
+  /// \return True if the region is backed by reserved huge pages
+  bool isHugeTLB() const { return _hugeTLB; }
+
+ private:
+  /// \brief Private function. Round a value up to a multiple
+  /// \param value Value
+  /// \param multiple Multiple
+  /// \return Value rounded up
+  static size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  std::mutex
+      _mutex;                     ///< Free buffers mutex
+
+  std::vector<UserType *>
+      _freeBuffers;               ///< Buffers of the region not allocated
+
+  void *
+      _region = nullptr;          ///< Mapped region
+
+  size_t
+      _stride,                    ///< Distance between two buffers in bytes
+      _nbBuffers,                 ///< Number of buffers of the region
+      _regionBytes = 0;           ///< Region size in bytes
+
+  bool
+      _hugeTLB = false;           ///< True if mapped with MAP_HUGETLB
+};
+}
+
+#endif //FASTIMAGE_TILEARENA_H
@@ -38,8 +38,10 @@
 #ifndef FASTIMAGE_VIEWALLOCATOR_H
 #define FASTIMAGE_VIEWALLOCATOR_H
 
+#include <memory>
 #include <htgs/api/IMemoryAllocator.hpp>
 #include "../api/View.h"
+#include "TileArena.h"
 
 namespace fi {
 /// \namespace fi FastImage namespace
@@ -54,23 +56,37 @@ template<typename UserType>
 class ViewAllocator : public htgs::IMemoryAllocator<fi::View<UserType>> {
  public:
   /// \brief View allocator constructor
+  /// \details If the number of views is known, the views' pixels are
+  /// allocated in a single region (fi::TileArena).
   /// \param viewHeight View Height in pixel
   /// \param viewWidth View width in pixel
-  ViewAllocator(const uint32_t &viewHeight, const uint32_t &viewWidth) :
+  /// \param nbViews Number of views allocated, 0 to allocate each view on the
+  /// heap
+  /// \param hugePages True to back the views with huge pages
+  /// \param numaInterleave True to interleave the views on the NUMA nodes
+  ViewAllocator(const uint32_t &viewHeight, const uint32_t &viewWidth,
+                size_t nbViews = 0, bool hugePages = false,
+                bool numaInterleave = false) :
       htgs::IMemoryAllocator<fi::View<UserType>>(0),
-      _viewHeight(viewHeight), _viewWidth(viewWidth) {}
+      _viewHeight(viewHeight), _viewWidth(viewWidth) {
+    if (nbViews > 0) {
+      _arena = std::make_shared<TileArena<UserType>>(
+          (size_t) viewHeight * viewWidth, nbViews, hugePages);
+      if (numaInterleave) { _arena->interleaveOnNumaNodes(); }
+    }
+  }
 
   /// \brief Allocate the memory in a view
   /// \param size Bot used but needed by HTGS
   /// \return A new ViewData allocated
   View<UserType> *memAlloc(size_t size) override {
-    return new View<UserType>(_viewHeight, _viewWidth);
+    return new View<UserType>(_viewHeight, _viewWidth, _arena);
   }
 
   /// \brief Allocate the memory in a view
   /// \return A new ViewData allocated
   View<UserType> *memAlloc() override {
-    return new View<UserType>(_viewHeight, _viewWidth);
+    return new View<UserType>(_viewHeight, _viewWidth, _arena);
   }
 
   /// \brief Free a viewData
@@ -83,6 +99,9 @@ class ViewAllocator : public htgs::IMemoryAllocator<fi::View<UserType>> {
   uint32_t
       _viewHeight,   ///< View height
       _viewWidth;    ///< View Width
+
+  std::shared_ptr<TileArena<UserType>>
+      _arena;        ///< Arena of the views' pixels, shared with the views
 };
 }
 
@@ -0,0 +1,287 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file CacheBudget.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Memory budget shared by the caches of the pyramid levels
+
+#ifndef FASTIMAGE_CACHEBUDGET_H
+#define FASTIMAGE_CACHEBUDGET_H
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <sstream>
+#include <algorithm>
+
+#include "FastImage/object/FigCache.h"
+#include "FastImage/exception/FastImageException.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class CacheBudget CacheBudget.h <FastImage/object/CacheBudget.h>
+  *
+  * @brief Memory budget in bytes shared by the caches of the pyramid levels.
+  *
+  * @details The budget is first divided between the levels proportionally to
+  * their default working set, two rows of tiles, and what a level can not use
+  * (the whole level fits in its cache) is given to the other levels. Each
+  * level keeps at least its cache minimum (FigCache::getMinNbTilesCache), one
+  * tile per shard or the tiles pinned by the zero-copy views.
+  *
+  * The tile loaders count the tile accesses. Every rebalancePeriod accesses,
+  * the misses of each level since the last rebalance are compared: the level
+  * reading the most bytes from the disk receives a step of the budget
+  * (1/16th), taken from the level with the lowest miss rate, as long as that
+  * miss rate is lower than the receiver's one. The caches are resized while
+  * the graph runs (FigCache::resize).
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class CacheBudget {
+  /// \brief Budget state of a level's cache
+  struct Level {
+    FigCache<UserType> *cache;      ///< Level's cache
+    uint64_t tileBytes;             ///< Size of a tile in bytes
+    uint32_t
+        nbTiles,                    ///< Number of tiles cached
+        minTiles,                   ///< Minimum number of tiles cached
+        maxTiles,                   ///< Maximum number of tiles cached
+        lastHit,                    ///< Hits at the last rebalance
+        lastMiss;                   ///< Misses at the last rebalance
+  };
+
+ public:
+  /// \brief CacheBudget constructor
+  /// \param budgetBytes Memory budget for all the caches in bytes
+  /// \param rebalancePeriod Number of tile accesses between two rebalances
+  explicit CacheBudget(uint64_t budgetBytes, uint32_t rebalancePeriod = 1024)
+      : _budgetBytes(budgetBytes), _unassignedBytes(budgetBytes),
+        _rebalancePeriod(std::max(rebalancePeriod, (uint32_t) 1)),
+        _nbAccesses(0), _nbRebalances(0) {}
+
+  /// \brief Add the initialized cache of the next pyramid level
+  /// \param cache Level's cache
+  void addCache(FigCache<UserType> *cache) {
+    Level level{};
+    level.cache = cache;
+    level.tileBytes = cache->getTileBytes();
+    level.minTiles = cache->getMinNbTilesCache();
+    level.maxTiles = cache->getMaxNbTilesCache();
+    _levels.push_back(level);
+  }
+
+  /// \brief Divide the budget between the caches and resize them
+  /// \details Each level gets its minimum number of tiles, then the rest of
+  /// the budget is spread proportionally to the levels' working set, until
+  /// the remaining bytes do not fit a tile of any level not fully cached.
+  void distribute() {
+    uint64_t minBytes = 0;
+    for (auto &level : _levels) {
+      level.nbTiles = level.minTiles;
+      minBytes += level.minTiles * level.tileBytes;
+    }
+    if (minBytes > _budgetBytes) {
+      std::stringstream message;
+      message << "FigCache ERROR: The cache memory budget (" << _budgetBytes
+              << " bytes) is lower than the minimum needed by the caches ("
+              << minBytes << " bytes).";
+      std::string m = message.str();
+      throw (FastImageException(m));
+    }
+    _unassignedBytes = _budgetBytes - minBytes;
+
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      double totalWorkingSet = 0;
+      for (auto &level : _levels) {
+        if (level.nbTiles < level.maxTiles) {
+          totalWorkingSet += workingSet(level);
+        }
+      }
+      uint64_t toSpread = _unassignedBytes;
+      for (auto &level : _levels) {
+        if (level.nbTiles >= level.maxTiles) { continue; }
+        auto share = (uint64_t) ((double) toSpread * workingSet(level)
+            / totalWorkingSet);
+        // The last bytes are given tile by tile
+        share = std::max(share, level.tileBytes);
+        auto nbTiles = (uint32_t) std::min(
+            {(uint64_t) (level.maxTiles - level.nbTiles),
+             share / level.tileBytes, _unassignedBytes / level.tileBytes});
+        if (nbTiles > 0) {
+          level.nbTiles += nbTiles;
+          _unassignedBytes -= nbTiles * level.tileBytes;
+          progress = true;
+        }
+      }
+    }
+
+    for (auto &level : _levels) {
+      level.cache->resize(level.nbTiles);
+      auto hitMiss = level.cache->countHitMiss();
+      level.lastHit = hitMiss.first;
+      level.lastMiss = hitMiss.second;
+    }
+  }
+
+  /// \brief Count a tile access, and rebalance the budget every
+  /// rebalancePeriod accesses, thread safe
+  void tileAccessed() {
+    if (++_nbAccesses % _rebalancePeriod == 0) { rebalance(); }
+  }
+
+  /// \brief Move a step of the budget to the level reading the most bytes from
+  /// the disk, from the level with the lowest miss rate, thread safe
+  /// \details Skipped if an other thread is already rebalancing.
+  void rebalance() {
+    std::unique_lock<std::mutex> lock(_rebalanceMutex, std::try_to_lock);
+    if (!lock.owns_lock() || _levels.size() < 2) { return; }
+
+    std::vector<double> missRates(_levels.size(), 0), missBytes(
+        _levels.size(), 0);
+    for (size_t l = 0; l < _levels.size(); ++l) {
+      Level &level = _levels[l];
+      auto hitMiss = level.cache->countHitMiss();
+      uint32_t
+          hit = hitMiss.first - level.lastHit,
+          miss = hitMiss.second - level.lastMiss;
+      level.lastHit = hitMiss.first;
+      level.lastMiss = hitMiss.second;
+      if (hit + miss > 0) { missRates[l] = (double) miss / (hit + miss); }
+      missBytes[l] = (double) miss * level.tileBytes;
+    }
+
+    // The receiver reads the most bytes from the disk and can grow
+    size_t receiver = _levels.size();
+    for (size_t l = 0; l < _levels.size(); ++l) {
+      if (_levels[l].nbTiles < _levels[l].maxTiles && missBytes[l] > 0
+          && (receiver == _levels.size()
+              || missBytes[l] > missBytes[receiver])) {
+        receiver = l;
+      }
+    }
+    if (receiver == _levels.size()) { return; }
+    Level &to = _levels[receiver];
+
+    // The donor has the lowest miss rate and can shrink
+    size_t donor = _levels.size();
+    for (size_t l = 0; l < _levels.size(); ++l) {
+      if (l != receiver && _levels[l].nbTiles > _levels[l].minTiles
+          && missRates[l] < missRates[receiver]
+          && (donor == _levels.size() || missRates[l] < missRates[donor])) {
+        donor = l;
+      }
+    }
+
+    uint64_t
+        step = std::max(_budgetBytes / 16, to.tileBytes),
+        available = _unassignedBytes;
+    uint32_t donorTiles = 0;
+    if (available < step && donor != _levels.size()) {
+      Level &from = _levels[donor];
+      donorTiles = (uint32_t) std::min(
+          (uint64_t) (from.nbTiles - from.minTiles),
+          (step - available + from.tileBytes - 1) / from.tileBytes);
+      available += donorTiles * from.tileBytes;
+    }
+    auto receiverTiles = (uint32_t) std::min(
+        (uint64_t) (to.maxTiles - to.nbTiles), available / to.tileBytes);
+    if (receiverTiles == 0) { return; }
+
+    // The donor only gives the bytes used by the receiver
+    if (donorTiles > 0) {
+      Level &from = _levels[donor];
+      uint64_t needed = receiverTiles * to.tileBytes;
+      donorTiles = needed > _unassignedBytes ?
+                   (uint32_t) ((needed - _unassignedBytes + from.tileBytes - 1)
+                       / from.tileBytes) : 0;
+      from.nbTiles -= donorTiles;
+      _unassignedBytes += donorTiles * from.tileBytes;
+      from.cache->resize(from.nbTiles);
+    }
+    to.nbTiles += receiverTiles;
+    _unassignedBytes -= receiverTiles * to.tileBytes;
+    to.cache->resize(to.nbTiles);
+    ++_nbRebalances;
+  }
+
+  /// \brief Get the memory budget
+  /// \return Memory budget in bytes
+  uint64_t getBudgetBytes() const { return _budgetBytes; }
+
+  /// \brief Get the memory given to a level's cache
+  /// \param level Pyramid level
+  /// \return Memory given to the level's cache in bytes
+  uint64_t getCacheBytes(uint32_t level) {
+    std::lock_guard<std::mutex> lock(_rebalanceMutex);
+    return _levels[level].nbTiles * _levels[level].tileBytes;
+  }
+
+  /// \brief Get the number of rebalances which moved memory between the
+  /// levels
+  /// \return Number of rebalances
+  uint32_t getNbRebalances() const { return _nbRebalances; }
+
+ private:
+  /// \brief Private function. Get the default working set of a level in
+  /// bytes, two rows of tiles bounded by the level's size
+  /// \param level Level
+  /// \return Working set in bytes
+  static double workingSet(const Level &level) {
+    return (double) std::min(2 * level.cache->getNumTilesWidth(),
+                             level.maxTiles) * level.tileBytes;
+  }
+
+  std::vector<Level>
+      _levels;                ///< Budget state of each level's cache
+
+  std::mutex
+      _rebalanceMutex;        ///< Mutex held while rebalancing
+
+  uint64_t
+      _budgetBytes,           ///< Memory budget in bytes
+      _unassignedBytes;       ///< Bytes of the budget not given to a cache
+
+  uint32_t
+      _rebalancePeriod;       ///< Tile accesses between two rebalances
+
+  std::atomic<uint64_t>
+      _nbAccesses;            ///< Number of tile accesses counted
+
+  std::atomic<uint32_t>
+      _nbRebalances;          ///< Number of rebalances done
+};
+}
+#endif //FASTIMAGE_CACHEBUDGET_H
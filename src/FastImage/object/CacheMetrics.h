@@ -0,0 +1,313 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file CacheMetrics.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Metrics of a cache and its tile loaders
+
+#ifndef FASTIMAGE_CACHEMETRICS_H
+#define FASTIMAGE_CACHEMETRICS_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "FastImage/data/DataType.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class LatencyHistogram CacheMetrics.h <FastImage/object/CacheMetrics.h>
+  *
+  * @brief Histogram of durations in nanoseconds, in power of 2 buckets.
+  *
+  * @details The bucket b counts the durations in [2^b, 2^(b+1)[ ns, the
+  * bucket 0 the durations under 2 ns, and the last bucket the durations
+  * above. The percentiles are given by the upper bound of their bucket.
+  **/
+class LatencyHistogram {
+ public:
+  static constexpr uint32_t
+      nbBuckets = 40;                 ///< Number of buckets, up to ~18 min
+
+  /// \brief Get the bucket of a duration
+  /// \param duration Duration in ns
+  /// \return Bucket index
+  static uint32_t getBucket(uint64_t duration) {
+    uint32_t bucket = 0;
+    while (duration > 1 && bucket < nbBuckets - 1) {
+      duration >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  /// \brief Add durations to a bucket
+  /// \param bucket Bucket index
+  /// \param count Number of durations
+  /// \param total Sum of the durations in ns
+  void add(uint32_t bucket, uint64_t count, uint64_t total) {
+    _buckets[bucket] += count;
+    _count += count;
+    _total += total;
+  }
+
+  /// \brief Record a duration
+  /// \param duration Duration in ns
+  void record(uint64_t duration) { add(getBucket(duration), 1, duration); }
+
+  /// \brief Merge an other histogram into this one
+  /// \param histogram Histogram to merge
+  void merge(const LatencyHistogram &histogram) {
+    for (uint32_t bucket = 0; bucket < nbBuckets; ++bucket) {
+      _buckets[bucket] += histogram._buckets[bucket];
+    }
+    _count += histogram._count;
+    _total += histogram._total;
+  }
+
+  /// \brief Get the number of durations recorded
+  /// \return Number of durations recorded
+  uint64_t getCount() const { return _count; }
+
+  /// \brief Get the sum of the durations recorded
+  /// \return Sum of the durations in ns
+  uint64_t getTotal() const { return _total; }
+
+  /// \brief Get the mean duration
+  /// \return Mean duration in ns, 0 if none recorded
+  double getMean() const {
+    return _count == 0 ? 0 : (double) _total / _count;
+  }
+
+  /// \brief Get a percentile of the durations
+  /// \param percentile Percentile, between 0 and 1
+  /// \return Upper bound in ns of the bucket holding the percentile, 0 if
+  /// none recorded
+  uint64_t getPercentile(double percentile) const {
+    if (_count == 0) { return 0; }
+    auto rank = (uint64_t) (percentile * (double) _count);
+    uint64_t count = 0;
+    for (uint32_t bucket = 0; bucket < nbBuckets; ++bucket) {
+      count += _buckets[bucket];
+      if (count > rank || count == _count) {
+        return ((uint64_t) 1) << (bucket + 1);
+      }
+    }
+    return ((uint64_t) 1) << nbBuckets;
+  }
+
+  /// \brief Get the number of durations per bucket
+  /// \return Number of durations per bucket
+  const std::array<uint64_t, nbBuckets> &getBuckets() const {
+    return _buckets;
+  }
+
+ private:
+  std::array<uint64_t, nbBuckets>
+      _buckets{};                     ///< Number of durations per bucket
+
+  uint64_t
+      _count = 0,                     ///< Number of durations
+      _total = 0;                     ///< Sum of the durations in ns
+};
+
+/**
+  * @struct CacheMetrics CacheMetrics.h <FastImage/object/CacheMetrics.h>
+  *
+  * @brief Snapshot of the metrics of a pyramid level's cache and its tile
+  * loaders.
+  **/
+struct CacheMetrics {
+  uint32_t
+      level = 0;                      ///< Pyramid level
+
+  uint64_t
+      hits = 0,                       ///< Tiles found in the cache
+      misses = 0,                     ///< Tiles not in the cache
+      evictions = 0,                  ///< Tiles evicted from the cache
+      reloads = 0,                    ///< Misses on a tile already cached
+                                      ///< before
+      inFlightWaits = 0;              ///< Hits waiting for the tile being
+                                      ///< loaded by an other loader
+
+  LatencyHistogram
+      lookup,                         ///< Time to get a tile from the cache
+      diskRead,                       ///< Time to read a tile from the file
+      decode,                         ///< Time to decode a tile
+      copy;                           ///< Time to copy a tile to a view
+
+  /// \brief Get the hit rate
+  /// \return Hit rate, between 0 and 1, 0 if no access
+  double getHitRate() const {
+    return hits + misses == 0 ? 0 : (double) hits / (hits + misses);
+  }
+};
+
+/**
+  * @class MetricsRecorder CacheMetrics.h <FastImage/object/CacheMetrics.h>
+  *
+  * @brief Records the latencies and the in-flight waits with per-thread
+  * counters, merged on read.
+  *
+  * @details Each thread recording gets its own counters, only written by
+  * the thread with relaxed atomic operations, without lock nor shared cache
+  * line. The counters are registered in the recorder the first time the
+  * thread records, and merged when a snapshot is read. The thread counters
+  * are kept until the recorder and the thread are destroyed.
+  **/
+class MetricsRecorder {
+ public:
+  /// \brief MetricsRecorder constructor
+  MetricsRecorder() : _id(nextId()) {}
+
+  /// \brief Record a duration
+  /// \param latencyType Stage timed
+  /// \param duration Duration in ns
+  void recordLatency(LatencyType latencyType, uint64_t duration) {
+    ThreadCounters &counters = getThreadCounters();
+    auto type = (size_t) latencyType;
+    increment(counters.buckets[type][LatencyHistogram::getBucket(duration)],
+              1);
+    increment(counters.totals[type], duration);
+  }
+
+  /// \brief Record a wait for a tile being loaded by an other thread
+  void recordInFlightWait() {
+    increment(getThreadCounters().inFlightWaits, 1);
+  }
+
+  /// \brief Get the histogram of a stage, merged from the threads
+  /// \param latencyType Stage timed
+  /// \return Histogram of the durations
+  LatencyHistogram getHistogram(LatencyType latencyType) {
+    LatencyHistogram histogram;
+    auto type = (size_t) latencyType;
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    for (auto &counters : _threads) {
+      for (uint32_t bucket = 0; bucket < LatencyHistogram::nbBuckets;
+           ++bucket) {
+        histogram.add(bucket,
+                      counters->buckets[type][bucket].load(
+                          std::memory_order_relaxed), 0);
+      }
+      histogram.add(0, 0,
+                    counters->totals[type].load(std::memory_order_relaxed));
+    }
+    return histogram;
+  }
+
+  /// \brief Get the number of waits for a tile being loaded, merged from
+  /// the threads
+  /// \return Number of in-flight waits
+  uint64_t getNbInFlightWaits() {
+    uint64_t waits = 0;
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    for (auto &counters : _threads) {
+      waits += counters->inFlightWaits.load(std::memory_order_relaxed);
+    }
+    return waits;
+  }
+
+ private:
+  static constexpr size_t
+      nbLatencyTypes = 4;             ///< Number of stages timed
+
+  /// \brief Counters of a thread
+  struct ThreadCounters {
+    std::atomic<uint64_t>
+        buckets[nbLatencyTypes][LatencyHistogram::nbBuckets]{}, ///< Durations
+                                      ///< per stage and bucket
+        totals[nbLatencyTypes]{},     ///< Sum of the durations per stage
+        inFlightWaits{};              ///< Number of in-flight waits
+  };
+
+  /// \brief Private function. Get a new recorder id, never reused
+  /// \return New recorder id
+  static uint64_t nextId() {
+    static std::atomic<uint64_t> id(0);
+    return id++;
+  }
+
+  /// \brief Private function. Increment a counter only written by the
+  /// calling thread
+  /// \param counter Counter to increment
+  /// \param value Value to add
+  static void increment(std::atomic<uint64_t> &counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  /// \brief Private function. Get the counters of the calling thread,
+  /// registered in the recorder the first time
+  /// \return Counters of the calling thread
+  ThreadCounters &getThreadCounters() {
+    thread_local uint64_t lastId = UINT64_MAX;
+    thread_local ThreadCounters *lastCounters = nullptr;
+    thread_local std::unordered_map<uint64_t, std::shared_ptr<ThreadCounters>>
+        threadCounters;
+    if (lastId == _id) { return *lastCounters; }
+
+    auto found = threadCounters.find(_id);
+    if (found == threadCounters.end()) {
+      // Drop the counters of the recorders destroyed
+      for (auto it = threadCounters.begin(); it != threadCounters.end();) {
+        if (it->second.use_count() == 1) { it = threadCounters.erase(it); }
+        else { ++it; }
+      }
+      auto counters = std::make_shared<ThreadCounters>();
+      {
+        std::lock_guard<std::mutex> lock(_threadsMutex);
+        _threads.push_back(counters);
+      }
+      found = threadCounters.emplace(_id, counters).first;
+    }
+    lastId = _id;
+    lastCounters = found->second.get();
+    return *lastCounters;
+  }
+
+  std::vector<std::shared_ptr<ThreadCounters>>
+      _threads;                       ///< Counters of the threads recording
+
+  std::mutex
+      _threadsMutex;                  ///< Mutex protecting _threads
+
+  uint64_t
+      _id;                            ///< Recorder id
+};
+}
+
+#endif //FASTIMAGE_CACHEMETRICS_H
@@ -0,0 +1,186 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file CacheRegistry.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Process-wide registry of the caches shared between the FastImage
+
+#ifndef FASTIMAGE_CACHEREGISTRY_H
+#define FASTIMAGE_CACHEREGISTRY_H
+
+#include <climits>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <functional>
+
+#include "FastImage/object/FigCache.h"
+#include "FastImage/object/CacheBudget.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class CacheRegistry CacheRegistry.h <FastImage/object/CacheRegistry.h>
+  *
+  * @brief Process-wide registry of the caches, shared by the FastImage opened
+  * on the same file.
+  *
+  * @details There is one registry per UserType. The caches are keyed by the
+  * file canonical path, the pyramid level, the tile size and the decoding
+  * identity (ATileLoader::getDecodeIdentity), and the memory budgets by the
+  * file canonical path and the decoding identity: the FastImage decoding
+  * the tiles differently get their own caches. The registry only keeps weak
+  * references: the caches and the budgets are owned by the FastImage using
+  * them, and deleted when the last one releases them.
+  *
+  * The first FastImage asking for a cache creates it, with its own options
+  * (number of tiles, shards, eviction policy, tiers). The next ones use the
+  * cache as it is, grown to their minimum number of tiles if needed.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class CacheRegistry {
+ public:
+  /// \brief Get the registry of the UserType
+  /// \return The process-wide registry
+  static CacheRegistry &getInstance() {
+    static CacheRegistry registry;
+    return registry;
+  }
+
+  /// \brief Get the cache of a file's level, created if not registered
+  /// \details A registered cache holding less than minNbTilesPerShard tiles
+  /// per shard is grown to it.
+  /// \param filePath Image file path
+  /// \param level Pyramid level
+  /// \param tileHeight Tile's height
+  /// \param tileWidth Tile's width
+  /// \param decodeIdentity Identity of the decoding, from
+  /// ATileLoader::getDecodeIdentity
+  /// \param minNbTilesPerShard Minimum number of tiles per shard needed by
+  /// the caller
+  /// \param createCache Function creating and initializing the cache
+  /// \return The shared cache
+  std::shared_ptr<FigCache<UserType>> getCache(
+      const std::string &filePath, uint32_t level,
+      uint32_t tileHeight, uint32_t tileWidth,
+      const std::string &decodeIdentity, uint32_t minNbTilesPerShard,
+      const std::function<FigCache<UserType> *()> &createCache) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto &registered = _caches[std::make_tuple(canonicalPath(filePath), level,
+                                               tileHeight, tileWidth,
+                                               decodeIdentity)];
+    auto cache = registered.lock();
+    if (!cache) {
+      cache = std::shared_ptr<FigCache<UserType>>(createCache());
+      registered = cache;
+    }
+    uint32_t minNbTilesCache = minNbTilesPerShard * cache->getNbShards();
+    if (cache->getMinNbTilesCache() < minNbTilesCache) {
+      cache->setMinNbTilesCache(minNbTilesCache);
+      cache->resize(cache->getNbTilesCache());
+    }
+    return cache;
+  }
+
+  /// \brief Get the memory budget of a file's caches, created if not
+  /// registered
+  /// \param filePath Image file path
+  /// \param decodeIdentity Identity of the decoding, from
+  /// ATileLoader::getDecodeIdentity
+  /// \param createBudget Function creating and distributing the budget
+  /// \return The shared memory budget
+  std::shared_ptr<CacheBudget<UserType>> getCacheBudget(
+      const std::string &filePath, const std::string &decodeIdentity,
+      const std::function<CacheBudget<UserType> *()> &createBudget) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto &registered =
+        _budgets[std::make_pair(canonicalPath(filePath), decodeIdentity)];
+    auto budget = registered.lock();
+    if (!budget) {
+      budget = std::shared_ptr<CacheBudget<UserType>>(createBudget());
+      registered = budget;
+    }
+    return budget;
+  }
+
+  /// \brief Get the number of caches in use, and forget the released ones
+  /// \return Number of caches in use
+  size_t getNbCaches() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _caches.begin(); it != _caches.end();) {
+      if (it->second.expired()) { it = _caches.erase(it); } else { ++it; }
+    }
+    for (auto it = _budgets.begin(); it != _budgets.end();) {
+      if (it->second.expired()) { it = _budgets.erase(it); } else { ++it; }
+    }
+    return _caches.size();
+  }
+
+ private:
+  /// \brief Default constructor, the registry is only accessed through
+  /// getInstance()
+  CacheRegistry() = default;
+
+  /// \brief Get the canonical path of a file, to find its caches whatever
+  /// the path used to open it
+  /// \param filePath File path
+  /// \return Canonical path, or the path given if it can not be resolved
+  static std::string canonicalPath(const std::string &filePath) {
+    char absolutePath[PATH_MAX];
+    if (realpath(filePath.c_str(), absolutePath) == nullptr) {
+      return filePath;
+    }
+    return std::string(absolutePath);
+  }
+
+  std::mutex
+      _mutex;                         ///< Registry mutex
+
+  std::map<std::tuple<std::string, uint32_t, uint32_t, uint32_t,
+                      std::string>,
+           std::weak_ptr<FigCache<UserType>>>
+      _caches;                        ///< Caches per file path, level, tile
+                                      ///< size and decoding
+
+  std::map<std::pair<std::string, std::string>,
+           std::weak_ptr<CacheBudget<UserType>>>
+      _budgets;                       ///< Memory budgets per file path and
+                                      ///< decoding
+};
+}
+
+#endif //FASTIMAGE_CACHEREGISTRY_H
@@ -0,0 +1,205 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file CacheSimulator.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Offline simulation of the cache hit rate for a traversal
+
+#ifndef FASTIMAGE_CACHESIMULATOR_H
+#define FASTIMAGE_CACHESIMULATOR_H
+
+#include <deque>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "FastImage/data/DataType.h"
+#include "FastImage/data/ViewRequestData.h"
+#include "FastImage/object/FigCache.h"
+#include "FastImage/object/Traversal.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class CacheSimulator CacheSimulator.h <FastImage/object/CacheSimulator.h>
+  *
+  * @brief Offline simulator of the cache hit rate, replaying a traversal of
+  * the image against a cache model.
+  *
+  * @details The tile accesses are the tiles of each view (central tile and
+  * radius), in the traversal order and in the order the ViewLoader asks them.
+  * They are replayed against a fi::FigCache of 1 pixel tiles using the
+  * eviction policy and the number of shards of the real cache, each shard
+  * evicting its own tiles, the tiles being loaded instantly. The tile loaders
+  * are modeled by keeping the last nbTileLoaders tiles accessed pinned, as
+  * the tiles being copied into the views can not be evicted.
+  *
+  * The miss-ratio curve gives the miss ratio of a list of cache sizes, and
+  * findCacheSize the smallest cache reaching a hit rate, by a binary search
+  * over the cache sizes (the hit rate growing with the cache size).
+  *
+  * @code
+  * fi::CacheSimulator simulator(imageHeight, imageWidth, tileHeight,
+  *                              tileWidth, radius, fi::TraversalType::SNAKE,
+  *                              nbTileLoaders, fi::EvictionPolicyType::LRU,
+  *                              nbShards);
+  * auto curve = simulator.getMissRatioCurve({16, 32, 64, 128});
+  * uint32_t nbTilesToCache = simulator.findCacheSize(0.85);
+  * @endcode
+  **/
+class CacheSimulator {
+ public:
+  /// \brief CacheSimulator constructor, generate the tile accesses
+  /// \param imageHeight Image height
+  /// \param imageWidth Image width
+  /// \param tileHeight Tile height
+  /// \param tileWidth Tile width
+  /// \param radius View radius in pixels
+  /// \param traversalType Traversal of the views
+  /// \param nbTileLoaders Number of tile loader threads
+  /// \param evictionPolicy Eviction policy of the cache
+  /// \param nbShards Number of shards of the cache
+  CacheSimulator(uint32_t imageHeight, uint32_t imageWidth,
+                 uint32_t tileHeight, uint32_t tileWidth,
+                 uint32_t radius,
+                 TraversalType traversalType,
+                 uint32_t nbTileLoaders = 1,
+                 EvictionPolicyType evictionPolicy = EvictionPolicyType::LRU,
+                 uint32_t nbShards = 1)
+      : _numTilesHeight((imageHeight + tileHeight - 1) / tileHeight),
+        _numTilesWidth((imageWidth + tileWidth - 1) / tileWidth),
+        _nbTileLoaders(std::max(nbTileLoaders, (uint32_t) 1)),
+        _nbShards(std::max(nbShards, (uint32_t) 1)),
+        _evictionPolicy(evictionPolicy) {
+    Traversal traversal(traversalType, _numTilesHeight, _numTilesWidth);
+    for (const auto &step : traversal.getTraversal()) {
+      ViewRequestData<uint8_t> view(
+          step.first, step.second, _numTilesHeight, _numTilesWidth, radius,
+          tileHeight, tileWidth, imageHeight, imageWidth, 0);
+      for (uint32_t r = view.getIndexRowMinTile();
+           r < view.getIndexRowMaxTile(); ++r) {
+        for (uint32_t c = view.getIndexColMinTile();
+             c < view.getIndexColMaxTile(); ++c) {
+          _accesses.emplace_back(r, c);
+        }
+      }
+    }
+  }
+
+  /// \brief Get the number of tiles in the image
+  /// \return Number of tiles in the image
+  uint32_t getNbTiles() const { return _numTilesHeight * _numTilesWidth; }
+
+  /// \brief Get the number of tile accesses of the traversal
+  /// \return Number of tile accesses
+  size_t getNbAccesses() const { return _accesses.size(); }
+
+  /// \brief Replay the tile accesses against a cache
+  /// \param nbTilesToCache Number of tiles cached, between 1 and the number
+  /// of tiles in the image
+  /// \return Hit rate, between 0 and 1
+  double simulate(uint32_t nbTilesToCache) const {
+    if (_accesses.empty()) { return 1; }
+    nbTilesToCache = std::min(std::max(nbTilesToCache, (uint32_t) 1),
+                              getNbTiles());
+    FigCache<uint8_t> cache(nbTilesToCache, _nbShards, _evictionPolicy);
+    cache.initCache(_numTilesHeight, _numTilesWidth, 1, 1);
+    if (cache.needsFutureAccesses()) {
+      for (const auto &access : _accesses) {
+        cache.addFutureAccess(access.first, access.second);
+      }
+    }
+
+    // The tiles held by the tile loaders, at least one tile is left free in
+    // the smallest shard
+    size_t nbPinned = std::min(
+        _nbTileLoaders, nbTilesToCache / cache.getNbShards() - 1);
+    std::deque<CachedTile<uint8_t> *> pinned;
+    uint64_t position = 0;
+    for (const auto &access : _accesses) {
+      auto tile = cache.getPinnedTile(access.first, access.second, position++);
+      if (tile->beginLoading()) { tile->setReady(); }
+      pinned.push_back(tile);
+      if (pinned.size() > nbPinned) {
+        pinned.front()->release();
+        pinned.pop_front();
+      }
+    }
+    for (auto tile : pinned) { tile->release(); }
+    return (double) cache.getHitMissCache().first / _accesses.size();
+  }
+
+  /// \brief Get the miss-ratio curve
+  /// \param cacheSizes Numbers of tiles cached to simulate
+  /// \return Pairs (number of tiles cached, miss ratio)
+  std::vector<std::pair<uint32_t, double>> getMissRatioCurve(
+      const std::vector<uint32_t> &cacheSizes) const {
+    std::vector<std::pair<uint32_t, double>> curve;
+    for (auto cacheSize : cacheSizes) {
+      curve.emplace_back(cacheSize, 1 - simulate(cacheSize));
+    }
+    return curve;
+  }
+
+  /// \brief Find the smallest cache reaching a hit rate
+  /// \details The hit rate is bounded by the first accesses to each tile, if
+  /// the hit rate can not be reached the whole image is cached.
+  /// \param targetHitRate Hit rate to reach, between 0 and 1
+  /// \return Smallest number of tiles cached reaching the hit rate
+  uint32_t findCacheSize(double targetHitRate) const {
+    uint32_t
+        low = 1,
+        high = getNbTiles();
+    if (high <= 1 || simulate(high) < targetHitRate) { return high; }
+    while (low < high) {
+      uint32_t middle = low + (high - low) / 2;
+      if (simulate(middle) >= targetHitRate) { high = middle; }
+      else { low = middle + 1; }
+    }
+    return low;
+  }
+
+ private:
+  std::vector<std::pair<uint32_t, uint32_t>>
+      _accesses;                      ///< Tile accesses of the traversal
+
+  uint32_t
+      _numTilesHeight,                ///< Number of tiles in a column
+      _numTilesWidth,                 ///< Number of tiles in a row
+      _nbTileLoaders,                 ///< Number of tile loader threads
+      _nbShards;                      ///< Number of shards of the cache
+
+  EvictionPolicyType
+      _evictionPolicy;                ///< Eviction policy of the cache
+};
+}
+
+#endif //FASTIMAGE_CACHESIMULATOR_H
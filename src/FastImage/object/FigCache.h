@@ -41,12 +41,19 @@
 #include <sstream>
 #include <unordered_map>
 #include <list>
+#include <memory>
 #include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <limits>
 
 #include "../../FastImage/exception/FastImageException.h"
 #include "FastImage/data/CachedTile.h"
+#include "FastImage/object/FigCacheShard.h"
+#include "FastImage/object/NumaTopology.h"
+#include "FastImage/object/CacheMetrics.h"
 #include "../data/DataType.h"
 
 namespace fi {
@@ -58,10 +65,36 @@ namespace fi {
   * @brief Fast Image cache.
   *
   * @details Fast Image cache, which is used to limit the image IO. Is uses a
-  * LRU policy. The amount of cached tiles is set up at construction.
+  * LRU policy by default, or an other eviction policy (fi::EvictionPolicyType)
+  * chosen at construction. The amount of cached tiles is set up at
+  * construction.
   * The cached tiles are saved into a matrix which has the same dimension as the
   * image.
   *
+  * The cache mutex is only held to update the cache index. The tiles handed
+  * out are pinned, so they can not be recycled while in use. A loader asking
+  * for a tile still being read from the disk by another loader only waits on
+  * that tile, once loaded the tile is read by all the loaders at the same
+  * time (fi::CachedTile).
+  *
+  * The cache can be split into shards (fi::FigCacheShard), each with its own
+  * mutex, eviction policy and part of the tiles to cache. The tiles are
+  * distributed between the shards by hashing their (row, col) index, so
+  * neighbouring tiles, often asked at the same time, fall in different shards.
+  *
+  * In NUMA mode (setNumaNodes), the shards are split evenly between the
+  * nodes, each shard's tiles being allocated on its node. A tile is then
+  * cached by the shards of the node owning its column band
+  * (NumaTopology::getTileNode).
+  *
+  * The number of tiles cached can be changed at runtime with resize, to share a
+  * memory budget between the pyramid levels (fi::CacheBudget).
+  *
+  * Second level tiers (fi::ACacheTier) can be added to keep the tiles
+  * recycled, or all the tiles loaded for the persistent tiers. A tile
+  * missing from the cache is then fetched from the first tier holding it,
+  * before being loaded from the file (loadFromTier).
+  *
   * @tparam UserType Pixel Type asked by the end user
   **/
 template<typename UserType>
@@ -70,51 +103,50 @@ class FigCache {
  public:
   /// \brief AnyTileCache constructor
   /// \param nbTilesToCache Number of tiles to cache
-  explicit FigCache(uint32_t nbTilesToCache)
-      : _timeGet(0.0), _timeRecycle(0.0), _timeDisk(0.0),
-        _nbTilesCache(nbTilesToCache), _miss(0), _hit(0),
-        _numTilesHeight(0), _numTilesWidth(0) {}
+  /// \param nbShards Number of shards the cache is split into
+  /// \param evictionPolicy Eviction policy used by each shard
+  explicit FigCache(uint32_t nbTilesToCache, uint32_t nbShards = 1,
+                    EvictionPolicyType evictionPolicy =
+                    EvictionPolicyType::LRU)
+      : _nbFutureAccesses(0), _nbTilesCache(nbTilesToCache),
+        _nbShards(std::max(nbShards, (uint32_t) 1)),
+        _numTilesHeight(0), _numTilesWidth(0), _tileHeight(0), _tileWidth(0),
+        _evictionPolicy(evictionPolicy) {}
 
   /// \brief Default destructor
   virtual  ~FigCache() {
-
-    // Clean the pool
-    while (!_pool.empty()) {
-      auto tile = _pool.front();
-      _pool.pop();
-      delete tile;
-    }
-
     // Clean the matrix
     for (auto row = _mapCache.begin(); row != _mapCache.end(); ++row) {
       for (auto col = (*row).begin(); col != (*row).end(); ++col) {
         (*col) = nullptr;
       }
     }
-
-    // Clean the LRU and delete every stored tile in the cache system
-    for (auto itTile = _lru.begin(); itTile != _lru.end(); ++itTile) {
-      delete (*itTile);
-    }
+    // The shards delete every tile allocated
   };
 
   /// \brief Init the cache and allocate the cache's memory with the specified
   /// tile width and height from the files.
   /// \details The total number of tiles allocated by default is equal to
-  /// 2*numTilesWidth
+  /// 2*numTilesWidth. The number of shards is limited to the number of tiles
+  /// allocated, and the tiles are evenly distributed between the shards. The
+  /// tiles of a shard are allocated in a single region (fi::TileArena).
   /// \param numTilesHeight Number of tiles in a column
   /// \param numTilesWidth Number of tiles in a row
   /// \param tileHeight Tile's height
   /// \param tileWidth Tile's width
+  /// \param hugePages True to back the tiles with huge pages
   void initCache(uint32_t numTilesHeight,
                  uint32_t numTilesWidth,
                  uint32_t tileHeight,
-                 uint32_t tileWidth) {
+                 uint32_t tileWidth,
+                 bool hugePages = false) {
 
     uint32_t nbTilesInImage = numTilesHeight * numTilesWidth;
 
     _numTilesHeight = numTilesHeight;
     _numTilesWidth = numTilesWidth;
+    _tileHeight = tileHeight;
+    _tileWidth = tileWidth;
 
     // If the number of tiles to be cached has been set to 0 (default value),
     // set the number to 2 * number of tiles in a row
@@ -124,6 +156,19 @@ class FigCache {
     // the image, set it to the number of tiles in the image
     if (nbTilesInImage < _nbTilesCache) { _nbTilesCache = nbTilesInImage; }
 
+    // Each shard owns at least one tile
+    _nbShards = std::max(std::min(_nbShards, _nbTilesCache.load()),
+                         (uint32_t) 1);
+
+    // In NUMA mode, each node gets the same number of shards, at least one.
+    // The number of shards is rounded up to a multiple of the number of
+    // nodes, down if there are not enough tiles
+    _nbNumaNodes = std::max(std::min(_nbNumaNodes, _nbTilesCache.load()),
+                            (uint32_t) 1);
+    _nbShards = (std::max(_nbShards, _nbNumaNodes) + _nbNumaNodes - 1)
+        / _nbNumaNodes * _nbNumaNodes;
+    if (_nbShards > _nbTilesCache) { _nbShards -= _nbNumaNodes; }
+
     // Create the matrix
     for (uint32_t row = 0; row < numTilesHeight; ++row) {
       std::vector<CachedTileType> tempV;
@@ -133,12 +178,110 @@ class FigCache {
       _mapCache.push_back(tempV);
     }
 
-    // Fill the pool
-    for (uint32_t tileCnt = 0; tileCnt < _nbTilesCache; ++tileCnt) {
-      _pool.push(new CachedTile<UserType>(tileWidth, tileHeight));
+    // Create the shards and distribute the tiles
+    for (uint32_t shard = 0; shard < _nbShards; ++shard) {
+      _shards.emplace_back(
+          new FigCacheShard<UserType>(_mapCache, _evictionPolicy));
+      _shards.back()->initShard(
+          _nbTilesCache / _nbShards + (shard < _nbTilesCache % _nbShards),
+          tileHeight, tileWidth, numTilesWidth, hugePages,
+          _nbNumaNodes > 1 ?
+          (int32_t) (shard / (_nbShards / _nbNumaNodes)) : -1);
+      for (auto &tier : _tiers) { _shards.back()->addTier(tier.get()); }
     }
   };
 
+  /// \brief Set the number of NUMA nodes sharing the cache, before initCache
+  /// \details The number of nodes is limited to the number of tiles cached,
+  /// and the number of shards raised to at least one per node and rounded up
+  /// to a multiple of the number of nodes (down if there are not enough tiles
+  /// cached).
+  /// \param nbNumaNodes Number of NUMA nodes, 1 to disable the NUMA mode
+  void setNumaNodes(uint32_t nbNumaNodes) {
+    _nbNumaNodes = std::max(nbNumaNodes, (uint32_t) 1);
+  }
+
+  /// \brief Get the number of NUMA nodes sharing the cache
+  /// \return Number of NUMA nodes, 1 if not in NUMA mode
+  uint32_t getNbNumaNodes() const { return _nbNumaNodes; }
+
+  /// \brief Add a tier after the tiers already added, fetched in the same
+  /// order
+  /// \param tier Cache tier, owned by the cache
+  void addTier(std::unique_ptr<ACacheTier<UserType>> tier) {
+    _tiers.push_back(std::move(tier));
+    for (auto &shard : _shards) { shard->addTier(_tiers.back().get()); }
+  }
+
+  /// \brief Get a tier of the cache
+  /// \param tier Tier index, in the order added
+  /// \return Cache tier, nullptr if none
+  ACacheTier<UserType> *getTier(size_t tier = 0) const {
+    return tier < _tiers.size() ? _tiers[tier].get() : nullptr;
+  }
+
+  /// \brief Get the number of tiers
+  /// \return Number of tiers
+  size_t getNbTiers() const { return _tiers.size(); }
+
+  /// \brief Test if a tier holds a tile, thread safe
+  /// \details The result is a hint, as isCached.
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \return True if the cache has a tier holding the tile, else False
+  bool isInTier(uint32_t indexRow, uint32_t indexCol) {
+    for (auto &tier : _tiers) {
+      if (tier->contains(indexRow, indexCol)) { return true; }
+    }
+    return false;
+  }
+
+  /// \brief Fill a tile from the first tier holding it, thread safe
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \param tile Tile to fill
+  /// \return True if a tier held the tile and the tile has been filled,
+  /// else False
+  bool loadFromTier(uint32_t indexRow, uint32_t indexCol, UserType *tile) {
+    for (auto &tier : _tiers) {
+      if (tier->fetch(indexRow, indexCol, tile,
+                      (size_t) _tileHeight * _tileWidth)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// \brief Store a tile just loaded from the file in the tiers storing all
+  /// the tiles loaded (ACacheTier::storesLoadedTiles), thread safe
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile loaded
+  void tileLoaded(uint32_t indexRow, uint32_t indexCol, const UserType *tile) {
+    for (auto &tier : _tiers) {
+      if (tier->storesLoadedTiles()) {
+        tier->store(indexRow, indexCol, tile,
+                    (size_t) _tileHeight * _tileWidth);
+      }
+    }
+  }
+
+  /// \brief Change the number of tiles cached, thread safe
+  /// \details The number of tiles is bounded by the minimum number of tiles
+  /// (getMinNbTilesCache) and by the number of tiles in the image, and evenly
+  /// distributed between the shards. The tiles in use are only deleted once
+  /// released.
+  /// \param nbTilesToCache Number of tiles to cache
+  void resize(uint32_t nbTilesToCache) {
+    nbTilesToCache = std::min(std::max(nbTilesToCache, getMinNbTilesCache()),
+                              getMaxNbTilesCache());
+    for (uint32_t shard = 0; shard < _nbShards; ++shard) {
+      _shards[shard]->resize(
+          nbTilesToCache / _nbShards + (shard < nbTilesToCache % _nbShards));
+    }
+    _nbTilesCache = nbTilesToCache;
+  }
+
   /// \brief Test if the row, column tile is in the cache
   /// \param indexRow Tile row index asked
   /// \param indexCol Tile col index asked
@@ -147,13 +290,31 @@ class FigCache {
     return !(nullptr == _mapCache[indexRow][indexCol]);
   }
 
-  /// \brief Get a locked tile from the cache system
-  /// \details This function is thread safe as the cache will lock
-  /// prior to interacting with the cache.
+  /// \brief Test if the row, column tile is in the cache, thread safe
+  /// version of isInCache
+  /// \details The tile may be recycled or loaded by an other thread right
+  /// after the test, the result is a hint.
   /// \param indexRow Tile row index asked
   /// \param indexCol Tile col index asked
-  /// \return Get a locked tile
-  CachedTileType getLockedTile(uint32_t indexRow, uint32_t indexCol) {
+  /// \return True if the tile is in the cache, else False
+  bool isCached(uint32_t indexRow, uint32_t indexCol) {
+    return _shards[shardIndex(indexRow, indexCol)]->isCached(indexRow,
+                                                             indexCol);
+  }
+
+  /// \brief Get a pinned tile from the cache system
+  /// \details This function is thread safe as the tile's shard will lock
+  /// prior to interacting with the cache. The tile is not locked: the caller
+  /// loads it if CachedTile::beginLoading returns true, then reads it along
+  /// the other users, and releases it with CachedTile::release.
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \param position Position of the access in the sequence of accesses
+  /// registered with addFutureAccess, max uint64_t if not registered
+  /// \return A pinned tile
+  CachedTileType getPinnedTile(
+      uint32_t indexRow, uint32_t indexCol,
+      uint64_t position = std::numeric_limits<uint64_t>::max()) {
     if (!(indexRow >= 0 && indexRow < _numTilesHeight && indexCol >= 0
         && indexCol < _numTilesWidth)) {
       std::stringstream message;
@@ -163,63 +324,135 @@ class FigCache {
       std::string m = message.str();
       throw (FastImageException(m));
     }
-    CachedTileType tile;
-
-    this->lock();
     auto begin = std::chrono::high_resolution_clock::now();
-
-    if (isInCache(indexRow, indexCol)) {
-      // Tile is in cache
-      _hit += 1;
-      tile = getCachedLockedTile(indexRow, indexCol);
-    } else {
-      // Tile is not in the cache
-      _miss += 1;
-      if (_pool.empty()) { recycleTile(); }
-      tile = getNewLockedTile(indexRow, indexCol);
-    }
+    CachedTileType tile =
+        _shards[shardIndex(indexRow, indexCol)]->getPinnedTile(
+            indexRow, indexCol, position);
     auto end = std::chrono::high_resolution_clock::now();
-    _timeGet += std::chrono::duration_cast<std::chrono::nanoseconds>(
-        end - begin).count();
-    this->unlock();
+    _metricsRecorder.recordLatency(
+        LatencyType::LOOKUP,
+        (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end - begin).count());
+    return tile;
+  }
 
+  /// \brief Get a locked tile from the cache system, for an exclusive access
+  /// \details The shard lock is released before locking the tile, so waiting
+  /// for a locked tile does not block the access to the other tiles. The tile
+  /// is unlocked and released with CachedTile::unlock.
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \param position Position of the access in the sequence of accesses
+  /// registered with addFutureAccess, max uint64_t if not registered
+  /// \return Get a locked tile
+  CachedTileType getLockedTile(
+      uint32_t indexRow, uint32_t indexCol,
+      uint64_t position = std::numeric_limits<uint64_t>::max()) {
+    CachedTileType tile = getPinnedTile(indexRow, indexCol, position);
+    tile->lock();
     return tile;
   }
 
-  /// \brief Print cache statistics.
-  void printStats(double imgeSizeMBytes) {
-    std::cout
+  /// \brief Test if the eviction policy needs the future tile accesses
+  /// \return True if the future accesses have to be registered with
+  /// addFutureAccess, else False
+  bool needsFutureAccesses() const {
+    return !_shards.empty()
+        && _shards.front()->getPolicy().needsFutureAccesses();
+  }
+
+  /// \brief Register a future access to a tile, in the order the tiles will be
+  /// asked
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return Position of the access, to give to getPinnedTile
+  uint64_t addFutureAccess(uint32_t indexRow, uint32_t indexCol) {
+    uint64_t position = _nbFutureAccesses++;
+    _shards[shardIndex(indexRow, indexCol)]->addFutureAccess(
+        indexRow, indexCol, position);
+    return position;
+  }
+
+  /// \brief Print cache statistics, from a metrics snapshot
+  /// \param imgeSizeMBytes Image size in MB, to compute the disk throughput
+  /// \param os Output stream
+  void printStats(double imgeSizeMBytes, std::ostream &os = std::cout) {
+    CacheMetrics metrics = getMetrics();
+    double timeDisk = (double) metrics.diskRead.getTotal();
+    os
         << "CacheStats: " << std::endl
-        << "    hit = " << _hit
-        << " miss = " << _miss
-        << " ratio = " << (double) _hit / (double) (_hit + _miss) * 100 << " %"
+        << "    hit = " << metrics.hits
+        << " miss = " << metrics.misses
+        << " ratio = " << metrics.getHitRate() * 100 << " %"
+        << " evictions = " << metrics.evictions
+        << " reloads = " << metrics.reloads
+        << " in-flight waits = " << metrics.inFlightWaits
         << std::endl
         << "    time : Get " << std::scientific << std::setprecision(2)
-        << _timeGet
+        << getTimeGet()
         << "ns Recycle " << std::scientific << std::setprecision(2)
-        << _timeRecycle
-        << "ns Disk " << std::scientific << std::setprecision(2) << _timeDisk
+        << getTimeRecycle()
+        << "ns Disk " << std::scientific << std::setprecision(2) << timeDisk
         << "ns ("
-        << (imgeSizeMBytes / _timeDisk) * 10E9 << " MB/s)" << std::endl;
+        << (imgeSizeMBytes / timeDisk) * 1E9 << " MB/s)" << std::endl;
+  }
+
+  /// \brief Get a snapshot of the cache metrics, thread safe
+  /// \details The counters are read from the shards, and the latencies and
+  /// in-flight waits merged from the threads' counters (fi::MetricsRecorder).
+  /// The level is left to 0.
+  /// \return Snapshot of the cache metrics
+  CacheMetrics getMetrics() {
+    CacheMetrics metrics;
+    for (auto &shard : _shards) { shard->addMetrics(metrics); }
+    metrics.inFlightWaits = _metricsRecorder.getNbInFlightWaits();
+    metrics.lookup = _metricsRecorder.getHistogram(LatencyType::LOOKUP);
+    metrics.diskRead = _metricsRecorder.getHistogram(LatencyType::DISK_READ);
+    metrics.decode = _metricsRecorder.getHistogram(LatencyType::DECODE);
+    metrics.copy = _metricsRecorder.getHistogram(LatencyType::COPY);
+    return metrics;
+  }
+
+  /// \brief Record the duration of a tile access stage, thread safe
+  /// \param latencyType Stage timed
+  /// \param duration Duration in ns
+  void recordLatency(LatencyType latencyType, double duration) {
+    _metricsRecorder.recordLatency(latencyType, (uint64_t) duration);
   }
 
-  /// \brief Lock the cache.
-  void lock() { _cacheMutex.lock(); }
+  /// \brief Record a wait for a tile being loaded by an other tile loader,
+  /// thread safe
+  void recordInFlightWait() { _metricsRecorder.recordInFlightWait(); }
 
-  /// \brief Unlock the cache.
-  void unlock() { _cacheMutex.unlock(); }
+  /// \brief Lock the cache, i.e. every shard.
+  void lock() {
+    for (auto &shard : _shards) { shard->lock(); }
+  }
+
+  /// \brief Unlock the cache, i.e. every shard.
+  void unlock() {
+    for (auto &shard : _shards) { shard->unlock(); }
+  }
 
   /// Get the number of miss
   /// \return Number of miss
-  uint32_t getMiss() const { return _miss; }
+  uint32_t getMiss() const {
+    uint32_t miss = 0;
+    for (auto &shard : _shards) { miss += shard->getMiss(); }
+    return miss;
+  }
 
   /// Get the number of Hit
   /// \return Number of Hit
-  uint32_t getHit() const { return _hit; }
+  uint32_t getHit() const {
+    uint32_t hit = 0;
+    for (auto &shard : _shards) { hit += shard->getHit(); }
+    return hit;
+  }
 
-  /// \brief Add a duration to the disk time usage
-  /// \param time Duration to add
-  void addTimeDisk(double time) { _timeDisk += time; };
+  /// \brief Add a duration to the disk time usage, thread safe
+  /// \param time Duration to add in ns
+  void addTimeDisk(double time) { recordLatency(LatencyType::DISK_READ, time); }
 
   /// \brief Stream output operator for the cache
   /// \param os Output stream
@@ -228,8 +461,6 @@ class FigCache {
   friend std::ostream &operator<<(std::ostream &os, const FigCache &cache) {
     os << "-------------------------------------------" << std::endl;
     os << "Cache View:" << std::endl;
-    os << "Waiting Queue: " << std::endl;
-    print_queue(cache._pool);
     os << "MapCache: " << std::endl;
     for (auto row = cache._mapCache.begin(); row != cache._mapCache.end();
          ++row) {
@@ -238,20 +469,12 @@ class FigCache {
       }
       os << std::endl;
     }
-    os << "MapLRU: " << std::endl;
-    for (auto elem : cache._mapLRU)
-      os << "    " << elem.first << ": "
-         << std::distance(cache._lru.begin(), elem.second) << std::endl;
-
-    os << "ListLRU: " << std::endl;
-    for (auto elem : cache._lru)
-      os << elem << " ";
-    os << std::endl;
-    os << "timeGet: " << cache._timeGet << " / "
-       << "timeRelease: " << cache._timeRecycle << " / "
-       << "timeDisk: " << cache._timeDisk << " / "
-       << "nbTilesCache: " << cache._nbTilesCache << " / miss: " << cache._miss
-       << " / hit: " << cache._hit;
+    for (uint32_t shard = 0; shard < cache._shards.size(); ++shard) {
+      os << "Shard " << shard << ":" << std::endl << *(cache._shards[shard]);
+    }
+    os << "nbTilesCache: " << cache._nbTilesCache.load() << " / "
+       << "nbShards: " << cache._nbShards << " / miss: " << cache.getMiss()
+       << " / hit: " << cache.getHit();
     os << std::endl << "-------------------------------------------"
        << std::endl;
     return os;
@@ -263,134 +486,155 @@ class FigCache {
     return {this->getHit(), this->getMiss()};
   }
 
+  /// \brief Get the total number of Hits and misses from the cache, thread
+  /// safe version of getHitMissCache
+  /// \return pair<hit, miss>
+  std::pair<uint32_t, uint32_t> countHitMiss() {
+    std::pair<uint32_t, uint32_t> hitMiss(0, 0);
+    for (auto &shard : _shards) {
+      auto shardHitMiss = shard->countHitMiss();
+      hitMiss.first += shardHitMiss.first;
+      hitMiss.second += shardHitMiss.second;
+    }
+    return hitMiss;
+  }
+
   /// \brief Get the number of tiles allocated in the cache
   /// \return Tiles allocated in the cache
   uint32_t getNbTilesCache() const { return _nbTilesCache; }
 
-  /// \brief Get the pool of available tiles
-  /// \return Pool of available tiles
-  const std::queue<CachedTileType> &getPool() const { return _pool; }
-
-  /// \brief Get the map cache
-  /// \return The Map cache
-  const std::vector<std::vector<CachedTileType>> &getMapCache() const {
-    return _mapCache;
+  /// \brief Set the minimum number of tiles to cache, below which the cache is
+  /// never resized
+  /// \details Used by the zero-copy views, which keep their tiles pinned: each
+  /// shard needs a tile per view in parallel and per tile loader thread.
+  /// \param minNbTilesCache Minimum number of tiles to cache
+  void setMinNbTilesCache(uint32_t minNbTilesCache) {
+    _minNbTilesCache = minNbTilesCache;
   }
 
-  /// \brief Get LRU list
-  /// \return LRU list
-  const std::list<CachedTileType> &getLru() const { return _lru; }
-
- private:
-  /// \brief Private function. Get Least Recently Used Tiles, clean it, and put
-  /// it back in the pool.
-  void recycleTile() {
-    CachedTileType toRecycle;
-
-    auto begin = std::chrono::high_resolution_clock::now();
-
-    // Get LRU Tile
-    toRecycle = _lru.back();
-    toRecycle->lock();
-    _lru.pop_back();
-
-    // Clean The Tile
-    _mapLRU.erase(toRecycle);
-    _mapCache[toRecycle->getIndexRowGlobal()][toRecycle->getIndexColGlobal()] =
-        nullptr;
-    toRecycle->setIndexRowGlobal(0);
-    toRecycle->setIndexColGlobal(0);
-    toRecycle->setNewTile(true);
-
-    // Put it back in the pool
-    _pool.push(toRecycle);
+  /// \brief Get the minimum number of tiles to cache, at least one per shard
+  /// and at most the number of tiles in the image
+  /// \return Minimum number of tiles to cache
+  uint32_t getMinNbTilesCache() const {
+    return std::min(std::max(_minNbTilesCache.load(), _nbShards),
+                    getMaxNbTilesCache());
+  }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    _timeRecycle += std::chrono::duration_cast<std::chrono::nanoseconds>(
-        end - begin).count();
+  /// \brief Get the maximum number of tiles to cache, i.e. the number of
+  /// tiles in the image
+  /// \return Maximum number of tiles to cache
+  uint32_t getMaxNbTilesCache() const {
+    return _numTilesHeight * _numTilesWidth;
+  }
 
-    toRecycle->unlock();
+  /// \brief Get the size of a cached tile in bytes
+  /// \return Size of a cached tile in bytes
+  uint64_t getTileBytes() const {
+    return (uint64_t) _tileHeight * _tileWidth * sizeof(UserType);
   }
 
-  /// \brief Private function. Get a new locked tile from the pool.
-  /// \param indexRow Tile row index asked
-  /// \param indexCol Tile col index asked
-  /// \return A locked tile
-  CachedTileType getNewLockedTile(uint32_t indexRow, uint32_t indexCol) {
-    // Get tile from the pool
-    CachedTileType tile = _pool.front();
-    tile->lock();
-    _pool.pop();
+  /// \brief Get the number of tiles in a row
+  /// \return Number of tiles in a row
+  uint32_t getNumTilesWidth() const { return _numTilesWidth; }
 
-    // Set tile information except data
-    tile->setIndexColGlobal(indexCol);
-    tile->setIndexRowGlobal(indexRow);
+  /// \brief Get the number of shards
+  /// \return Number of shards
+  uint32_t getNbShards() const { return _nbShards; }
 
-    // Register the tile
-    _mapCache[indexRow][indexCol] = tile;
-    _lru.push_front(tile);
-    _mapLRU[tile] = _lru.begin();
-    return tile;
+  /// \brief Get the pool of available tiles of a shard
+  /// \param shard Shard index
+  /// \return Pool of available tiles
+  const std::queue<CachedTileType> &getPool(uint32_t shard = 0) const {
+    return _shards[shard]->getPool();
   }
 
-  /// \brief Private function. Get cached locked tile
-  /// \param indexRow Tile row index asked
-  /// \param indexCol Tile col index asked
-  /// \return A locked tile already in the cache
-  CachedTileType getCachedLockedTile(uint32_t indexRow, uint32_t indexCol) {
-    assert(_mapCache[indexRow][indexCol] != nullptr);
+  /// \brief Get the map cache
+  /// \return The Map cache
+  const std::vector<std::vector<CachedTileType>> &getMapCache() const {
+    return _mapCache;
+  }
 
-    // Get the tile
-    CachedTileType tile = _mapCache[indexRow][indexCol];
-    tile->lock();
+  /// \brief Get the tiles stored in a shard, from the first to keep to the
+  /// first to recycle by the eviction policy
+  /// \param shard Shard index
+  /// \return Tiles stored in the shard
+  std::list<CachedTileType> getLru(uint32_t shard = 0) const {
+    return _shards[shard]->getLru();
+  }
 
-    // Update the tile position in the LRU
-    _lru.erase(_mapLRU[tile]);
-    _lru.push_front(tile);
-    _mapLRU[tile] = _lru.begin();
+  /// \brief Get the shard index owning a tile
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return Shard index
+  uint32_t shardIndex(uint32_t indexRow, uint32_t indexCol) const {
+    if (_nbShards == 1) { return 0; }
+    // Multiplicative hash of the tile index, reduced to [0, _nbShards)
+    auto hash = (uint32_t) ((indexRow * _numTilesWidth + indexCol)
+        * 2654435761u);
+    if (_nbNumaNodes == 1) {
+      return (uint32_t) (((uint64_t) hash * _nbShards) >> 32);
+    }
+    // In NUMA mode, reduced to the shards of the node owning the tile
+    uint32_t shardsPerNode = _nbShards / _nbNumaNodes;
+    return getTileNumaNode(indexCol) * shardsPerNode
+        + (uint32_t) (((uint64_t) hash * shardsPerNode) >> 32);
+  }
 
-    return tile;
+  /// \brief Get the NUMA node owning a tile
+  /// \param indexCol Tile col index
+  /// \return NUMA node index, 0 if not in NUMA mode
+  uint32_t getTileNumaNode(uint32_t indexCol) const {
+    return NumaTopology::getTileNode(indexCol, _numTilesWidth, _nbNumaNodes);
   }
 
-  /// \brief Private function. Print a queue, use to print the cache
-  /// \param q Queue to print
-  static void print_queue(std::queue<CachedTileType> q) {
-    while (!q.empty()) {
-      std::cout << q.front() << " ";
-      q.pop();
-    }
-    std::cout << std::endl;
+ private:
+  /// \brief Private function. Get the time spent to get tiles
+  /// \return Time spent to get tiles in ns
+  double getTimeGet() const {
+    double time = 0;
+    for (auto &shard : _shards) { time += shard->getTimeGet(); }
+    return time;
   }
 
-  std::queue<CachedTileType>
-      _pool;                  ///< Pool of new tile
+  /// \brief Private function. Get the time spent to recycle tiles
+  /// \return Time spent to recycle tiles in ns
+  double getTimeRecycle() const {
+    double time = 0;
+    for (auto &shard : _shards) { time += shard->getTimeRecycle(); }
+    return time;
+  }
 
   std::vector<std::vector<CachedTileType>>
       _mapCache;              ///< Matrix of cached tiles
 
-  std::unordered_map<CachedTileType,
-                     typename std::list<CachedTileType>::const_iterator>
-      _mapLRU;                ///< Map between the Tile and it's position
+  std::vector<std::unique_ptr<ACacheTier<UserType>>>
+      _tiers;                 ///< Tiers storing the tiles out of the cache
 
-  std::list<CachedTileType>
-      _lru;                   ///< List to save the Tile order
+  std::vector<std::unique_ptr<FigCacheShard<UserType>>>
+      _shards;                ///< Shards, each one owning part of the tiles
 
-  std::mutex
-      _cacheMutex;            ///< Cache mutex
+  MetricsRecorder
+      _metricsRecorder;       ///< Latencies and in-flight waits, per thread
 
-  double
-      _timeGet,               ///< Time to get a tile from the cache
-  ///< (use for statistics)
-      _timeRecycle,           ///< Time to release a tile from the cache
-  ///< (use for statistics)
-      _timeDisk;              ///< Disk time use for stats
+  std::atomic<uint64_t>
+      _nbFutureAccesses;      ///< Number of future accesses registered
+
+  std::atomic<uint32_t>
+      _nbTilesCache;          ///< Number of tiles allocated
 
   uint32_t
-      _nbTilesCache,          ///< Number of tiles allocated
-      _miss,                  ///< Number of tile miss (tile get from the disk)
-      _hit,                   ///< Number of tile hit (tile get from the cache)
+      _nbShards,              ///< Number of shards
       _numTilesHeight,        ///< Number of tiles in a column
-      _numTilesWidth;         ///< Number of tiles in a row
+      _numTilesWidth,         ///< Number of tiles in a row
+      _tileHeight,            ///< Tile's height
+      _tileWidth,             ///< Tile's width
+      _nbNumaNodes = 1;       ///< Number of NUMA nodes sharing the cache
+
+  std::atomic<uint32_t>
+      _minNbTilesCache{0};    ///< Minimum number of tiles to cache
+
+  EvictionPolicyType
+      _evictionPolicy;        ///< Eviction policy used by the shards
 };
 }
 #endif //FASTIMAGE_FIGCACHE_H
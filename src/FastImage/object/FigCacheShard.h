@@ -0,0 +1,540 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file FigCacheShard.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Part of the Fast Image cache with its own lock and eviction policy
+
+#ifndef FASTIMAGE_FIGCACHESHARD_H
+#define FASTIMAGE_FIGCACHESHARD_H
+
+#include <queue>
+#include <mutex>
+#include <list>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <sstream>
+#include <limits>
+
+#include "FastImage/data/CachedTile.h"
+#include "FastImage/data/DataType.h"
+#include "FastImage/exception/FastImageException.h"
+#include "FastImage/object/eviction/LRUPolicy.h"
+#include "FastImage/object/eviction/ClockPolicy.h"
+#include "FastImage/object/eviction/ARCPolicy.h"
+#include "FastImage/object/eviction/MINPolicy.h"
+#include "FastImage/object/tier/ACacheTier.h"
+#include "FastImage/object/CacheMetrics.h"
+#include "FastImage/object/UnpinSignal.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class FigCacheShard FigCacheShard.h <FastImage/object/FigCacheShard.h>
+  *
+  * @brief Part of the Fast Image cache.
+  *
+  * @details A FigCache is split into shards, each one owning a part of the
+  * cached tiles, its own eviction policy and its own mutex. The tiles of the
+  * image are distributed between the shards by the FigCache, so tile loaders
+  * asking for tiles in different shards do not compete for the same lock.
+  * The matrix of cached tiles is shared between the shards, each shard only
+  * updating the entries of its own tiles.
+  * The eviction policy (fi::AEvictionPolicy) is only used while the shard is
+  * locked. If the cache has second level tiers (fi::ACacheTier), the loaded
+  * tiles recycled are stored in the tiers not already storing all the tiles
+  * loaded. The tile leaving the shard is unlinked under the shard lock, and
+  * stored in the tiers once the lock released, out of the pool.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class FigCacheShard {
+  using CachedTileType = CachedTile<UserType> *;
+ public:
+  /// \brief FigCacheShard constructor
+  /// \param mapCache Matrix of cached tiles shared by the shards
+  /// \param evictionPolicy Eviction policy used by the shard
+  explicit FigCacheShard(std::vector<std::vector<CachedTileType>> &mapCache,
+                         EvictionPolicyType evictionPolicy =
+                         EvictionPolicyType::LRU)
+      : _mapCache(mapCache), _policy(createPolicy(evictionPolicy)),
+        _unpinSignal(_shardMutex), _timeGet(0.0), _timeRecycle(0.0), _miss(0), _hit(0), _evictions(0),
+        _reloads(0) {}
+
+  /// \brief FigCacheShard destructor, delete every tile of the shard
+  virtual ~FigCacheShard() {
+    // Clean the pool
+    while (!_pool.empty()) {
+      auto tile = _pool.front();
+      _pool.pop();
+      delete tile;
+    }
+
+    // Delete every stored tile in the shard
+    for (auto tile : _policy->getOrder()) { delete tile; }
+  }
+
+  /// \brief Allocate the shard's tiles
+  /// \details The tiles' data is allocated in a single region, by the
+  /// shard's fi::TileArena.
+  /// \param nbTiles Number of tiles owned by the shard
+  /// \param tileHeight Tile's height
+  /// \param tileWidth Tile's width
+  /// \param numTilesWidth Number of tiles in a row of the image
+  /// \param hugePages True to back the tiles' data with huge pages
+  /// \param numaNode NUMA node of the tiles' data, -1 for no placement
+  void initShard(uint32_t nbTiles, uint32_t tileHeight, uint32_t tileWidth,
+                 uint32_t numTilesWidth, bool hugePages = false,
+                 int32_t numaNode = -1) {
+    _policy->init(nbTiles, numTilesWidth);
+    _tileHeight = tileHeight;
+    _tileWidth = tileWidth;
+    _nbTiles = nbTiles;
+    _nbTilesAllocated = nbTiles;
+    _cachedOnce.assign(_mapCache.size() * numTilesWidth, false);
+    _arena.reset(new TileArena<UserType>(
+        (size_t) tileHeight * tileWidth, nbTiles, hugePages));
+    if (numaNode >= 0) { _arena->bindToNumaNode((uint32_t) numaNode); }
+    for (uint32_t tileCnt = 0; tileCnt < nbTiles; ++tileCnt) {
+      _pool.push(new CachedTile<UserType>(tileWidth, tileHeight,
+                                          _arena.get(), &_unpinSignal));
+    }
+  }
+
+  /// \brief Change the number of tiles owned by the shard
+  /// \details The new tiles are allocated in the pool. When the shard
+  /// shrinks, the tiles of the pool then the tiles not pinned chosen by the
+  /// eviction policy are deleted. The pinned tiles are deleted once released,
+  /// at the next tile asked.
+  /// \param nbTiles Number of tiles owned by the shard
+  void resize(uint32_t nbTiles) {
+    std::vector<CachedTileType> leaving;
+    {
+      std::lock_guard<std::mutex> lock(_shardMutex);
+      _nbTiles = nbTiles;
+      _policy->setCapacity(nbTiles);
+      for (; _nbTilesAllocated < _nbTiles; ++_nbTilesAllocated) {
+        _pool.push(new CachedTile<UserType>(_tileWidth, _tileHeight,
+                                            _arena.get(), &_unpinSignal));
+      }
+      shrink(leaving);
+    }
+    // The loaders waiting for a tile may take the new ones
+    _unpinSignal.notify();
+    deleteTiles(leaving);
+  }
+
+  /// \brief Get a pinned tile from the shard
+  /// \details The shard lock is only held to update the shard index, the tile
+  /// is pinned but not locked. The tiles evicted are stored in the tiers
+  /// without holding the shard lock.
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \param position Position of the access in the sequence of accesses
+  /// registered with addFutureAccess, max uint64_t if not registered
+  /// \return A pinned tile
+  CachedTileType getPinnedTile(
+      uint32_t indexRow, uint32_t indexCol,
+      uint64_t position = std::numeric_limits<uint64_t>::max()) {
+    CachedTileType tile;
+    std::vector<CachedTileType> leaving;
+
+    this->lock();
+    auto begin = std::chrono::high_resolution_clock::now();
+
+    // Delete the tiles left above the capacity by a resize
+    if (_nbTilesAllocated > _nbTiles) { shrink(leaving); }
+
+    // Recycle the tile chosen by the eviction policy. If every tile of the
+    // shard is in use, wait for one to be released, the shard lock released
+    // while waiting
+    while (!isInShard(indexRow, indexCol) && _pool.empty()) {
+      uint64_t nbUnpinned = _unpinSignal.getNbNotifications();
+      CachedTileType victim = evictTile(indexRow, indexCol);
+      if (victim == nullptr) {
+        std::unique_lock<std::mutex> lock(_shardMutex, std::adopt_lock);
+        _unpinSignal.wait(lock, nbUnpinned);
+        lock.release();
+      } else {
+        if (isToStoreInTier(victim)) {
+          this->unlock();
+          storeInTier(victim);
+          this->lock();
+        }
+        recycleTile(victim);
+      }
+    }
+
+    _policy->setAccessPosition(position);
+    if (isInShard(indexRow, indexCol)) {
+      // Tile is in cache
+      _hit += 1;
+      tile = getCachedTile(indexRow, indexCol);
+    } else {
+      // Tile is not in the cache
+      _miss += 1;
+      if (wasCached(indexRow, indexCol)) { _reloads += 1; }
+      tile = getNewTile(indexRow, indexCol);
+    }
+    tile->pin();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    _timeGet += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - begin).count();
+    this->unlock();
+    deleteTiles(leaving);
+    return tile;
+  }
+
+  /// \brief Test if a tile is in the shard, the shard being locked
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \return True if the tile is in the shard, else False
+  bool isCached(uint32_t indexRow, uint32_t indexCol) {
+    std::lock_guard<std::mutex> lock(_shardMutex);
+    return isInShard(indexRow, indexCol);
+  }
+
+  /// \brief Lock the shard.
+  void lock() { _shardMutex.lock(); }
+
+  /// \brief Unlock the shard.
+  void unlock() { _shardMutex.unlock(); }
+
+  /// Get the number of miss
+  /// \return Number of miss
+  uint32_t getMiss() const { return _miss; }
+
+  /// Get the number of Hit
+  /// \return Number of Hit
+  uint32_t getHit() const { return _hit; }
+
+  /// \brief Get the number of hits and misses, thread safe version of
+  /// getHit and getMiss
+  /// \return pair<hit, miss>
+  std::pair<uint32_t, uint32_t> countHitMiss() {
+    std::lock_guard<std::mutex> lock(_shardMutex);
+    return {_hit, _miss};
+  }
+
+  /// \brief Add the shard counters to a metrics snapshot, thread safe
+  /// \param metrics Metrics snapshot to add the hits, misses, evictions and
+  /// reloads to
+  void addMetrics(CacheMetrics &metrics) {
+    std::lock_guard<std::mutex> lock(_shardMutex);
+    metrics.hits += _hit;
+    metrics.misses += _miss;
+    metrics.evictions += _evictions;
+    metrics.reloads += _reloads;
+  }
+
+  /// \brief Get the number of tiles owned by the shard
+  /// \return Number of tiles owned by the shard
+  uint32_t getNbTiles() const { return _nbTiles; }
+
+  /// \brief Add a tier storing the recycled tiles
+  /// \param tier Cache tier, owned by the FigCache
+  void addTier(ACacheTier<UserType> *tier) {
+    std::lock_guard<std::mutex> lock(_shardMutex);
+    _tiers.push_back(tier);
+  }
+
+  /// \brief Get the time spent to get tiles from the shard
+  /// \return Time spent to get tiles from the shard in ns
+  double getTimeGet() const { return _timeGet; }
+
+  /// \brief Get the time spent to recycle tiles of the shard
+  /// \return Time spent to recycle tiles of the shard in ns
+  double getTimeRecycle() const { return _timeRecycle; }
+
+  /// \brief Get the pool of available tiles
+  /// \return Pool of available tiles
+  const std::queue<CachedTileType> &getPool() const { return _pool; }
+
+  /// \brief Get the tiles stored, from the first to keep to the first to
+  /// recycle by the eviction policy
+  /// \return Tiles stored
+  std::list<CachedTileType> getLru() const { return _policy->getOrder(); }
+
+  /// \brief Get the eviction policy
+  /// \return The eviction policy
+  const AEvictionPolicy<UserType> &getPolicy() const { return *_policy; }
+
+  /// \brief Register a future access to a tile of the shard, used by the
+  /// policies needing it
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param position Position of the access in the sequence of accesses
+  void addFutureAccess(uint32_t indexRow, uint32_t indexCol,
+                       uint64_t position) {
+    std::lock_guard<std::mutex> lock(_shardMutex);
+    _policy->addFutureAccess(indexRow, indexCol, position);
+  }
+
+  /// \brief Stream output operator for the shard
+  /// \param os Output stream
+  /// \param shard Shard to print
+  /// \return Output stream to put the shard data in
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const FigCacheShard &shard) {
+    os << "Waiting Queue: " << std::endl;
+    print_queue(os, shard._pool);
+    os << "Policy " << shard._policy->getName() << ": " << std::endl;
+    for (auto elem : shard._policy->getOrder())
+      os << elem << " ";
+    os << std::endl;
+    os << "timeGet: " << shard._timeGet << " / "
+       << "timeRelease: " << shard._timeRecycle << " / "
+       << "miss: " << shard._miss << " / hit: " << shard._hit << std::endl;
+    return os;
+  }
+
+ private:
+  /// \brief Private function. Test if the tile is in the shard
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \return True if the tile is in the shard, else False
+  bool isInShard(uint32_t indexRow, uint32_t indexCol) const {
+    return _mapCache[indexRow][indexCol] != nullptr;
+  }
+
+  /// \brief Private function. Test if the tile has already been in the
+  /// shard
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \return True if the tile has been cached before, else False
+  bool wasCached(uint32_t indexRow, uint32_t indexCol) const {
+    return _cachedOnce[(size_t) indexRow * _mapCache[indexRow].size()
+        + indexCol];
+  }
+
+  /// \brief Private function. Create the eviction policy
+  /// \param evictionPolicy Eviction policy type
+  /// \return The eviction policy
+  static AEvictionPolicy<UserType> *createPolicy(
+      EvictionPolicyType evictionPolicy) {
+    switch (evictionPolicy) {
+      case EvictionPolicyType::LRU:return new LRUPolicy<UserType>();
+      case EvictionPolicyType::CLOCK:return new ClockPolicy<UserType>();
+      case EvictionPolicyType::ARC:return new ARCPolicy<UserType>();
+      case EvictionPolicyType::MIN:return new MINPolicy<UserType>();
+    }
+    std::stringstream message;
+    message << "FigCache ERROR: Unknown eviction policy: "
+            << (int) evictionPolicy;
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  /// \brief Private function. Unlink the tile not in use chosen by the
+  /// eviction policy from the shard
+  /// \details The tile keeps its indexes to be stored in the tiers, then has
+  /// to be given to recycleTile.
+  /// \param indexRow Row index of the tile which will be stored
+  /// \param indexCol Col index of the tile which will be stored
+  /// \return The tile evicted, nullptr if all tiles are in use
+  CachedTileType evictTile(uint32_t indexRow, uint32_t indexCol) {
+    // Get the victim, never pinned. A tile not pinned can't be locked as the
+    // shard is locked
+    CachedTileType victim = _policy->selectVictim(indexRow, indexCol);
+    if (victim == nullptr) { return nullptr; }
+    _evictions += 1;
+    _mapCache[victim->getIndexRowGlobal()][victim->getIndexColGlobal()] =
+        nullptr;
+    return victim;
+  }
+
+  /// \brief Private function. Clean a tile evicted and put it back in the
+  /// pool
+  /// \param toRecycle Tile evicted
+  void recycleTile(CachedTileType toRecycle) {
+    auto begin = std::chrono::high_resolution_clock::now();
+    toRecycle->setIndexRowGlobal(0);
+    toRecycle->setIndexColGlobal(0);
+    toRecycle->setNewTile(true);
+    _pool.push(toRecycle);
+    auto end = std::chrono::high_resolution_clock::now();
+    _timeRecycle += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - begin).count();
+  }
+
+  /// \brief Private function. Unlink the tiles allocated above the shard
+  /// capacity, from the pool first, then the tiles not pinned chosen by the
+  /// eviction policy.
+  /// \param leaving Tiles unlinked, to store in the tiers and delete once the
+  /// shard unlocked (deleteTiles)
+  void shrink(std::vector<CachedTileType> &leaving) {
+    while (_nbTilesAllocated > _nbTiles) {
+      if (_pool.empty()) {
+        CachedTileType toDelete = _policy->selectVictimToShrink();
+        if (toDelete == nullptr) { return; }
+        _evictions += 1;
+        _mapCache[toDelete->getIndexRowGlobal()]
+        [toDelete->getIndexColGlobal()] = nullptr;
+        leaving.push_back(toDelete);
+      } else {
+        leaving.push_back(_pool.front());
+        _pool.pop();
+      }
+      --_nbTilesAllocated;
+    }
+  }
+
+  /// \brief Private function. Store the tiles unlinked by shrink in the
+  /// tiers and delete them, the shard being unlocked
+  /// \param leaving Tiles unlinked
+  void deleteTiles(const std::vector<CachedTileType> &leaving) {
+    for (auto tile : leaving) {
+      if (isToStoreInTier(tile)) { storeInTier(tile); }
+      delete tile;
+    }
+  }
+
+  /// \brief Private function. Test if a tile leaving the shard has to be
+  /// stored in a tier
+  /// \param tile Tile leaving the shard
+  /// \return True if the tile is loaded and a tier stores the tiles evicted
+  bool isToStoreInTier(CachedTileType tile) const {
+    if (tile->getState() != TileState::READY) { return false; }
+    for (auto tier : _tiers) {
+      if (!tier->storesLoadedTiles()) { return true; }
+    }
+    return false;
+  }
+
+  /// \brief Private function. Store a loaded tile leaving the shard in the
+  /// tiers, without holding the shard lock
+  /// \param tile Tile leaving the shard, unlinked from the shard
+  void storeInTier(CachedTileType tile) {
+    for (auto tier : _tiers) {
+      if (!tier->storesLoadedTiles()) {
+        tier->store(tile->getIndexRowGlobal(), tile->getIndexColGlobal(),
+                    tile->getData(), (size_t) _tileHeight * _tileWidth);
+      }
+    }
+  }
+
+  /// \brief Private function. Get a new tile from the pool.
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \return A new tile, not locked
+  CachedTileType getNewTile(uint32_t indexRow, uint32_t indexCol) {
+    // Get tile from the pool
+    CachedTileType tile = _pool.front();
+    _pool.pop();
+
+    // Set tile information except data
+    tile->setIndexColGlobal(indexCol);
+    tile->setIndexRowGlobal(indexRow);
+
+    // Register the tile
+    _mapCache[indexRow][indexCol] = tile;
+    _cachedOnce[(size_t) indexRow * _mapCache[indexRow].size() + indexCol] =
+        true;
+    _policy->tileInserted(tile);
+    return tile;
+  }
+
+  /// \brief Private function. Get cached tile
+  /// \param indexRow Tile row index asked
+  /// \param indexCol Tile col index asked
+  /// \return A tile already in the shard, not locked
+  CachedTileType getCachedTile(uint32_t indexRow, uint32_t indexCol) {
+    assert(_mapCache[indexRow][indexCol] != nullptr);
+
+    // Get the tile
+    CachedTileType tile = _mapCache[indexRow][indexCol];
+
+    // Update the tile in the eviction policy
+    _policy->tileAccessed(tile);
+
+    return tile;
+  }
+
+  /// \brief Private function. Print a queue, use to print the shard
+  /// \param os Output stream
+  /// \param q Queue to print
+  static void print_queue(std::ostream &os, std::queue<CachedTileType> q) {
+    while (!q.empty()) {
+      os << q.front() << " ";
+      q.pop();
+    }
+    os << std::endl;
+  }
+
+  std::vector<std::vector<CachedTileType>>
+      &_mapCache;             ///< Matrix of cached tiles, shared by the shards
+
+  std::queue<CachedTileType>
+      _pool;                  ///< Pool of new tile
+
+  std::vector<bool>
+      _cachedOnce;            ///< Tiles already cached by the shard, per
+                              ///< row * numTilesWidth + col
+
+  std::unique_ptr<AEvictionPolicy<UserType>>
+      _policy;                ///< Eviction policy
+
+  std::unique_ptr<TileArena<UserType>>
+      _arena;                 ///< Arena of the tiles' data
+
+  std::mutex
+      _shardMutex;            ///< Shard mutex
+
+  UnpinSignal
+      _unpinSignal;           ///< Signal of the tiles no longer pinned, the
+                              ///< loaders waiting for a tile to recycle
+
+  std::vector<ACacheTier<UserType> *>
+      _tiers;                 ///< Tiers storing the recycled tiles, owned by
+                              ///< the FigCache
+
+  double
+      _timeGet,               ///< Time to get a tile from the shard
+  ///< (use for statistics)
+      _timeRecycle;           ///< Time to release a tile from the shard
+  ///< (use for statistics)
+
+  uint32_t
+      _miss,                  ///< Number of tile miss (tile get from the disk)
+      _hit,                   ///< Number of tile hit (tile get from the cache)
+      _evictions,             ///< Number of tiles evicted
+      _reloads,               ///< Number of miss on a tile cached before
+      _nbTiles = 0,           ///< Number of tiles owned by the shard
+      _nbTilesAllocated = 0,  ///< Number of tiles allocated, above _nbTiles
+                              ///< until the shard has shrunk
+      _tileHeight = 0,        ///< Tile's height
+      _tileWidth = 0;         ///< Tile's width
+};
+}
+#endif //FASTIMAGE_FIGCACHESHARD_H
@@ -0,0 +1,156 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file MappedFile.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Read only memory mapping of a file
+
+#ifndef FASTIMAGE_MAPPEDFILE_H
+#define FASTIMAGE_MAPPEDFILE_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "FastImage/data/DataType.h"
+#include "FastImage/exception/FastImageException.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class MappedFile MappedFile.h <FastImage/object/MappedFile.h>
+  *
+  * @brief Map a whole file read only in memory.
+  *
+  * @details The file is mapped once and shared between the tile loader
+  * copies. The pages are served from the page cache, the kernel read ahead is
+  * tuned with madvise from the traversal used to traverse the image.
+  **/
+class MappedFile {
+ public:
+  /// \brief MappedFile constructor, open and map the file
+  /// \param filePath File path
+  explicit MappedFile(const std::string &filePath) {
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) { throwError("The file can not be opened", filePath); }
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0) {
+      close(fd);
+      throwError("The file size can not be read", filePath);
+    }
+    _size = (size_t) fileStat.st_size;
+    if (_size > 0) {
+      void *data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        throwError("The file can not be mapped", filePath);
+      }
+      _data = (const uint8_t *) data;
+    }
+    // The mapping stays valid after the file is closed
+    close(fd);
+  }
+
+  /// \brief MappedFile destructor, unmap the file
+  ~MappedFile() {
+    if (_data != nullptr) { munmap((void *) _data, _size); }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /// \brief Get the mapped file
+  /// \return Pointer to the first byte of the file
+  const uint8_t *getData() const { return _data; }
+
+  /// \brief Get the file size
+  /// \return File size in bytes
+  size_t getSize() const { return _size; }
+
+  /// \brief Advise the kernel about the accesses from the traversal
+  /// \details The naive and snake traversals read the tiles in the file
+  /// order, the kernel reads ahead aggressively. The other traversals jump in
+  /// the file, the read ahead is disabled so only the pages asked are read.
+  /// \param traversalType Traversal used to traverse the image
+  void advise(TraversalType traversalType) const {
+    if (_data == nullptr) { return; }
+    switch (traversalType) {
+      case TraversalType::NAIVE:
+      case TraversalType::SNAKE:
+        madvise((void *) _data, _size, MADV_SEQUENTIAL);
+        break;
+      case TraversalType::DIAGONAL:
+      case TraversalType::HILBERT:
+      case TraversalType::SPIRAL:
+        madvise((void *) _data, _size, MADV_RANDOM);
+        break;
+    }
+  }
+
+  /// \brief Ask the kernel to read a range of the file in the background
+  /// \param offset Offset of the range in bytes
+  /// \param length Length of the range in bytes
+  void willNeed(size_t offset, size_t length) const {
+    if (_data == nullptr || offset >= _size) { return; }
+    // madvise needs an address aligned on the page size
+    static const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    size_t begin = offset - offset % pageSize;
+    length = std::min(length + offset - begin, _size - begin);
+    madvise((void *) (_data + begin), length, MADV_WILLNEED);
+  }
+
+ private:
+  /// \brief Private function. Throw an exception with the errno description
+  /// \param reason Reason of the error
+  /// \param filePath File path
+  static void throwError(const std::string &reason,
+                         const std::string &filePath) {
+    std::stringstream message;
+    message << "Mapped File ERROR: " << reason << " (" << filePath << "): "
+            << strerror(errno) << ".";
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  const uint8_t *
+      _data = nullptr;      ///< Mapped file
+
+  size_t
+      _size = 0;            ///< File size in bytes
+};
+}
+#endif //FASTIMAGE_MAPPEDFILE_H
@@ -0,0 +1,213 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file NumaTopology.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief NUMA nodes of the machine, thread pinning and memory placement
+
+#ifndef FASTIMAGE_NUMATOPOLOGY_H
+#define FASTIMAGE_NUMATOPOLOGY_H
+
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class NumaTopology NumaTopology.h <FastImage/object/NumaTopology.h>
+  *
+  * @brief NUMA nodes of the machine, read once from
+  * /sys/devices/system/node.
+  *
+  * @details The nodes are numbered from 0 to getNbNodes() - 1, following the
+  * online nodes order. A machine without the NUMA information has a single
+  * node holding every cpu.
+  *
+  * In NUMA mode, the tiles of a pyramid level are owned by the nodes by
+  * column bands (getTileNode): a tile is cached in the shards whose memory is
+  * on its node, and loaded and copied by the tile loader threads pinned on
+  * its node. The placement is best effort: a thread not pinned or a memory
+  * not bound keeps working, only slower.
+  **/
+class NumaTopology {
+ public:
+  /// \brief Get the topology of the machine
+  /// \return The topology, read at the first call
+  static const NumaTopology &getInstance() {
+    static const NumaTopology topology;
+    return topology;
+  }
+
+  /// \brief Get the number of nodes
+  /// \return Number of nodes, at least 1
+  uint32_t getNbNodes() const { return (uint32_t) _nodeIds.size(); }
+
+  /// \brief Get the cpus of a node
+  /// \param node Node index
+  /// \return Cpus of the node, empty if unknown
+  const std::vector<int> &getCpus(uint32_t node) const {
+    static const std::vector<int> noCpu;
+    return node < _cpus.size() ? _cpus[node] : noCpu;
+  }
+
+  /// \brief Pin the calling thread on the cpus of a node
+  /// \param node Node index
+  /// \return True if the thread has been pinned, else False
+  bool pinThread(uint32_t node) const {
+    if (getCpus(node).empty()) { return false; }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : getCpus(node)) {
+      if (cpu < CPU_SETSIZE) { CPU_SET(cpu, &cpuSet); }
+    }
+    return sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) == 0;
+  }
+
+  /// \brief Place the pages of a memory range on a node, before they are
+  /// touched
+  /// \param address Range start, aligned on a page
+  /// \param length Range length in bytes
+  /// \param node Node index
+  /// \return True if the range has been bound, else False
+  bool bindMemory(void *address, size_t length, uint32_t node) const {
+    if (node >= _nodeIds.size()) { return false; }
+    return setMemoryPolicy(address, length, preferredPolicy,
+                           {_nodeIds[node]});
+  }
+
+  /// \brief Interleave the pages of a memory range on every node, before they
+  /// are touched
+  /// \param address Range start, aligned on a page
+  /// \param length Range length in bytes
+  /// \return True if the range has been interleaved, else False
+  bool interleaveMemory(void *address, size_t length) const {
+    return _nodeIds.size() > 1
+        && setMemoryPolicy(address, length, interleavePolicy, _nodeIds);
+  }
+
+  /// \brief Get the node owning a tile, the columns of tiles being split in
+  /// nbNodes bands
+  /// \param indexCol Tile col index
+  /// \param numTilesWidth Number of tiles in a row
+  /// \param nbNodes Number of nodes
+  /// \return Node index owning the tile
+  static uint32_t getTileNode(uint32_t indexCol, uint32_t numTilesWidth,
+                              uint32_t nbNodes) {
+    if (nbNodes <= 1 || numTilesWidth == 0) { return 0; }
+    return (uint32_t) ((uint64_t) indexCol * nbNodes / numTilesWidth);
+  }
+
+  /// \brief Parse a sysfs list, e.g. "0-3,8,10-11"
+  /// \param list List to parse
+  /// \return Values of the list
+  static std::vector<int> parseList(const std::string &list) {
+    std::vector<int> values;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+      if (range.empty() || range == "\n") { continue; }
+      size_t dash = range.find('-');
+      int
+          first = std::atoi(range.substr(0, dash).c_str()),
+          last = dash == std::string::npos ?
+                 first : std::atoi(range.substr(dash + 1).c_str());
+      for (int value = first; value <= last; ++value) {
+        values.push_back(value);
+      }
+    }
+    return values;
+  }
+
+ private:
+  static constexpr int
+      preferredPolicy = 1,      ///< MPOL_PREFERRED
+      interleavePolicy = 3;     ///< MPOL_INTERLEAVE
+
+  /// \brief Private constructor, read the nodes and their cpus
+  NumaTopology() {
+    std::string online;
+    std::ifstream onlineFile("/sys/devices/system/node/online");
+    if (std::getline(onlineFile, online)) {
+      for (int nodeId : parseList(online)) {
+        std::ifstream cpuFile("/sys/devices/system/node/node"
+                                  + std::to_string(nodeId) + "/cpulist");
+        std::string cpus;
+        std::getline(cpuFile, cpus);
+        _nodeIds.push_back(nodeId);
+        _cpus.push_back(parseList(cpus));
+      }
+    }
+    if (_nodeIds.empty()) {
+      _nodeIds.push_back(0);
+      _cpus.emplace_back();
+    }
+  }
+
+  /// \brief Private function. Set the memory policy of a range with mbind
+  /// \param address Range start, aligned on a page
+  /// \param length Range length in bytes
+  /// \param mode Memory policy
+  /// \param nodeIds Nodes of the policy
+  /// \return True if the policy has been set, else False
+  static bool setMemoryPolicy(void *address, size_t length, int mode,
+                              const std::vector<int> &nodeIds) {
+#ifdef SYS_mbind
+    const size_t bitsPerWord = 8 * sizeof(unsigned long);
+    int maxNodeId = 0;
+    for (int nodeId : nodeIds) { maxNodeId = std::max(maxNodeId, nodeId); }
+    std::vector<unsigned long> nodeMask(maxNodeId / bitsPerWord + 1, 0);
+    for (int nodeId : nodeIds) {
+      nodeMask[nodeId / bitsPerWord] |= 1ul << (nodeId % bitsPerWord);
+    }
+    return syscall(SYS_mbind, address, length, mode, nodeMask.data(),
+                   nodeMask.size() * bitsPerWord + 1, 0) == 0;
+#else
+    return false;
+#endif
+  }
+
+  std::vector<int>
+      _nodeIds;                 ///< System id of each node
+
+  std::vector<std::vector<int>>
+      _cpus;                    ///< Cpus of each node
+};
+}
+
+#endif //FASTIMAGE_NUMATOPOLOGY_H
@@ -0,0 +1,742 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file PixelConverter.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Vectorized pixel type conversion used by the tile loaders
+
+#ifndef FASTIMAGE_PIXELCONVERTER_H
+#define FASTIMAGE_PIXELCONVERTER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <limits>
+#include <sstream>
+#include "FastImage/exception/FastImageException.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FASTIMAGE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/// \brief Instruction sets used by the pixel conversion
+enum class SIMDLevel {
+  NONE,
+  AVX2,
+  AVX512
+};
+
+/**
+  * @class PixelConverter PixelConverter.h <FastImage/object/PixelConverter.h>
+  *
+  * @brief Convert a buffer of pixels from the file type to the user type,
+  * with an optional scale and offset (dest = src * scale + offset).
+  *
+  * @details The conversions are vectorized with AVX2 or AVX-512, the
+  * instruction set is chosen at runtime from the CPU capabilities. AVX2 is
+  * the floor: without it, the conversions use a flat loop. The vectorized
+  * conversions are:
+  * - the 8, 16 and 32 bits integers and float to float and to double;
+  * - the 8, 16 and 32 bits integers to 32 bits integers, without scale and
+  * offset.
+  *
+  * The other conversions use the flat loop, which is only vectorized by the
+  * compiler when the optimizations are enabled (the FastImage build defaults
+  * to Release): the 64 bits integer sources, as AVX2 can not convert them
+  * and only AVX512F is detected, the double sources, the integer targets
+  * narrower than 32 bits, and the integer targets with a scale or an offset.
+  * The scale and offset are computed in float for a float user type, else in
+  * double, and the result is cast to the user type.
+  *
+  * @code
+  * fi::PixelConverter<uint16_t, float>::convert(src, dest, nbPixels);
+  * fi::PixelConverter<uint16_t, float>::convert(src, dest, nbPixels,
+  *                                              1. / 65535, 0);
+  * @endcode
+  *
+  * @tparam FileType Pixel type in the file
+  * @tparam UserType Pixel type asked by the end user
+  **/
+template<typename FileType, typename UserType>
+class PixelConverter {
+  /// Type used to compute the scale and offset
+  using ComputeType =
+  typename std::conditional<std::is_same<UserType, float>::value,
+                            float, double>::type;
+ public:
+  /// \brief Convert a buffer of pixels
+  /// \param src Source pixels
+  /// \param dest Destination pixels, can not overlap the source
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  static void convert(const FileType *src,
+                      UserType *dest,
+                      size_t nbPixels,
+                      double scale = 1.,
+                      double offset = 0.) {
+    convert(src, dest, nbPixels, scale, offset,
+            std::integral_constant<bool, isVectorized()>());
+  }
+
+  /// \brief Test if the conversion is vectorized with AVX2 / AVX-512
+  /// \return True if the conversion is vectorized, else False
+  static constexpr bool isVectorized() {
+#ifdef FASTIMAGE_X86_SIMD
+    return ((std::is_same<UserType, float>::value
+        || std::is_same<UserType, double>::value)
+        && (isIntegerUpTo32Bits() || std::is_same<FileType, float>::value))
+        || ((std::is_same<UserType, uint32_t>::value
+            || std::is_same<UserType, int32_t>::value)
+            && isIntegerUpTo32Bits());
+#else
+    return false;
+#endif
+  }
+
+  /// \brief Get the instruction set used, detected once from the CPU
+  /// \return Instruction set used
+  static SIMDLevel getSIMDLevel() {
+#ifdef FASTIMAGE_X86_SIMD
+    static const SIMDLevel level =
+        __builtin_cpu_supports("avx512f") ? SIMDLevel::AVX512 :
+        __builtin_cpu_supports("avx2") ? SIMDLevel::AVX2 : SIMDLevel::NONE;
+    return level;
+#else
+    return SIMDLevel::NONE;
+#endif
+  }
+
+  /// \brief Convert a buffer of pixels without vectorization
+  /// \param src Source pixels
+  /// \param dest Destination pixels, can not overlap the source
+  /// \param nbPixels Number of pixels to convert
+  static void convertScalar(const FileType *__restrict src,
+                            UserType *__restrict dest,
+                            size_t nbPixels) {
+    for (size_t pixel = 0; pixel < nbPixels; ++pixel) {
+      dest[pixel] = (UserType) src[pixel];
+    }
+  }
+
+  /// \brief Convert, scale and offset a buffer of pixels without
+  /// vectorization
+  /// \param src Source pixels
+  /// \param dest Destination pixels, can not overlap the source
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  static void convertScalar(const FileType *__restrict src,
+                            UserType *__restrict dest,
+                            size_t nbPixels,
+                            ComputeType scale,
+                            ComputeType offset) {
+    for (size_t pixel = 0; pixel < nbPixels; ++pixel) {
+      dest[pixel] = (UserType) ((ComputeType) src[pixel] * scale + offset);
+    }
+  }
+
+ private:
+  /// \brief Private function. Test if the file type is an integer the
+  /// vectorized conversions widen to 32 bits
+  /// \return True if the file type is a 8, 16 or 32 bits integer, else False
+  static constexpr bool isIntegerUpTo32Bits() {
+    return std::is_same<FileType, uint8_t>::value
+        || std::is_same<FileType, int8_t>::value
+        || std::is_same<FileType, uint16_t>::value
+        || std::is_same<FileType, int16_t>::value
+        || std::is_same<FileType, uint32_t>::value
+        || std::is_same<FileType, int32_t>::value;
+  }
+
+  /// \brief Private function. Convert a buffer of pixels with the scalar loop
+  /// \param src Source pixels
+  /// \param dest Destination pixels, can not overlap the source
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  static void convert(const FileType *src,
+                      UserType *dest,
+                      size_t nbPixels,
+                      double scale,
+                      double offset,
+                      std::false_type) {
+    if (scale != 1. || offset != 0.) {
+      convertScalar(src, dest, nbPixels, (ComputeType) scale,
+                    (ComputeType) offset);
+    } else {
+      convertScalar(src, dest, nbPixels);
+    }
+  }
+
+#ifdef FASTIMAGE_X86_SIMD
+  /// \brief Private function. Convert a buffer of pixels with the best
+  /// instruction set available
+  /// \details The integer targets with a scale or an offset are computed in
+  /// double and cast by the scalar loop.
+  /// \param src Source pixels
+  /// \param dest Destination pixels, can not overlap the source
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  static void convert(const FileType *src,
+                      UserType *dest,
+                      size_t nbPixels,
+                      double scale,
+                      double offset,
+                      std::true_type) {
+    if (std::is_integral<UserType>::value && (scale != 1. || offset != 0.)) {
+      convert(src, dest, nbPixels, scale, offset, std::false_type());
+      return;
+    }
+    switch (getSIMDLevel()) {
+      case SIMDLevel::AVX512:
+        convertAVX512(src, dest, nbPixels, (ComputeType) scale,
+                      (ComputeType) offset);
+        break;
+      case SIMDLevel::AVX2:
+        convertAVX2(src, dest, nbPixels, (ComputeType) scale,
+                    (ComputeType) offset);
+        break;
+      case SIMDLevel::NONE:
+        convert(src, dest, nbPixels, scale, offset, std::false_type());
+        break;
+    }
+  }
+
+  /// \brief Private function. Load 8 pixels as int32
+  /// \param src Source pixels
+  /// \return 8 pixels as int32
+  __attribute__((target("avx2")))
+  static __m256i widen8(const uint8_t *src) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) src));
+  }
+
+  /// \brief Private function. Load 8 pixels as int32
+  /// \param src Source pixels
+  /// \return 8 pixels as int32
+  __attribute__((target("avx2")))
+  static __m256i widen8(const int8_t *src) {
+    return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) src));
+  }
+
+  /// \brief Private function. Load 8 pixels as int32
+  /// \param src Source pixels
+  /// \return 8 pixels as int32
+  __attribute__((target("avx2")))
+  static __m256i widen8(const uint16_t *src) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) src));
+  }
+
+  /// \brief Private function. Load 8 pixels as int32
+  /// \param src Source pixels
+  /// \return 8 pixels as int32
+  __attribute__((target("avx2")))
+  static __m256i widen8(const int16_t *src) {
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) src));
+  }
+
+  /// \brief Private function. Load 8 pixels, as uint32 are stored in the
+  /// 32 bits integer targets
+  /// \param src Source pixels
+  /// \return 8 pixels
+  __attribute__((target("avx2")))
+  static __m256i widen8(const uint32_t *src) {
+    return _mm256_loadu_si256((const __m256i *) src);
+  }
+
+  /// \brief Private function. Load 8 pixels
+  /// \param src Source pixels
+  /// \return 8 pixels
+  __attribute__((target("avx2")))
+  static __m256i widen8(const int32_t *src) {
+    return _mm256_loadu_si256((const __m256i *) src);
+  }
+
+  /// \brief Private function. Load 8 pixels as float
+  /// \tparam Integer 8, 16 or 32 bits signed integer, or 8 or 16 bits
+  /// unsigned integer
+  /// \param src Source pixels
+  /// \return 8 pixels as float
+  template<typename Integer>
+  __attribute__((target("avx2")))
+  static __m256 load8(const Integer *src) {
+    return _mm256_cvtepi32_ps(widen8(src));
+  }
+
+  /// \brief Private function. Load 8 pixels as float
+  /// \details AVX2 only converts signed integers: the high and low 16 bits
+  /// are converted exactly, and the value is rounded once when added.
+  /// \param src Source pixels
+  /// \return 8 pixels as float
+  __attribute__((target("avx2")))
+  static __m256 load8(const uint32_t *src) {
+    __m256i value = widen8(src);
+    __m256
+        high = _mm256_cvtepi32_ps(_mm256_srli_epi32(value, 16)),
+        low = _mm256_cvtepi32_ps(
+        _mm256_and_si256(value, _mm256_set1_epi32(0xFFFF)));
+    return _mm256_add_ps(_mm256_mul_ps(high, _mm256_set1_ps(65536.f)), low);
+  }
+
+  /// \brief Private function. Load 8 pixels as float
+  /// \param src Source pixels
+  /// \return 8 pixels as float
+  __attribute__((target("avx2")))
+  static __m256 load8(const float *src) { return _mm256_loadu_ps(src); }
+
+  /// \brief Private function. Load 8 pixels as double
+  /// \tparam Integer 8, 16 or 32 bits signed integer, or 8 or 16 bits
+  /// unsigned integer
+  /// \param src Source pixels
+  /// \param low First 4 pixels as double
+  /// \param high Last 4 pixels as double
+  template<typename Integer>
+  __attribute__((target("avx2")))
+  static void load8(const Integer *src, __m256d &low, __m256d &high) {
+    __m256i value = widen8(src);
+    low = _mm256_cvtepi32_pd(_mm256_castsi256_si128(value));
+    high = _mm256_cvtepi32_pd(_mm256_extracti128_si256(value, 1));
+  }
+
+  /// \brief Private function. Load 8 pixels as double
+  /// \details AVX2 only converts signed integers: the pixels are shifted by
+  /// -2^31 to be converted, and shifted back exactly in double.
+  /// \param src Source pixels
+  /// \param low First 4 pixels as double
+  /// \param high Last 4 pixels as double
+  __attribute__((target("avx2")))
+  static void load8(const uint32_t *src, __m256d &low, __m256d &high) {
+    __m256i value = _mm256_xor_si256(
+        widen8(src), _mm256_set1_epi32(std::numeric_limits<int32_t>::min()));
+    const __m256d shift = _mm256_set1_pd(2147483648.);
+    low = _mm256_add_pd(
+        _mm256_cvtepi32_pd(_mm256_castsi256_si128(value)), shift);
+    high = _mm256_add_pd(
+        _mm256_cvtepi32_pd(_mm256_extracti128_si256(value, 1)), shift);
+  }
+
+  /// \brief Private function. Load 8 pixels as double
+  /// \param src Source pixels
+  /// \param low First 4 pixels as double
+  /// \param high Last 4 pixels as double
+  __attribute__((target("avx2")))
+  static void load8(const float *src, __m256d &low, __m256d &high) {
+    low = _mm256_cvtps_pd(_mm_loadu_ps(src));
+    high = _mm256_cvtps_pd(_mm_loadu_ps(src + 4));
+  }
+
+  /// \brief Private function. Load 16 pixels as int32
+  /// \param src Source pixels
+  /// \return 16 pixels as int32
+  __attribute__((target("avx512f")))
+  static __m512i widen16(const uint8_t *src) {
+    return _mm512_maskz_cvtepu8_epi32(
+        allLanes, _mm_loadu_si128((const __m128i *) src));
+  }
+
+  /// \brief Private function. Load 16 pixels as int32
+  /// \param src Source pixels
+  /// \return 16 pixels as int32
+  __attribute__((target("avx512f")))
+  static __m512i widen16(const int8_t *src) {
+    return _mm512_maskz_cvtepi8_epi32(
+        allLanes, _mm_loadu_si128((const __m128i *) src));
+  }
+
+  /// \brief Private function. Load 16 pixels as int32
+  /// \param src Source pixels
+  /// \return 16 pixels as int32
+  __attribute__((target("avx512f")))
+  static __m512i widen16(const uint16_t *src) {
+    return _mm512_maskz_cvtepu16_epi32(
+        allLanes, _mm256_loadu_si256((const __m256i *) src));
+  }
+
+  /// \brief Private function. Load 16 pixels as int32
+  /// \param src Source pixels
+  /// \return 16 pixels as int32
+  __attribute__((target("avx512f")))
+  static __m512i widen16(const int16_t *src) {
+    return _mm512_maskz_cvtepi16_epi32(
+        allLanes, _mm256_loadu_si256((const __m256i *) src));
+  }
+
+  /// \brief Private function. Load 16 pixels, as uint32 are stored in the
+  /// 32 bits integer targets
+  /// \param src Source pixels
+  /// \return 16 pixels
+  __attribute__((target("avx512f")))
+  static __m512i widen16(const uint32_t *src) {
+    return _mm512_loadu_si512(src);
+  }
+
+  /// \brief Private function. Load 16 pixels
+  /// \param src Source pixels
+  /// \return 16 pixels
+  __attribute__((target("avx512f")))
+  static __m512i widen16(const int32_t *src) {
+    return _mm512_loadu_si512(src);
+  }
+
+  /// \brief Private function. Load 16 pixels as float
+  /// \details The zero masked conversions are used as the unmasked ones
+  /// trigger false uninitialized warnings with some GCC versions.
+  /// \tparam Integer 8, 16 or 32 bits signed integer, or 8 or 16 bits
+  /// unsigned integer
+  /// \param src Source pixels
+  /// \return 16 pixels as float
+  template<typename Integer>
+  __attribute__((target("avx512f")))
+  static __m512 load16(const Integer *src) {
+    return _mm512_maskz_cvtepi32_ps(allLanes, widen16(src));
+  }
+
+  /// \brief Private function. Load 16 pixels as float
+  /// \param src Source pixels
+  /// \return 16 pixels as float
+  __attribute__((target("avx512f")))
+  static __m512 load16(const uint32_t *src) {
+    return _mm512_maskz_cvtepu32_ps(allLanes, widen16(src));
+  }
+
+  /// \brief Private function. Load 16 pixels as float
+  /// \param src Source pixels
+  /// \return 16 pixels as float
+  __attribute__((target("avx512f")))
+  static __m512 load16(const float *src) { return _mm512_loadu_ps(src); }
+
+  /// \brief Private function. Load 16 pixels as double
+  /// \tparam Integer 8, 16 or 32 bits signed integer, or 8 or 16 bits
+  /// unsigned integer
+  /// \param src Source pixels
+  /// \param low First 8 pixels as double
+  /// \param high Last 8 pixels as double
+  template<typename Integer>
+  __attribute__((target("avx512f")))
+  static void load16(const Integer *src, __m512d &low, __m512d &high) {
+    __m512i value = widen16(src);
+    low = _mm512_maskz_cvtepi32_pd(
+        halfLanes, _mm512_maskz_extracti64x4_epi64(halfLanes, value, 0));
+    high = _mm512_maskz_cvtepi32_pd(
+        halfLanes, _mm512_maskz_extracti64x4_epi64(halfLanes, value, 1));
+  }
+
+  /// \brief Private function. Load 16 pixels as double
+  /// \param src Source pixels
+  /// \param low First 8 pixels as double
+  /// \param high Last 8 pixels as double
+  __attribute__((target("avx512f")))
+  static void load16(const uint32_t *src, __m512d &low, __m512d &high) {
+    low = _mm512_maskz_cvtepu32_pd(
+        halfLanes, _mm256_loadu_si256((const __m256i *) src));
+    high = _mm512_maskz_cvtepu32_pd(
+        halfLanes, _mm256_loadu_si256((const __m256i *) (src + 8)));
+  }
+
+  /// \brief Private function. Load 16 pixels as double
+  /// \param src Source pixels
+  /// \param low First 8 pixels as double
+  /// \param high Last 8 pixels as double
+  __attribute__((target("avx512f")))
+  static void load16(const float *src, __m512d &low, __m512d &high) {
+    low = _mm512_maskz_cvtps_pd(halfLanes, _mm256_loadu_ps(src));
+    high = _mm512_maskz_cvtps_pd(halfLanes, _mm256_loadu_ps(src + 8));
+  }
+
+  static constexpr __mmask16
+      allLanes = 0xFFFF;      ///< Mask selecting the 16 lanes
+
+  static constexpr __mmask8
+      halfLanes = 0xFF;       ///< Mask selecting the 8 lanes of a double
+                              ///< vector
+
+  /// \brief Private function. Convert to float with AVX2
+  /// \param src Source pixels
+  /// \param dest Destination pixels
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  __attribute__((target("avx2")))
+  static void convertAVX2(const FileType *src, float *dest, size_t nbPixels,
+                          float scale, float offset) {
+    size_t pixel = 0;
+    const __m256
+        scaleV = _mm256_set1_ps(scale),
+        offsetV = _mm256_set1_ps(offset);
+    for (; pixel + 8 <= nbPixels; pixel += 8) {
+      _mm256_storeu_ps(dest + pixel,
+                       _mm256_add_ps(_mm256_mul_ps(load8(src + pixel), scaleV),
+                                     offsetV));
+    }
+    for (; pixel < nbPixels; ++pixel) {
+      dest[pixel] = (float) src[pixel] * scale + offset;
+    }
+  }
+
+  /// \brief Private function. Convert to double with AVX2
+  /// \param src Source pixels
+  /// \param dest Destination pixels
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  __attribute__((target("avx2")))
+  static void convertAVX2(const FileType *src, double *dest, size_t nbPixels,
+                          double scale, double offset) {
+    size_t pixel = 0;
+    const __m256d
+        scaleV = _mm256_set1_pd(scale),
+        offsetV = _mm256_set1_pd(offset);
+    __m256d low, high;
+    for (; pixel + 8 <= nbPixels; pixel += 8) {
+      load8(src + pixel, low, high);
+      _mm256_storeu_pd(dest + pixel,
+                       _mm256_add_pd(_mm256_mul_pd(low, scaleV), offsetV));
+      _mm256_storeu_pd(dest + pixel + 4,
+                       _mm256_add_pd(_mm256_mul_pd(high, scaleV), offsetV));
+    }
+    for (; pixel < nbPixels; ++pixel) {
+      dest[pixel] = (double) src[pixel] * scale + offset;
+    }
+  }
+
+  /// \brief Private function. Widen to 32 bits integers with AVX2
+  /// \tparam Integer 32 bits integer target
+  /// \param src Source pixels
+  /// \param dest Destination pixels
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Not used, the integer targets are only widened
+  /// \param offset Not used, the integer targets are only widened
+  template<typename Integer>
+  __attribute__((target("avx2")))
+  static void convertAVX2(const FileType *src, Integer *dest, size_t nbPixels,
+                          double scale, double offset) {
+    size_t pixel = 0;
+    for (; pixel + 8 <= nbPixels; pixel += 8) {
+      _mm256_storeu_si256((__m256i *) (dest + pixel), widen8(src + pixel));
+    }
+    for (; pixel < nbPixels; ++pixel) { dest[pixel] = (Integer) src[pixel]; }
+  }
+
+  /// \brief Private function. Convert to float with AVX-512
+  /// \param src Source pixels
+  /// \param dest Destination pixels
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  __attribute__((target("avx512f")))
+  static void convertAVX512(const FileType *src, float *dest, size_t nbPixels,
+                            float scale, float offset) {
+    size_t pixel = 0;
+    const __m512
+        scaleV = _mm512_set1_ps(scale),
+        offsetV = _mm512_set1_ps(offset);
+    for (; pixel + 16 <= nbPixels; pixel += 16) {
+      _mm512_storeu_ps(dest + pixel,
+                       _mm512_add_ps(_mm512_mul_ps(load16(src + pixel),
+                                                   scaleV), offsetV));
+    }
+    if (pixel < nbPixels) {
+      convertAVX2(src + pixel, dest + pixel, nbPixels - pixel, scale, offset);
+    }
+  }
+
+  /// \brief Private function. Convert to double with AVX-512
+  /// \param src Source pixels
+  /// \param dest Destination pixels
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Scale applied to each pixel
+  /// \param offset Offset added to each pixel after the scale
+  __attribute__((target("avx512f")))
+  static void convertAVX512(const FileType *src, double *dest,
+                            size_t nbPixels, double scale, double offset) {
+    size_t pixel = 0;
+    const __m512d
+        scaleV = _mm512_set1_pd(scale),
+        offsetV = _mm512_set1_pd(offset);
+    __m512d low, high;
+    for (; pixel + 16 <= nbPixels; pixel += 16) {
+      load16(src + pixel, low, high);
+      _mm512_storeu_pd(dest + pixel,
+                       _mm512_add_pd(_mm512_mul_pd(low, scaleV), offsetV));
+      _mm512_storeu_pd(dest + pixel + 8,
+                       _mm512_add_pd(_mm512_mul_pd(high, scaleV), offsetV));
+    }
+    if (pixel < nbPixels) {
+      convertAVX2(src + pixel, dest + pixel, nbPixels - pixel, scale, offset);
+    }
+  }
+
+  /// \brief Private function. Widen to 32 bits integers with AVX-512
+  /// \tparam Integer 32 bits integer target
+  /// \param src Source pixels
+  /// \param dest Destination pixels
+  /// \param nbPixels Number of pixels to convert
+  /// \param scale Not used, the integer targets are only widened
+  /// \param offset Not used, the integer targets are only widened
+  template<typename Integer>
+  __attribute__((target("avx512f")))
+  static void convertAVX512(const FileType *src, Integer *dest,
+                            size_t nbPixels, double scale, double offset) {
+    size_t pixel = 0;
+    for (; pixel + 16 <= nbPixels; pixel += 16) {
+      _mm512_storeu_si512(dest + pixel, widen16(src + pixel));
+    }
+    if (pixel < nbPixels) {
+      convertAVX2(src + pixel, dest + pixel, nbPixels - pixel, scale, offset);
+    }
+  }
+#endif
+};
+
+/// \brief Test if a type is the file pixel type
+/// \tparam T Type to test
+/// \param sampleFormat Sample format as defined by libtiff (1: unsigned
+/// integer, 2: signed integer, 3: floating point)
+/// \param bitsPerSample Number of bits per sample
+/// \return True if the file pixels are T, else False
+template<typename T>
+bool isPixelType(short sampleFormat, short bitsPerSample) {
+  if (sizeof(T) * 8 != (size_t) bitsPerSample) { return false; }
+  switch (sampleFormat) {
+    case 1:return std::is_integral<T>::value && std::is_unsigned<T>::value;
+    case 2:return std::is_integral<T>::value && std::is_signed<T>::value;
+    case 3:return std::is_floating_point<T>::value;
+    default:return false;
+  }
+}
+
+/// \brief Convert a buffer of pixels which type is only known at runtime to
+/// the user type, with fi::PixelConverter
+/// \tparam UserType Pixel type asked by the end user
+/// \param src Source pixels
+/// \param dest Destination pixels, can not overlap the source
+/// \param nbPixels Number of pixels to convert
+/// \param sampleFormat Sample format as defined by libtiff (1: unsigned
+/// integer, 2: signed integer, 3: floating point)
+/// \param bitsPerSample Number of bits per sample
+/// \param scale Scale applied to each pixel
+/// \param offset Offset added to each pixel after the scale
+template<typename UserType>
+void convertPixels(const void *src,
+                   UserType *dest,
+                   size_t nbPixels,
+                   short sampleFormat,
+                   short bitsPerSample,
+                   double scale = 1.,
+                   double offset = 0.) {
+  std::stringstream message;
+  switch (sampleFormat) {
+    case 1 :
+      switch (bitsPerSample) {
+        case 8:
+          PixelConverter<uint8_t, UserType>::convert(
+              (const uint8_t *) src, dest, nbPixels, scale, offset);
+          break;
+        case 16:
+          PixelConverter<uint16_t, UserType>::convert(
+              (const uint16_t *) src, dest, nbPixels, scale, offset);
+          break;
+        case 32:
+          PixelConverter<uint32_t, UserType>::convert(
+              (const uint32_t *) src, dest, nbPixels, scale, offset);
+          break;
+        case 64:
+          PixelConverter<uint64_t, UserType>::convert(
+              (const uint64_t *) src, dest, nbPixels, scale, offset);
+          break;
+        default:
+          message
+              << "Tile Loader ERROR: The data format is not supported for "
+                 "unsigned integer, number bits per pixel = "
+              << bitsPerSample;
+          std::string m = message.str();
+          throw (FastImageException(m));
+      }
+      break;
+    case 2:
+      switch (bitsPerSample) {
+        case 8:
+          PixelConverter<int8_t, UserType>::convert(
+              (const int8_t *) src, dest, nbPixels, scale, offset);
+          break;
+        case 16:
+          PixelConverter<int16_t, UserType>::convert(
+              (const int16_t *) src, dest, nbPixels, scale, offset);
+          break;
+        case 32:
+          PixelConverter<int32_t, UserType>::convert(
+              (const int32_t *) src, dest, nbPixels, scale, offset);
+          break;
+        case 64:
+          PixelConverter<int64_t, UserType>::convert(
+              (const int64_t *) src, dest, nbPixels, scale, offset);
+          break;
+        default:
+          message
+              << "Tile Loader ERROR: The data format is not supported for "
+                 "signed integer, number bits per pixel = "
+              << bitsPerSample;
+          std::string m = message.str();
+          throw (FastImageException(m));
+      }
+      break;
+    case 3:
+      switch (bitsPerSample) {
+        case 32:
+          PixelConverter<float, UserType>::convert(
+              (const float *) src, dest, nbPixels, scale, offset);
+          break;
+        case 64:
+          PixelConverter<double, UserType>::convert(
+              (const double *) src, dest, nbPixels, scale, offset);
+          break;
+        default:
+          message
+              << "Tile Loader ERROR: The data format is not supported for "
+                 "float, number bits per pixel = " << bitsPerSample;
+          std::string m = message.str();
+          throw (FastImageException(m));
+      }
+      break;
+    default:
+      message
+          << "Tile Loader ERROR: The data format is not supported, sample "
+             "format = " << sampleFormat;
+      std::string m = message.str();
+      throw (FastImageException(m));
+  }
+}
+}
+#endif //FASTIMAGE_PIXELCONVERTER_H
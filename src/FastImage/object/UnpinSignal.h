@@ -0,0 +1,107 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+/// @file UnpinSignal.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Signal of the tiles of a cache shard no longer pinned
+
+#ifndef FASTIMAGE_UNPINSIGNAL_H
+#define FASTIMAGE_UNPINSIGNAL_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class UnpinSignal UnpinSignal.h <FastImage/object/UnpinSignal.h>
+  *
+  * @brief Signal a tile of a cache shard is no longer pinned, to the loaders
+  * waiting for a tile to recycle.
+  *
+  * @details Every tile of a shard pinned, a loader waits on the signal with
+  * the shard lock, instead of spinning on it. A tile whose last pin is
+  * released notifies the signal. The signal counts the notifications: a
+  * loader reads the count before looking for a tile to recycle, and only
+  * waits while the count has not changed, so a tile released in between
+  * is not missed. The shard lock is only taken by the notification if a
+  * loader is waiting.
+  **/
+class UnpinSignal {
+ public:
+  /// \brief UnpinSignal constructor
+  /// \param mutex Shard mutex, held by the loaders waiting
+  explicit UnpinSignal(std::mutex &mutex) : _mutex(mutex) {}
+
+  /// \brief Get the number of notifications, to give to wait
+  /// \return Number of notifications
+  uint64_t getNbNotifications() const { return _nbNotifications.load(); }
+
+  /// \brief Wait for a notification after the ones counted
+  /// \param lock Lock on the shard mutex, released while waiting
+  /// \param nbNotifications Number of notifications read before looking for
+  /// a tile to recycle
+  void wait(std::unique_lock<std::mutex> &lock, uint64_t nbNotifications) {
+    ++_nbWaiting;
+    _condition.wait(lock, [this, nbNotifications]() {
+      return _nbNotifications.load() != nbNotifications;
+    });
+    --_nbWaiting;
+  }
+
+  /// \brief Notify the loaders waiting, a tile is no longer pinned or the
+  /// shard has new tiles
+  void notify() {
+    ++_nbNotifications;
+    if (_nbWaiting.load() > 0) {
+      // A loader between its check and its wait holds the lock
+      { std::lock_guard<std::mutex> lock(_mutex); }
+      _condition.notify_all();
+    }
+  }
+
+ private:
+  std::mutex
+      &_mutex;                        ///< Shard mutex
+
+  std::condition_variable
+      _condition;                     ///< Condition of the loaders waiting
+
+  std::atomic<uint64_t>
+      _nbNotifications{0};            ///< Number of notifications
+
+  std::atomic<uint32_t>
+      _nbWaiting{0};                  ///< Number of loaders waiting
+};
+}
+
+#endif //FASTIMAGE_UNPINSIGNAL_H
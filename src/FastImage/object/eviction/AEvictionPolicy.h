@@ -0,0 +1,155 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file AEvictionPolicy.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Interface of the eviction policies used by the Fast Image cache
+
+#ifndef FASTIMAGE_AEVICTIONPOLICY_H
+#define FASTIMAGE_AEVICTIONPOLICY_H
+
+#include <list>
+#include <string>
+
+#include "FastImage/data/CachedTile.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class AEvictionPolicy AEvictionPolicy.h <FastImage/object/eviction/AEvictionPolicy.h>
+  *
+  * @brief Eviction policy interface used by a fi::FigCacheShard.
+  *
+  * @details The policy tracks the tiles stored in a cache shard, and chooses
+  * the tile to recycle when the shard is full. All the functions are called
+  * while the shard is locked. A pinned tile is in use and can not be chosen.
+  * The new policies have to override and implement the following functions:
+  * \code
+  *     virtual std::string getName() const = 0;
+  *     virtual void tileInserted(CachedTile<UserType> *tile) = 0;
+  *     virtual void tileAccessed(CachedTile<UserType> *tile) = 0;
+  *     virtual CachedTile<UserType> *selectVictim(uint32_t indexRow,
+  *                                                uint32_t indexCol) = 0;
+  *     virtual std::list<CachedTile<UserType> *> getOrder() const = 0;
+  * \endcode
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class AEvictionPolicy {
+ public:
+  /// \brief Default destructor
+  virtual ~AEvictionPolicy() = default;
+
+  /// \brief Initialize the policy
+  /// \param capacity Number of tiles in the shard
+  /// \param numTilesWidth Number of tiles in a row of the image
+  virtual void init(uint32_t capacity, uint32_t numTilesWidth) {
+    _capacity = capacity;
+    _numTilesWidth = numTilesWidth;
+  }
+
+  /// \brief Change the number of tiles in the shard, when the cache is
+  /// resized
+  /// \param capacity Number of tiles in the shard
+  virtual void setCapacity(uint32_t capacity) { _capacity = capacity; }
+
+  /// \brief Get the policy name
+  /// \return Policy name
+  virtual std::string getName() const = 0;
+
+  /// \brief A tile not in the shard has been stored
+  /// \param tile Tile stored
+  virtual void tileInserted(CachedTile<UserType> *tile) = 0;
+
+  /// \brief A tile in the shard has been accessed
+  /// \param tile Tile accessed
+  virtual void tileAccessed(CachedTile<UserType> *tile) = 0;
+
+  /// \brief Choose a tile to recycle, and stop tracking it
+  /// \param indexRow Row index of the tile which will be stored
+  /// \param indexCol Col index of the tile which will be stored
+  /// \return The tile to recycle, nullptr if all tiles are pinned
+  virtual CachedTile<UserType> *selectVictim(uint32_t indexRow,
+                                             uint32_t indexCol) = 0;
+
+  /// \brief Choose a tile to delete when the shard shrinks, no tile being
+  /// stored in its place, and stop tracking it
+  /// \return The tile to delete, nullptr if all tiles are pinned
+  virtual CachedTile<UserType> *selectVictimToShrink() {
+    return selectVictim(0, 0);
+  }
+
+  /// \brief Get the tracked tiles, from the first to keep to the first to
+  /// recycle
+  /// \return Tracked tiles
+  virtual std::list<CachedTile<UserType> *> getOrder() const = 0;
+
+  /// \brief Test if the policy uses the future accesses
+  /// \return True if the policy needs the future accesses, else False
+  virtual bool needsFutureAccesses() const { return false; }
+
+  /// \brief Register a future access to a tile
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param position Position of the access in the sequence of accesses
+  virtual void addFutureAccess(uint32_t indexRow,
+                               uint32_t indexCol,
+                               uint64_t position) {}
+
+  /// \brief Set the position of the access notified next by tileInserted or
+  /// tileAccessed, used by the policies needing the future accesses
+  /// \param position Position of the access in the sequence of accesses, max
+  /// uint64_t if the access has not been registered
+  virtual void setAccessPosition(uint64_t position) {}
+
+ protected:
+  /// \brief Get a unique key for a tile index
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return Tile key
+  uint64_t tileKey(uint32_t indexRow, uint32_t indexCol) const {
+    return (uint64_t) indexRow * _numTilesWidth + indexCol;
+  }
+
+  /// \brief Get a unique key for a tile
+  /// \param tile Tile
+  /// \return Tile key
+  uint64_t tileKey(const CachedTile<UserType> *tile) const {
+    return tileKey(tile->getIndexRowGlobal(), tile->getIndexColGlobal());
+  }
+
+  uint32_t
+      _capacity = 0,          ///< Number of tiles in the shard
+      _numTilesWidth = 0;     ///< Number of tiles in a row of the image
+};
+}
+#endif //FASTIMAGE_AEVICTIONPOLICY_H
@@ -0,0 +1,268 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file ARCPolicy.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Adaptive Replacement Cache eviction policy
+
+#ifndef FASTIMAGE_ARCPOLICY_H
+#define FASTIMAGE_ARCPOLICY_H
+
+#include <unordered_map>
+#include <algorithm>
+
+#include "FastImage/object/eviction/AEvictionPolicy.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class ARCPolicy ARCPolicy.h <FastImage/object/eviction/ARCPolicy.h>
+  *
+  * @brief Adaptive Replacement Cache (ARC) eviction policy.
+  *
+  * @details Implementation of the ARC policy from N. Megiddo and D. Modha,
+  * "ARC: A Self-Tuning, Low Overhead Replacement Cache", FAST 2003.
+  * The tiles seen once are kept in T1, the tiles seen at least twice in T2.
+  * The keys of the tiles recently evicted from T1 and T2 are kept in the ghost
+  * lists B1 and B2. A miss on a ghost key moves the target size of T1 toward
+  * recency (B1) or frequency (B2). A scan of the image only goes through T1
+  * and does not flush the tiles often accessed, kept in T2.
+  * The tile's eviction bit is set when the tile is in T2.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class ARCPolicy : public AEvictionPolicy<UserType> {
+  using CachedTileType = CachedTile<UserType> *;
+  using TileList = std::list<CachedTileType>;
+  using KeyList = std::list<uint64_t>;
+
+  /// \brief Position of a tile key in the ghost lists
+  enum class Ghost { NONE, B1, B2 };
+
+ public:
+  /// \brief Change the number of tiles in the shard, the target size of T1
+  /// and the ghost lists are bounded by the new capacity
+  /// \param capacity Number of tiles in the shard
+  void setCapacity(uint32_t capacity) override {
+    AEvictionPolicy<UserType>::setCapacity(capacity);
+    _p = std::min(_p, (double) capacity);
+    trimGhosts();
+  }
+
+  /// \brief Get the policy name
+  /// \return Policy name
+  std::string getName() const override { return "ARC"; }
+
+  /// \brief Store the tile in T1, or in T2 if its key was in a ghost list
+  /// \param tile Tile stored
+  void tileInserted(CachedTileType tile) override {
+    uint64_t key = this->tileKey(tile);
+    Ghost ghost;
+    if (_adapted && _adaptedKey == key) {
+      ghost = _adaptedGhost;
+    } else {
+      // The shard was not full, no victim has been selected
+      ghost = adapt(key);
+      if (ghost == Ghost::NONE) { trimGhosts(); }
+    }
+    _adapted = false;
+
+    if (ghost == Ghost::NONE) {
+      push(_t1, tile, false);
+    } else {
+      removeGhost(key);
+      push(_t2, tile, true);
+    }
+  }
+
+  /// \brief Move the tile at the front of T2
+  /// \param tile Tile accessed
+  void tileAccessed(CachedTileType tile) override {
+    auto it = _mapTiles.at(tile);
+    (tile->getEvictionBit() ? _t2 : _t1).erase(it);
+    push(_t2, tile, true);
+  }
+
+  /// \brief Adapt the T1 target size and select the tile to recycle
+  /// \param indexRow Row index of the tile which will be stored
+  /// \param indexCol Col index of the tile which will be stored
+  /// \return The tile to recycle, nullptr if all tiles are pinned
+  CachedTileType selectVictim(uint32_t indexRow, uint32_t indexCol) override {
+    uint64_t key = this->tileKey(indexRow, indexCol);
+    if (!(_adapted && _adaptedKey == key)) {
+      _adaptedGhost = adapt(key);
+      _adaptedKey = key;
+      _adapted = true;
+    }
+
+    if (_adaptedGhost == Ghost::NONE) {
+      if (_t1.size() + _b1.size() >= this->_capacity) {
+        if (!_b1.empty()) {
+          removeGhost(_b1.back());
+        } else {
+          // T1 fills the shard, evict its LRU tile without ghost
+          CachedTileType victim = popUnpinned(_t1);
+          if (victim != nullptr) { return victim; }
+        }
+      } else if (_t1.size() + _t2.size() + _b1.size() + _b2.size()
+          >= 2 * this->_capacity && !_b2.empty()) {
+        removeGhost(_b2.back());
+      }
+    }
+    return replace(_adaptedGhost == Ghost::B2);
+  }
+
+  /// \brief Evict a tile following the target size of T1, without adapting
+  /// it as no tile is stored in its place
+  /// \return The tile to delete, nullptr if all tiles are pinned
+  CachedTileType selectVictimToShrink() override { return replace(false); }
+
+  /// \brief Get the tiles of T2 then T1, from the most recently used
+  /// \return The tiles tracked
+  std::list<CachedTileType> getOrder() const override {
+    std::list<CachedTileType> order(_t2);
+    order.insert(order.end(), _t1.begin(), _t1.end());
+    return order;
+  }
+
+  /// \brief Get the target size of T1
+  /// \return Target size of T1
+  double getTargetT1() const { return _p; }
+
+ private:
+  /// \brief Adapt the target size of T1 if the key is in a ghost list
+  /// \param key Tile key missed
+  /// \return The ghost list the key is in
+  Ghost adapt(uint64_t key) {
+    auto it = _mapGhosts.find(key);
+    if (it == _mapGhosts.end()) { return Ghost::NONE; }
+    if (it->second.first == Ghost::B1) {
+      _p = std::min((double) this->_capacity,
+                    _p + std::max((double) _b2.size() / _b1.size(), 1.));
+    } else {
+      _p = std::max(0., _p - std::max((double) _b1.size() / _b2.size(), 1.));
+    }
+    return it->second.first;
+  }
+
+  /// \brief Evict a tile from T1 or T2 following the target size of T1, and
+  /// keep its key in the matching ghost list
+  /// \param inB2 True if the tile missed is in B2
+  /// \return The tile to recycle, nullptr if all tiles are pinned
+  CachedTileType replace(bool inB2) {
+    bool fromT1 = !_t1.empty()
+        && ((double) _t1.size() > _p || (inB2 && (double) _t1.size() == _p));
+    CachedTileType victim = popUnpinned(fromT1 ? _t1 : _t2);
+    if (victim == nullptr) {
+      fromT1 = !fromT1;
+      victim = popUnpinned(fromT1 ? _t1 : _t2);
+    }
+    if (victim != nullptr) {
+      KeyList &ghost = fromT1 ? _b1 : _b2;
+      ghost.push_front(this->tileKey(victim));
+      _mapGhosts[ghost.front()] =
+          std::make_pair(fromT1 ? Ghost::B1 : Ghost::B2, ghost.begin());
+      trimGhosts();
+    }
+    return victim;
+  }
+
+  /// \brief Keep at most capacity keys in the ghost lists
+  void trimGhosts() {
+    while (_b1.size() + _b2.size() > this->_capacity) {
+      removeGhost(_b1.size() > _b2.size() ? _b1.back() : _b2.back());
+    }
+  }
+
+  /// \brief Remove a key from the ghost lists
+  /// \param key Key to remove
+  void removeGhost(uint64_t key) {
+    auto it = _mapGhosts.find(key);
+    if (it == _mapGhosts.end()) { return; }
+    (it->second.first == Ghost::B1 ? _b1 : _b2).erase(it->second.second);
+    _mapGhosts.erase(it);
+  }
+
+  /// \brief Push a tile at the front of T1 or T2
+  /// \param list T1 or T2
+  /// \param tile Tile to push
+  /// \param inT2 True if list is T2
+  void push(TileList &list, CachedTileType tile, bool inT2) {
+    list.push_front(tile);
+    _mapTiles[tile] = list.begin();
+    tile->setEvictionBit(inT2);
+  }
+
+  /// \brief Remove the least recently used tile not pinned from T1 or T2
+  /// \param list T1 or T2
+  /// \return The tile removed, nullptr if all tiles are pinned
+  CachedTileType popUnpinned(TileList &list) {
+    auto it = std::find_if(list.rbegin(), list.rend(),
+                           [](CachedTileType tile) {
+                             return !tile->isPinned();
+                           });
+    if (it == list.rend()) { return nullptr; }
+    CachedTileType tile = *it;
+    list.erase(std::next(it).base());
+    _mapTiles.erase(tile);
+    return tile;
+  }
+
+  TileList
+      _t1,                    ///< Resident tiles seen once
+      _t2;                    ///< Resident tiles seen at least twice
+
+  KeyList
+      _b1,                    ///< Keys recently evicted from T1
+      _b2;                    ///< Keys recently evicted from T2
+
+  std::unordered_map<CachedTileType, typename TileList::iterator>
+      _mapTiles;              ///< Position of the resident tiles
+
+  std::unordered_map<uint64_t, std::pair<Ghost, typename KeyList::iterator>>
+      _mapGhosts;             ///< Position of the ghost keys
+
+  double
+      _p = 0;                 ///< Target size of T1
+
+  uint64_t
+      _adaptedKey = 0;        ///< Key adapted by the last victim selection
+
+  Ghost
+      _adaptedGhost = Ghost::NONE; ///< Ghost list of the adapted key
+
+  bool
+      _adapted = false;       ///< True if a key has been adapted and not yet
+                              ///< inserted
+};
+}
+#endif //FASTIMAGE_ARCPOLICY_H
@@ -0,0 +1,152 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file ClockPolicy.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief CLOCK eviction policy
+
+#ifndef FASTIMAGE_CLOCKPOLICY_H
+#define FASTIMAGE_CLOCKPOLICY_H
+
+#include <vector>
+
+#include "FastImage/object/eviction/AEvictionPolicy.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class ClockPolicy ClockPolicy.h <FastImage/object/eviction/ClockPolicy.h>
+  *
+  * @brief CLOCK eviction policy, a LRU approximation.
+  *
+  * @details The tiles are stored in a fixed array of slots, the slot index and
+  * the reference bit being stored in the tile itself. A hit only sets the
+  * reference bit. To find a victim, the clock hand sweeps the slots, clearing
+  * the reference bits, until it finds a tile not referenced and not pinned.
+  * No memory is allocated after the initialization.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class ClockPolicy : public AEvictionPolicy<UserType> {
+  using CachedTileType = CachedTile<UserType> *;
+ public:
+  /// \brief Allocate the slots
+  /// \param capacity Number of tiles in the shard
+  /// \param numTilesWidth Number of tiles in a row of the image
+  void init(uint32_t capacity, uint32_t numTilesWidth) override {
+    AEvictionPolicy<UserType>::init(capacity, numTilesWidth);
+    _slots.assign(capacity, nullptr);
+    _freeSlots.clear();
+    _freeSlots.reserve(capacity);
+    for (uint32_t slot = capacity; slot > 0; --slot) {
+      _freeSlots.push_back(slot - 1);
+    }
+    _hand = 0;
+  }
+
+  /// \brief Add the slots needed by a larger capacity, the slots are kept
+  /// when the capacity decreases
+  /// \param capacity Number of tiles in the shard
+  void setCapacity(uint32_t capacity) override {
+    AEvictionPolicy<UserType>::setCapacity(capacity);
+    for (auto slot = (uint32_t) _slots.size(); slot < capacity; ++slot) {
+      _slots.push_back(nullptr);
+      _freeSlots.push_back(slot);
+    }
+  }
+
+  /// \brief Get the policy name
+  /// \return Policy name
+  std::string getName() const override { return "CLOCK"; }
+
+  /// \brief Store the tile in a free slot
+  /// \param tile Tile stored
+  void tileInserted(CachedTileType tile) override {
+    assert(!_freeSlots.empty());
+    uint32_t slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    _slots[slot] = tile;
+    tile->setEvictionIndex(slot);
+    tile->setEvictionBit(false);
+  }
+
+  /// \brief Set the tile's reference bit
+  /// \param tile Tile accessed
+  void tileAccessed(CachedTileType tile) override {
+    tile->setEvictionBit(true);
+  }
+
+  /// \brief Sweep the slots to find a tile not referenced and not pinned
+  /// \param indexRow Not used
+  /// \param indexCol Not used
+  /// \return The tile to recycle, nullptr if all tiles are pinned
+  CachedTileType selectVictim(uint32_t indexRow, uint32_t indexCol) override {
+    // Two turns clear every reference bit
+    for (size_t step = 0; step < 2 * _slots.size(); ++step) {
+      uint32_t slot = _hand;
+      _hand = (_hand + 1) % (uint32_t) _slots.size();
+      CachedTileType tile = _slots[slot];
+      if (tile == nullptr || tile->isPinned()) { continue; }
+      if (tile->getEvictionBit()) {
+        tile->setEvictionBit(false);
+        continue;
+      }
+      _slots[slot] = nullptr;
+      _freeSlots.push_back(slot);
+      return tile;
+    }
+    return nullptr;
+  }
+
+  /// \brief Get the tiles from the clock hand
+  /// \return The tiles from the clock hand
+  std::list<CachedTileType> getOrder() const override {
+    std::list<CachedTileType> order;
+    for (size_t step = 0; step < _slots.size(); ++step) {
+      auto tile = _slots[(_hand + step) % _slots.size()];
+      if (tile != nullptr) { order.push_front(tile); }
+    }
+    return order;
+  }
+
+ private:
+  std::vector<CachedTileType>
+      _slots;                 ///< Slots of tiles swept by the clock hand
+
+  std::vector<uint32_t>
+      _freeSlots;             ///< Slots available
+
+  uint32_t
+      _hand = 0;              ///< Clock hand
+};
+}
+#endif //FASTIMAGE_CLOCKPOLICY_H
@@ -0,0 +1,107 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file LRUPolicy.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Least Recently Used eviction policy
+
+#ifndef FASTIMAGE_LRUPOLICY_H
+#define FASTIMAGE_LRUPOLICY_H
+
+#include <unordered_map>
+#include <algorithm>
+
+#include "FastImage/object/eviction/AEvictionPolicy.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class LRUPolicy LRUPolicy.h <FastImage/object/eviction/LRUPolicy.h>
+  *
+  * @brief Least Recently Used eviction policy, the default policy.
+  *
+  * @details The tiles are kept in a list from the most to the least recently
+  * used. A hit moves the tile's node at the front of the list, without
+  * allocation.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class LRUPolicy : public AEvictionPolicy<UserType> {
+  using CachedTileType = CachedTile<UserType> *;
+ public:
+  /// \brief Get the policy name
+  /// \return Policy name
+  std::string getName() const override { return "LRU"; }
+
+  /// \brief Put the new tile at the front of the LRU
+  /// \param tile Tile stored
+  void tileInserted(CachedTileType tile) override {
+    _lru.push_front(tile);
+    _mapLRU[tile] = _lru.begin();
+  }
+
+  /// \brief Move the tile at the front of the LRU
+  /// \param tile Tile accessed
+  void tileAccessed(CachedTileType tile) override {
+    _lru.splice(_lru.begin(), _lru, _mapLRU.at(tile));
+  }
+
+  /// \brief Get the least recently used tile not pinned
+  /// \param indexRow Not used
+  /// \param indexCol Not used
+  /// \return The tile to recycle, nullptr if all tiles are pinned
+  CachedTileType selectVictim(uint32_t indexRow, uint32_t indexCol) override {
+    auto itLru = std::find_if(_lru.rbegin(), _lru.rend(),
+                              [](CachedTileType tile) {
+                                return !tile->isPinned();
+                              });
+    if (itLru == _lru.rend()) { return nullptr; }
+    CachedTileType toRecycle = *itLru;
+    _lru.erase(std::next(itLru).base());
+    _mapLRU.erase(toRecycle);
+    return toRecycle;
+  }
+
+  /// \brief Get the LRU list
+  /// \return The LRU list
+  std::list<CachedTileType> getOrder() const override { return _lru; }
+
+ private:
+  std::unordered_map<CachedTileType,
+                     typename std::list<CachedTileType>::iterator>
+      _mapLRU;                ///< Map between the Tile and it's position
+
+  std::list<CachedTileType>
+      _lru;                   ///< List to save the Tile order
+};
+}
+#endif //FASTIMAGE_LRUPOLICY_H
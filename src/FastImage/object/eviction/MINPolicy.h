@@ -0,0 +1,191 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file MINPolicy.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Belady's MIN eviction policy, based on the known future accesses
+
+#ifndef FASTIMAGE_MINPOLICY_H
+#define FASTIMAGE_MINPOLICY_H
+
+#include <unordered_map>
+#include <deque>
+#include <set>
+#include <limits>
+#include <algorithm>
+
+#include "FastImage/object/eviction/AEvictionPolicy.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class MINPolicy MINPolicy.h <FastImage/object/eviction/MINPolicy.h>
+  *
+  * @brief Belady's MIN eviction policy.
+  *
+  * @details The tile to recycle is the one which will be accessed the
+  * farthest in the future. As the traversal is known when the views are
+  * requested, the future tile accesses are registered with addFutureAccess().
+  * A tile access given its position (setAccessPosition) consumes the
+  * accesses registered for this tile up to this position. An access not
+  * registered, as a region request, consumes nothing: the tile keeps its
+  * next registered access. An access registered while its tile is already
+  * in the shard, as the accesses of the views requested while the graph is
+  * loading, becomes the tile's next access if it comes first. A tile with no
+  * registered future access is recycled first.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class MINPolicy : public AEvictionPolicy<UserType> {
+  using CachedTileType = CachedTile<UserType> *;
+  using NextUse = std::pair<uint64_t, CachedTileType>;
+ public:
+  /// \brief Get the policy name
+  /// \return Policy name
+  std::string getName() const override { return "MIN"; }
+
+  /// \brief Track the new tile with its next access
+  /// \param tile Tile stored
+  void tileInserted(CachedTileType tile) override {
+    uint64_t nextUse = consumeAccess(tile);
+    _nextUses.emplace(nextUse, tile);
+    _mapNextUse[tile] = nextUse;
+    _residentTiles[this->tileKey(tile)] = tile;
+  }
+
+  /// \brief Update the next access of the tile
+  /// \param tile Tile accessed
+  void tileAccessed(CachedTileType tile) override {
+    _nextUses.erase(NextUse(_mapNextUse.at(tile), tile));
+    tileInserted(tile);
+  }
+
+  /// \brief Get the tile not pinned accessed the farthest in the future
+  /// \param indexRow Not used
+  /// \param indexCol Not used
+  /// \return The tile to recycle, nullptr if all tiles are pinned
+  CachedTileType selectVictim(uint32_t indexRow, uint32_t indexCol) override {
+    auto it = std::find_if(_nextUses.rbegin(), _nextUses.rend(),
+                           [](const NextUse &nextUse) {
+                             return !nextUse.second->isPinned();
+                           });
+    if (it == _nextUses.rend()) { return nullptr; }
+    CachedTileType toRecycle = it->second;
+    _nextUses.erase(std::next(it).base());
+    _mapNextUse.erase(toRecycle);
+    _residentTiles.erase(this->tileKey(toRecycle));
+    return toRecycle;
+  }
+
+  /// \brief Get the tiles, from the next accessed
+  /// \return The tiles tracked
+  std::list<CachedTileType> getOrder() const override {
+    std::list<CachedTileType> order;
+    for (auto &nextUse : _nextUses) { order.push_back(nextUse.second); }
+    return order;
+  }
+
+  /// \brief The policy needs the future accesses
+  /// \return True
+  bool needsFutureAccesses() const override { return true; }
+
+  /// \brief Register a future access to a tile
+  /// \details If the tile is in the shard and this access comes before its
+  /// next one, the tile is moved to its new next access.
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param position Position of the access in the sequence of accesses
+  void addFutureAccess(uint32_t indexRow,
+                       uint32_t indexCol,
+                       uint64_t position) override {
+    uint64_t key = this->tileKey(indexRow, indexCol);
+    _futureAccesses[key].push_back(position);
+    auto resident = _residentTiles.find(key);
+    if (resident == _residentTiles.end()) { return; }
+    CachedTileType tile = resident->second;
+    uint64_t &nextUse = _mapNextUse.at(tile);
+    if (position < nextUse) {
+      _nextUses.erase(NextUse(nextUse, tile));
+      nextUse = position;
+      _nextUses.emplace(nextUse, tile);
+    }
+  }
+
+  /// \brief Set the position of the access notified next
+  /// \param position Position of the access in the sequence of accesses, max
+  /// uint64_t if the access has not been registered
+  void setAccessPosition(uint64_t position) override {
+    _accessPosition = position;
+  }
+
+ private:
+  /// \brief Consume the accesses to a tile up to the current access, and get
+  /// its next access
+  /// \details The accesses registered before the current one and never
+  /// made are consumed as well. An access not registered consumes nothing.
+  /// \param tile Tile accessed
+  /// \return Position of the next access, max uint64_t if none
+  uint64_t consumeAccess(CachedTileType tile) {
+    auto it = _futureAccesses.find(this->tileKey(tile));
+    if (it == _futureAccesses.end()) {
+      return std::numeric_limits<uint64_t>::max();
+    }
+    while (!it->second.empty() && it->second.front() <= _accessPosition
+        && _accessPosition != std::numeric_limits<uint64_t>::max()) {
+      it->second.pop_front();
+    }
+    if (it->second.empty()) {
+      _futureAccesses.erase(it);
+      return std::numeric_limits<uint64_t>::max();
+    }
+    return it->second.front();
+  }
+
+  std::unordered_map<uint64_t, std::deque<uint64_t>>
+      _futureAccesses;        ///< Registered accesses per tile key
+
+  std::set<NextUse>
+      _nextUses;              ///< Tiles sorted by next access
+
+  std::unordered_map<CachedTileType, uint64_t>
+      _mapNextUse;            ///< Next access of each tile
+
+  std::unordered_map<uint64_t, CachedTileType>
+      _residentTiles;         ///< Tiles in the shard per tile key
+
+  uint64_t
+      _accessPosition =
+      std::numeric_limits<uint64_t>::max(); ///< Position of the current
+                                            ///< access, max if not registered
+};
+}
+#endif //FASTIMAGE_MINPOLICY_H
@@ -0,0 +1,144 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file AAsyncReader.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Interface of the asynchronous file readers
+
+#ifndef FASTIMAGE_AASYNCREADER_H
+#define FASTIMAGE_AASYNCREADER_H
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "FastImage/exception/FastImageException.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class AAsyncReader AAsyncReader.h <FastImage/object/io/AAsyncReader.h>
+  *
+  * @brief Asynchronous file reader interface used by the fi::RawTileReader.
+  *
+  * @details The reads are queued with read, sent as a batch to the kernel
+  * with submit, and their completions collected with complete. At most
+  * getQueueDepth reads can be pending, the caller has to complete some reads
+  * before queuing more. A reader is used by a single thread.
+  * The new readers have to override and implement the following functions:
+  * \code
+  *     virtual std::string getName() const = 0;
+  *     virtual void read(void *buffer, size_t length, uint64_t offset,
+  *                       uint64_t id) = 0;
+  *     virtual void submit() = 0;
+  *     virtual void complete(std::vector<uint64_t> &ids, bool wait) = 0;
+  * \endcode
+  **/
+class AAsyncReader {
+ public:
+  /// \brief Open the file to read
+  /// \param filePath File path
+  /// \param queueDepth Maximum number of reads pending
+  AAsyncReader(const std::string &filePath, uint32_t queueDepth)
+      : _queueDepth(queueDepth) {
+    _fd = open(filePath.c_str(), O_RDONLY);
+    if (_fd < 0) { throwError("The file can not be opened", errno); }
+  }
+
+  /// \brief Close the file
+  virtual ~AAsyncReader() {
+    if (_fd >= 0) { close(_fd); }
+  }
+
+  AAsyncReader(const AAsyncReader &) = delete;
+  AAsyncReader &operator=(const AAsyncReader &) = delete;
+
+  /// \brief Get the reader name
+  /// \return Reader name
+  virtual std::string getName() const = 0;
+
+  /// \brief Queue a read, sent to the kernel with the next submit
+  /// \param buffer Buffer to read into, has to stay valid until the read
+  /// completion
+  /// \param length Number of bytes to read
+  /// \param offset Offset in the file
+  /// \param id Identifier given back at the read completion
+  virtual void read(void *buffer, size_t length, uint64_t offset,
+                    uint64_t id) = 0;
+
+  /// \brief Send the queued reads to the kernel
+  virtual void submit() = 0;
+
+  /// \brief Collect the completed reads
+  /// \param ids Identifiers of the completed reads, appended
+  /// \param wait If true, block until at least one read completes, if any
+  /// pending
+  virtual void complete(std::vector<uint64_t> &ids, bool wait) = 0;
+
+  /// \brief Get the maximum number of reads pending
+  /// \return Maximum number of reads pending
+  uint32_t getQueueDepth() const { return _queueDepth; }
+
+  /// \brief Get the number of reads queued or in flight
+  /// \return Number of reads queued or in flight
+  uint32_t getNbPending() const { return _nbPending; }
+
+  /// \brief Get the number of reads queued and not submitted
+  /// \return Number of reads queued and not submitted
+  uint32_t getNbQueued() const { return _nbQueued; }
+
+ protected:
+  /// \brief Throw an exception for a failed operation
+  /// \param reason Reason of the error
+  /// \param error Error number
+  static void throwError(const std::string &reason, int error) {
+    std::stringstream message;
+    message << "Async Reader ERROR: " << reason << ": " << strerror(error)
+            << ".";
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  int
+      _fd = -1;             ///< File descriptor
+
+  uint32_t
+      _queueDepth = 0,      ///< Maximum number of reads pending
+      _nbPending = 0,       ///< Number of reads queued or in flight
+      _nbQueued = 0;        ///< Number of reads queued and not submitted
+};
+}
+#endif //FASTIMAGE_AASYNCREADER_H
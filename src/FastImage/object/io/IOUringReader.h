@@ -0,0 +1,318 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file IOUringReader.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Asynchronous file reader using Linux io_uring
+
+#ifndef FASTIMAGE_IOURINGREADER_H
+#define FASTIMAGE_IOURINGREADER_H
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define FASTIMAGE_IO_URING
+#endif
+#endif
+
+#ifdef FASTIMAGE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#include <algorithm>
+#include "FastImage/object/io/AAsyncReader.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class IOUringReader IOUringReader.h <FastImage/object/io/IOUringReader.h>
+  *
+  * @brief Asynchronous file reader using Linux io_uring (kernel 5.1 or
+  * later), without liburing.
+  *
+  * @details The queued reads are written in the submission ring and sent to
+  * the kernel in a single io_uring_enter call. The completions are read from
+  * the completion ring without system call, a system call is only done to
+  * wait for a completion. The short reads are resubmitted for the remaining
+  * bytes.
+  * On other systems, or if io_uring is disabled, isSupported returns false
+  * and the reader can not be created.
+  **/
+class IOUringReader : public AAsyncReader {
+ public:
+  /// \brief Create the io_uring and map its rings
+  /// \param filePath File path
+  /// \param queueDepth Maximum number of reads pending
+  IOUringReader(const std::string &filePath, uint32_t queueDepth)
+      : AAsyncReader(filePath, queueDepth) {
+#ifdef FASTIMAGE_IO_URING
+    io_uring_params params{};
+    _ringFd = (int) syscall(__NR_io_uring_setup, queueDepth, &params);
+    if (_ringFd < 0) { throwError("The io_uring can not be created", errno); }
+
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cqRingSize = params.cq_off.cqes
+        + params.cq_entries * sizeof(io_uring_cqe);
+    // The two rings can share a single mapping since Linux 5.4
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+      _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+    }
+    _sqRing = mapRing(_sqRingSize, IORING_OFF_SQ_RING);
+    _cqRing = singleMap ? _sqRing : mapRing(_cqRingSize, IORING_OFF_CQ_RING);
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = (io_uring_sqe *) mapRing(_sqesSize, IORING_OFF_SQES);
+
+    _sqTail = (uint32_t *) (_sqRing + params.sq_off.tail);
+    _sqMask = *(uint32_t *) (_sqRing + params.sq_off.ring_mask);
+    _sqArray = (uint32_t *) (_sqRing + params.sq_off.array);
+    _cqHead = (uint32_t *) (_cqRing + params.cq_off.head);
+    _cqTail = (uint32_t *) (_cqRing + params.cq_off.tail);
+    _cqMask = *(uint32_t *) (_cqRing + params.cq_off.ring_mask);
+    _cqes = (io_uring_cqe *) (_cqRing + params.cq_off.cqes);
+
+    _reads.resize(queueDepth);
+    for (uint32_t slot = 0; slot < queueDepth; ++slot) {
+      _freeSlots.push_back(queueDepth - 1 - slot);
+    }
+#else
+    throwError("io_uring is not available", ENOSYS);
+#endif
+  }
+
+  /// \brief Wait for the reads in flight, and release the io_uring
+  ~IOUringReader() override {
+#ifdef FASTIMAGE_IO_URING
+    // The kernel may still write into the buffers of the reads in flight
+    std::vector<uint64_t> ids;
+    while (_ringFd >= 0 && _nbPending > _nbQueued) {
+      try { complete(ids, true); } catch (FastImageException &) {}
+    }
+    if (_sqes != nullptr) { munmap(_sqes, _sqesSize); }
+    if (_cqRing != nullptr && _cqRing != _sqRing) {
+      munmap(_cqRing, _cqRingSize);
+    }
+    if (_sqRing != nullptr) { munmap(_sqRing, _sqRingSize); }
+    if (_ringFd >= 0) { close(_ringFd); }
+#endif
+  }
+
+  /// \brief Test if io_uring can be used on this system, tested once
+  /// \return True if io_uring can be used, else False
+  static bool isSupported() {
+#ifdef FASTIMAGE_IO_URING
+    static const bool supported = []() {
+      io_uring_params params{};
+      int fd = (int) syscall(__NR_io_uring_setup, 1, &params);
+      if (fd < 0) { return false; }
+      close(fd);
+      return true;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+  /// \brief Get the reader name
+  /// \return Reader name
+  std::string getName() const override { return "io_uring"; }
+
+  /// \brief Queue a read in the submission ring
+  /// \param buffer Buffer to read into
+  /// \param length Number of bytes to read
+  /// \param offset Offset in the file
+  /// \param id Identifier given back at the read completion
+  void read(void *buffer, size_t length, uint64_t offset,
+            uint64_t id) override {
+#ifdef FASTIMAGE_IO_URING
+    if (_freeSlots.empty()) {
+      throwError("The queue depth is exceeded", EBUSY);
+    }
+    uint32_t slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    _reads[slot].iov.iov_base = buffer;
+    _reads[slot].iov.iov_len = length;
+    _reads[slot].offset = offset;
+    _reads[slot].id = id;
+    queue(slot);
+    ++_nbPending;
+#endif
+  }
+
+  /// \brief Send the queued reads to the kernel
+  void submit() override {
+#ifdef FASTIMAGE_IO_URING
+    if (_nbQueued > 0) { enter(0, 0); }
+#endif
+  }
+
+  /// \brief Collect the completed reads from the completion ring
+  /// \param ids Identifiers of the completed reads, appended
+  /// \param wait If true, block until at least one read completes, if any
+  /// pending
+  void complete(std::vector<uint64_t> &ids, bool wait) override {
+#ifdef FASTIMAGE_IO_URING
+    if (wait && _nbPending > 0
+        && *_cqHead == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE)) {
+      enter(1, IORING_ENTER_GETEVENTS);
+    }
+    uint32_t
+        head = *_cqHead,
+        tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+    int error = 0;
+    for (; head != tail && error == 0; ++head) {
+      io_uring_cqe &cqe = _cqes[head & _cqMask];
+      auto slot = (uint32_t) cqe.user_data;
+      Read &read = _reads[slot];
+      if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+        queue(slot);
+      } else if (cqe.res < 0) {
+        error = -cqe.res;
+      } else if (cqe.res == 0) {
+        error = ENODATA;
+      } else if ((size_t) cqe.res < read.iov.iov_len) {
+        // Short read, read the remaining bytes
+        read.iov.iov_base = (uint8_t *) read.iov.iov_base + cqe.res;
+        read.iov.iov_len -= (size_t) cqe.res;
+        read.offset += (uint64_t) cqe.res;
+        queue(slot);
+      } else {
+        ids.push_back(read.id);
+        _freeSlots.push_back(slot);
+        --_nbPending;
+      }
+      if (error != 0) {
+        _freeSlots.push_back(slot);
+        --_nbPending;
+      }
+    }
+    __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+    if (error != 0) { throwError("A read failed", error); }
+#endif
+  }
+
+ private:
+#ifdef FASTIMAGE_IO_URING
+  /// \brief A read in flight
+  struct Read {
+    iovec iov{};          ///< Part of the buffer left to read
+    uint64_t offset = 0;  ///< Offset in the file of the part left to read
+    uint64_t id = 0;      ///< Identifier given back at the completion
+  };
+
+  /// \brief Private function. Map a ring of the io_uring
+  /// \param size Ring size in bytes
+  /// \param offset Ring offset, identifying the ring
+  /// \return Mapped ring
+  uint8_t *mapRing(size_t size, off_t offset) {
+    void *ring = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, _ringFd, offset);
+    if (ring == MAP_FAILED) {
+      throwError("The io_uring ring can not be mapped", errno);
+    }
+    return (uint8_t *) ring;
+  }
+
+  /// \brief Private function. Write a read in the submission ring
+  /// \param slot Slot of the read
+  void queue(uint32_t slot) {
+    uint32_t
+        tail = *_sqTail,
+        index = tail & _sqMask;
+    io_uring_sqe &sqe = _sqes[index];
+    std::memset(&sqe, 0, sizeof(io_uring_sqe));
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = _fd;
+    sqe.addr = (uint64_t) (uintptr_t) &_reads[slot].iov;
+    sqe.len = 1;
+    sqe.off = _reads[slot].offset;
+    sqe.user_data = slot;
+    _sqArray[index] = index;
+    __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++_nbQueued;
+  }
+
+  /// \brief Private function. Submit the queued reads, and wait for
+  /// completions
+  /// \param minComplete Number of completions to wait for
+  /// \param flags io_uring_enter flags
+  void enter(uint32_t minComplete, uint32_t flags) {
+    long submitted;
+    do {
+      submitted = syscall(__NR_io_uring_enter, _ringFd, _nbQueued,
+                          minComplete, flags, nullptr, 0);
+    } while (submitted < 0 && errno == EINTR);
+    if (submitted < 0) {
+      // The kernel is out of resources, the reads are submitted later
+      if ((errno == EAGAIN || errno == EBUSY) && minComplete == 0) { return; }
+      throwError("The reads can not be submitted", errno);
+    }
+    _nbQueued -= (uint32_t) submitted;
+  }
+
+  int
+      _ringFd = -1;                       ///< io_uring file descriptor
+
+  uint8_t
+      *_sqRing = nullptr,                 ///< Submission ring
+      *_cqRing = nullptr;                 ///< Completion ring
+
+  io_uring_sqe
+      *_sqes = nullptr;                   ///< Submission entries
+
+  io_uring_cqe
+      *_cqes = nullptr;                   ///< Completion entries
+
+  size_t
+      _sqRingSize = 0,                    ///< Submission ring size
+      _cqRingSize = 0,                    ///< Completion ring size
+      _sqesSize = 0;                      ///< Submission entries size
+
+  uint32_t
+      *_sqTail = nullptr,                 ///< Submission ring tail
+      *_sqArray = nullptr,                ///< Submission ring entry indexes
+      *_cqHead = nullptr,                 ///< Completion ring head
+      *_cqTail = nullptr,                 ///< Completion ring tail
+      _sqMask = 0,                        ///< Submission ring mask
+      _cqMask = 0;                        ///< Completion ring mask
+
+  std::vector<Read>
+      _reads{};                           ///< Reads, one per slot
+
+  std::vector<uint32_t>
+      _freeSlots{};                       ///< Slots not in use
+#endif
+};
+}
+#endif //FASTIMAGE_IOURINGREADER_H
@@ -0,0 +1,206 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file PReadPoolReader.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Asynchronous file reader using a pool of threads calling pread
+
+#ifndef FASTIMAGE_PREADPOOLREADER_H
+#define FASTIMAGE_PREADPOOLREADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "FastImage/object/io/AAsyncReader.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class PReadPoolReader PReadPoolReader.h <FastImage/object/io/PReadPoolReader.h>
+  *
+  * @brief Asynchronous file reader using a pool of threads calling pread,
+  * used when io_uring is not available.
+  *
+  * @details The submitted reads are shared by the pool threads, each thread
+  * doing one blocking pread at a time. The number of reads in flight is the
+  * number of threads, at most maxNumThreads.
+  **/
+class PReadPoolReader : public AAsyncReader {
+ public:
+  /// \brief Maximum number of pool threads
+  static constexpr uint32_t maxNumThreads = 32;
+
+  /// \brief Open the file and start the pool threads
+  /// \param filePath File path
+  /// \param queueDepth Maximum number of reads pending
+  PReadPoolReader(const std::string &filePath, uint32_t queueDepth)
+      : AAsyncReader(filePath, queueDepth) {
+    uint32_t numThreads =
+        queueDepth < maxNumThreads ? queueDepth : maxNumThreads;
+    for (uint32_t thread = 0; thread < numThreads; ++thread) {
+      _threads.emplace_back(&PReadPoolReader::readReads, this);
+    }
+  }
+
+  /// \brief Stop the pool threads, after their current read
+  ~PReadPoolReader() override {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _submittedCondition.notify_all();
+    for (auto &thread : _threads) { thread.join(); }
+  }
+
+  /// \brief Get the reader name
+  /// \return Reader name
+  std::string getName() const override { return "pread pool"; }
+
+  /// \brief Queue a read
+  /// \param buffer Buffer to read into
+  /// \param length Number of bytes to read
+  /// \param offset Offset in the file
+  /// \param id Identifier given back at the read completion
+  void read(void *buffer, size_t length, uint64_t offset,
+            uint64_t id) override {
+    if (_nbPending >= _queueDepth) {
+      throwError("The queue depth is exceeded", EBUSY);
+    }
+    _queued.push_back({(uint8_t *) buffer, length, offset, id, 0});
+    ++_nbPending;
+    ++_nbQueued;
+  }
+
+  /// \brief Give the queued reads to the pool threads
+  void submit() override {
+    if (_queued.empty()) { return; }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _submitted.insert(_submitted.end(), _queued.begin(), _queued.end());
+    }
+    _queued.clear();
+    _nbQueued = 0;
+    _submittedCondition.notify_all();
+  }
+
+  /// \brief Collect the completed reads
+  /// \param ids Identifiers of the completed reads, appended
+  /// \param wait If true, block until at least one read completes, if any
+  /// pending
+  void complete(std::vector<uint64_t> &ids, bool wait) override {
+    std::vector<Read> completed;
+    if (wait && _nbPending > 0) { submit(); }
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (wait && _nbPending > 0) {
+        _completedCondition.wait(lock, [this]() {
+          return !_completed.empty();
+        });
+      }
+      std::swap(completed, _completed);
+    }
+    int error = 0;
+    for (auto &read : completed) {
+      --_nbPending;
+      if (read.error != 0) {
+        error = read.error;
+      } else {
+        ids.push_back(read.id);
+      }
+    }
+    if (error != 0) { throwError("A read failed", error); }
+  }
+
+ private:
+  /// \brief A read
+  struct Read {
+    uint8_t *buffer;      ///< Buffer to read into
+    size_t length;        ///< Number of bytes to read
+    uint64_t offset;      ///< Offset in the file
+    uint64_t id;          ///< Identifier given back at the completion
+    int error;            ///< Error number, 0 if the read succeeded
+  };
+
+  /// \brief Private function. Pool thread function, read the submitted
+  /// reads until the reader is destroyed
+  void readReads() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+      _submittedCondition.wait(lock, [this]() {
+        return _stop || !_submitted.empty();
+      });
+      if (_stop) { return; }
+      Read read = _submitted.front();
+      _submitted.pop_front();
+      lock.unlock();
+
+      size_t done = 0;
+      while (done < read.length && read.error == 0) {
+        ssize_t nbRead = pread(_fd, read.buffer + done, read.length - done,
+                               (off_t) (read.offset + done));
+        if (nbRead > 0) {
+          done += (size_t) nbRead;
+        } else if (nbRead == 0) {
+          read.error = ENODATA;
+        } else if (errno != EINTR) {
+          read.error = errno;
+        }
+      }
+
+      lock.lock();
+      _completed.push_back(read);
+      _completedCondition.notify_one();
+    }
+  }
+
+  std::vector<Read>
+      _queued{},                          ///< Reads queued, not submitted
+      _completed{};                       ///< Reads completed
+
+  std::deque<Read>
+      _submitted{};                       ///< Reads submitted, not started
+
+  std::vector<std::thread>
+      _threads{};                         ///< Pool threads
+
+  std::mutex
+      _mutex{};                           ///< Submitted and completed lock
+
+  std::condition_variable
+      _submittedCondition{},              ///< Notify a read submitted
+      _completedCondition{};              ///< Notify a read completed
+
+  bool
+      _stop = false;                      ///< True to stop the threads
+};
+}
+#endif //FASTIMAGE_PREADPOOLREADER_H
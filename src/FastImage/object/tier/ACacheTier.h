@@ -0,0 +1,207 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file ACacheTier.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Interface of the second level tiers of the Fast Image cache
+
+#ifndef FASTIMAGE_ACACHETIER_H
+#define FASTIMAGE_ACACHETIER_H
+
+#include <sys/stat.h>
+#include <climits>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <type_traits>
+
+#include "FastImage/exception/FastImageException.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class ACacheTier ACacheTier.h <FastImage/object/tier/ACacheTier.h>
+  *
+  * @brief Second level tier of a fi::FigCache.
+  *
+  * @details The tiles recycled by the cache's eviction policy are stored in
+  * the tier, and a tile missing from the cache is looked for in the tier
+  * before being loaded from the file. The tier is inclusive: a tile fetched
+  * stays in the tier, so it is not stored again when recycled, the tiles
+  * being read only. The tier is shared by the cache shards and the tile
+  * loaders, the functions have to be thread safe.
+  * The new tiers have to override and implement the following functions:
+  * \code
+  *     virtual std::string getName() const = 0;
+  *     virtual bool contains(uint32_t indexRow, uint32_t indexCol) = 0;
+  *     virtual void store(uint32_t indexRow, uint32_t indexCol,
+  *                        const UserType *tile, size_t nbPixels) = 0;
+  *     virtual bool fetch(uint32_t indexRow, uint32_t indexCol,
+  *                        UserType *tile, size_t nbPixels) = 0;
+  *     virtual uint64_t getNbBytes() const = 0;
+  * \endcode
+  * The hits and misses are counted by fetch with countFetch. A persistent
+  * tier overrides storesLoadedTiles to store the tiles as soon as loaded from
+  * the file, instead of when recycled.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class ACacheTier {
+ public:
+  /// \brief Default destructor
+  virtual ~ACacheTier() = default;
+
+  /// \brief Get the tier name
+  /// \return Tier name
+  virtual std::string getName() const = 0;
+
+  /// \brief Test if the tier holds a tile, the result is a hint
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return True if the tier holds the tile, else False
+  virtual bool contains(uint32_t indexRow, uint32_t indexCol) = 0;
+
+  /// \brief Store a tile recycled by the cache, nothing is done if the tier
+  /// already holds the tile
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile's pixels
+  /// \param nbPixels Number of pixels in the tile
+  virtual void store(uint32_t indexRow, uint32_t indexCol,
+                     const UserType *tile, size_t nbPixels) = 0;
+
+  /// \brief Copy a tile held by the tier
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile to fill
+  /// \param nbPixels Number of pixels in the tile
+  /// \return True if the tier held the tile and the tile has been filled,
+  /// else False
+  virtual bool fetch(uint32_t indexRow, uint32_t indexCol,
+                     UserType *tile, size_t nbPixels) = 0;
+
+  /// \brief Get the number of bytes used by the tier to hold the tiles
+  /// \return Number of bytes used
+  virtual uint64_t getNbBytes() const = 0;
+
+  /// \brief Test if the tier stores the tiles as soon as loaded from the
+  /// file, instead of when recycled by the cache
+  /// \return True if the tiles are stored once loaded, else False
+  virtual bool storesLoadedTiles() const { return false; }
+
+  /// \brief Get the number of tiles fetched from the tier
+  /// \return Number of hits
+  uint64_t getHit() const { return _hit; }
+
+  /// \brief Get the number of tiles asked and not held by the tier
+  /// \return Number of misses
+  uint64_t getMiss() const { return _miss; }
+
+ protected:
+  /// \brief Count a fetch
+  /// \param hit True if the tier held the tile
+  /// \return hit
+  bool countFetch(bool hit) {
+    ++(hit ? _hit : _miss);
+    return hit;
+  }
+
+  /// \brief Get a unique key for a tile index
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return Tile key
+  static uint64_t tileKey(uint32_t indexRow, uint32_t indexCol) {
+    return ((uint64_t) indexRow << 32u) | indexCol;
+  }
+
+  /// \brief Build the identity of the decoded tiles
+  /// \param filePath Path of the image file
+  /// \param level Pyramid level
+  /// \param numTilesHeight Number of tiles in a column
+  /// \param numTilesWidth Number of tiles in a row
+  /// \param tileHeight Tile's height
+  /// \param tileWidth Tile's width
+  /// \param decodeIdentity Identity of the decoding, from
+  /// ATileLoader::getDecodeIdentity
+  /// \return Identity of the decoded tiles
+  static std::string identity(const std::string &filePath, uint32_t level,
+                              uint32_t numTilesHeight, uint32_t numTilesWidth,
+                              uint32_t tileHeight, uint32_t tileWidth,
+                              const std::string &decodeIdentity) {
+    struct stat fileStat{};
+    char absolutePath[PATH_MAX];
+    if (realpath(filePath.c_str(), absolutePath) == nullptr
+        || stat(absolutePath, &fileStat) != 0) {
+      std::stringstream message;
+      message << "Cache Tier ERROR: The image file can not be found ("
+              << filePath << "): " << strerror(errno) << ".";
+      std::string m = message.str();
+      throw (FastImageException(m));
+    }
+    std::stringstream id;
+    id << absolutePath << "\n"
+       << fileStat.st_dev << ":" << fileStat.st_ino << "\n"
+       << fileStat.st_size << "\n"
+       << fileStat.st_mtim.tv_sec << "." << fileStat.st_mtim.tv_nsec << "\n"
+       << "level " << level << "\n"
+       << numTilesHeight << "x" << numTilesWidth << " tiles of "
+       << tileHeight << "x" << tileWidth << "\n"
+       << (std::is_floating_point<UserType>::value ? "float" :
+           std::is_signed<UserType>::value ? "int" : "uint")
+       << 8 * sizeof(UserType) << "\n"
+       << decodeIdentity << "\n";
+    return id.str();
+  }
+
+  /// \brief FNV-1a hash, naming the files of the persistent tiers
+  /// \param value Value to hash
+  /// \return Hash
+  static uint64_t hash(const std::string &value) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : value) {
+      h ^= c;
+      h *= 1099511628211ull;
+    }
+    return h;
+  }
+
+ private:
+  std::atomic<uint64_t>
+      _hit{0},                ///< Number of tiles fetched
+      _miss{0};               ///< Number of tiles asked and not held
+};
+}
+#endif //FASTIMAGE_ACACHETIER_H
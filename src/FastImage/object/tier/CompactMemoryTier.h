@@ -0,0 +1,294 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file CompactMemoryTier.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Cache tier keeping the recycled tiles in memory in a compact form
+
+#ifndef FASTIMAGE_COMPACTMEMORYTIER_H
+#define FASTIMAGE_COMPACTMEMORYTIER_H
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+
+#include "FastImage/object/tier/ACacheTier.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class CompactMemoryTier CompactMemoryTier.h <FastImage/object/tier/CompactMemoryTier.h>
+  *
+  * @brief Cache tier keeping the recycled tiles in memory in a compact form,
+  * up to a number of bytes.
+  *
+  * @details The cached tiles are stored in the type asked by the end user,
+  * often wider than the file type (e.g. a float view of a 8 bits image). When
+  * all the pixels of a tile are integers, the tile is stored as the
+  * difference to its minimum, packed on the number of bits needed by the
+  * tile's range: a 8 bits image viewed as float takes at most 8 bits per
+  * pixel, a tile of a 12 bits image 12 bits. The other tiles are stored as
+  * they are. The encoding is lossless.
+  *
+  * The least recently used tiles are dropped when the tier is full. The tiles
+  * are encoded and decoded outside of the tier lock.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class CompactMemoryTier : public ACacheTier<UserType> {
+  /// \brief Tile stored in the tier
+  struct CompactTile {
+    uint64_t key;                   ///< Tile key
+    size_t nbPixels;                ///< Number of pixels
+    int64_t minimum;                ///< Minimum pixel value, if packed
+    uint8_t bits;                   ///< Bits per packed pixel
+    bool packed;                    ///< True if packed, else stored as is
+    std::vector<uint64_t> words;    ///< Packed or raw pixels
+
+    /// \brief Get the memory used by the tile
+    /// \return Memory used by the tile in bytes
+    uint64_t getNbBytes() const {
+      return sizeof(CompactTile) + words.size() * sizeof(uint64_t);
+    }
+  };
+
+  using CompactTilePtr = std::shared_ptr<const CompactTile>;
+
+ public:
+  /// \brief CompactMemoryTier constructor
+  /// \param maxBytes Maximum number of bytes used to hold the tiles
+  explicit CompactMemoryTier(uint64_t maxBytes)
+      : _maxBytes(maxBytes), _nbBytes(0) {}
+
+  /// \brief Get the tier name
+  /// \return Tier name
+  std::string getName() const override { return "CompactMemoryTier"; }
+
+  /// \brief Test if the tier holds a tile, the result is a hint
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return True if the tier holds the tile, else False
+  bool contains(uint32_t indexRow, uint32_t indexCol) override {
+    std::lock_guard<std::mutex> lock(_tierMutex);
+    return _mapTiles.count(this->tileKey(indexRow, indexCol)) != 0;
+  }
+
+  /// \brief Encode and store a tile recycled by the cache, dropping the least
+  /// recently used tiles if the tier is full
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile's pixels
+  /// \param nbPixels Number of pixels in the tile
+  void store(uint32_t indexRow, uint32_t indexCol,
+             const UserType *tile, size_t nbPixels) override {
+    uint64_t key = this->tileKey(indexRow, indexCol);
+    if (contains(indexRow, indexCol)) { return; }
+
+    auto compactTile = std::make_shared<CompactTile>();
+    compactTile->key = key;
+    encode(tile, nbPixels, *compactTile);
+    if (compactTile->getNbBytes() > _maxBytes) { return; }
+
+    std::lock_guard<std::mutex> lock(_tierMutex);
+    if (_mapTiles.count(key) != 0) { return; }
+    _tiles.push_front(compactTile);
+    _mapTiles[key] = _tiles.begin();
+    _nbBytes += compactTile->getNbBytes();
+    while (_nbBytes > _maxBytes) {
+      _nbBytes -= _tiles.back()->getNbBytes();
+      _mapTiles.erase(_tiles.back()->key);
+      _tiles.pop_back();
+    }
+  }
+
+  /// \brief Decode a tile held by the tier
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile to fill
+  /// \param nbPixels Number of pixels in the tile
+  /// \return True if the tier held the tile and the tile has been filled,
+  /// else False
+  bool fetch(uint32_t indexRow, uint32_t indexCol,
+             UserType *tile, size_t nbPixels) override {
+    CompactTilePtr compactTile;
+    {
+      std::lock_guard<std::mutex> lock(_tierMutex);
+      auto it = _mapTiles.find(this->tileKey(indexRow, indexCol));
+      if (it == _mapTiles.end() || (*it->second)->nbPixels != nbPixels) {
+        return this->countFetch(false);
+      }
+      // The tile is kept alive while decoded, even if dropped
+      compactTile = *it->second;
+      _tiles.splice(_tiles.begin(), _tiles, it->second);
+    }
+    decode(*compactTile, tile);
+    return this->countFetch(true);
+  }
+
+  /// \brief Get the number of bytes used by the tier to hold the tiles
+  /// \return Number of bytes used
+  uint64_t getNbBytes() const override { return _nbBytes; }
+
+  /// \brief Get the number of tiles held
+  /// \return Number of tiles held
+  size_t getNbTiles() {
+    std::lock_guard<std::mutex> lock(_tierMutex);
+    return _tiles.size();
+  }
+
+ private:
+  /// \brief Private function. Encode a tile, packed if all its pixels are
+  /// integers and their range fits in less bits than UserType
+  /// \param tile Tile's pixels
+  /// \param nbPixels Number of pixels in the tile
+  /// \param compactTile Tile encoded
+  static void encode(const UserType *tile, size_t nbPixels,
+                     CompactTile &compactTile) {
+    int64_t
+        minimum = 0,
+        maximum = 0,
+        value = 0;
+    bool integers = true;
+    for (size_t pixel = 0; pixel < nbPixels && integers; ++pixel) {
+      integers = toInteger(tile[pixel], value);
+      minimum = pixel == 0 ? value : std::min(minimum, value);
+      maximum = pixel == 0 ? value : std::max(maximum, value);
+    }
+
+    uint8_t bits = 0;
+    uint64_t range = (uint64_t) maximum - (uint64_t) minimum;
+    while (bits < 64 && (range >> bits) != 0) { ++bits; }
+
+    compactTile.nbPixels = nbPixels;
+    compactTile.minimum = minimum;
+    compactTile.bits = bits;
+    compactTile.packed = integers && bits < 8 * sizeof(UserType);
+    if (!compactTile.packed) {
+      compactTile.words.resize(
+          (nbPixels * sizeof(UserType) + sizeof(uint64_t) - 1)
+              / sizeof(uint64_t));
+      std::memcpy(compactTile.words.data(), tile,
+                  nbPixels * sizeof(UserType));
+      return;
+    }
+
+    compactTile.words.assign((nbPixels * bits + 63) / 64, 0);
+    for (size_t pixel = 0; pixel < nbPixels && bits > 0; ++pixel) {
+      toInteger(tile[pixel], value);
+      uint64_t
+          delta = (uint64_t) value - (uint64_t) minimum,
+          position = pixel * bits,
+          shift = position % 64;
+      compactTile.words[position / 64] |= delta << shift;
+      if (shift + bits > 64) {
+        compactTile.words[position / 64 + 1] |= delta >> (64 - shift);
+      }
+    }
+  }
+
+  /// \brief Private function. Decode a tile
+  /// \param compactTile Tile encoded
+  /// \param tile Tile to fill
+  static void decode(const CompactTile &compactTile, UserType *tile) {
+    if (!compactTile.packed) {
+      std::memcpy(tile, compactTile.words.data(),
+                  compactTile.nbPixels * sizeof(UserType));
+      return;
+    }
+    if (compactTile.bits == 0) {
+      std::fill_n(tile, compactTile.nbPixels, (UserType) compactTile.minimum);
+      return;
+    }
+    uint8_t bits = compactTile.bits;
+    uint64_t mask = bits == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << bits) - 1;
+    for (size_t pixel = 0; pixel < compactTile.nbPixels; ++pixel) {
+      uint64_t
+          position = pixel * bits,
+          shift = position % 64,
+          delta = compactTile.words[position / 64] >> shift;
+      if (shift + bits > 64) {
+        delta |= compactTile.words[position / 64 + 1] << (64 - shift);
+      }
+      tile[pixel] = (UserType) (int64_t)
+          ((uint64_t) compactTile.minimum + (delta & mask));
+    }
+  }
+
+  /// \brief Private function. Convert an integral pixel to an integer
+  /// \param pixel Pixel
+  /// \param value Integer value
+  /// \return True if the pixel is represented by an int64_t, else False
+  template<typename T>
+  static typename std::enable_if<std::is_integral<T>::value, bool>::type
+  toInteger(T pixel, int64_t &value) {
+    value = (int64_t) pixel;
+    return std::is_signed<T>::value || sizeof(T) < sizeof(int64_t)
+        || value >= 0;
+  }
+
+  /// \brief Private function. Convert a floating point pixel to an integer
+  /// \param pixel Pixel
+  /// \param value Integer value
+  /// \return True if the pixel is an integer exactly represented back, else
+  /// False (NaN, infinite, fractional, -0 or too large values)
+  template<typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+  toInteger(T pixel, int64_t &value) {
+    if (!(std::fabs(pixel) <= 9007199254740992.)) { return false; }
+    value = (int64_t) pixel;
+    return (T) value == pixel && !(value == 0 && std::signbit(pixel));
+  }
+
+  std::list<CompactTilePtr>
+      _tiles;                 ///< Tiles held, from the most recently used
+
+  std::unordered_map<uint64_t, typename std::list<CompactTilePtr>::iterator>
+      _mapTiles;              ///< Position of the tiles held
+
+  std::mutex
+      _tierMutex;             ///< Tier mutex
+
+  uint64_t
+      _maxBytes;              ///< Maximum number of bytes used
+
+  std::atomic<uint64_t>
+      _nbBytes;               ///< Number of bytes used
+};
+}
+#endif //FASTIMAGE_COMPACTMEMORYTIER_H
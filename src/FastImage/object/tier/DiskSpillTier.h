@@ -0,0 +1,412 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file DiskSpillTier.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Persistent cache tier keeping the decoded tiles in a spill file
+
+#ifndef FASTIMAGE_DISKSPILLTIER_H
+#define FASTIMAGE_DISKSPILLTIER_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <atomic>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <type_traits>
+
+#include "FastImage/object/tier/ACacheTier.h"
+#include "FastImage/exception/FastImageException.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class DiskSpillTier DiskSpillTier.h <FastImage/object/tier/DiskSpillTier.h>
+  *
+  * @brief Persistent cache tier keeping the decoded tiles of a pyramid level
+  * in a spill file, shared by the passes over the image and by the processes.
+  *
+  * @details The spill file is named after the identity of the image file
+  * (path, inode, size and modification time), the pyramid level, the tile
+  * size, the pixel type and the decoding (ATileLoader::getDecodeIdentity), so
+  * a modified image file or an other normalization gets a new spill file.
+  * It holds a header, one state byte and one checksum per tile, and a slot
+  * per tile. The file is sparse, only the slots written use the disk, up to
+  * the size of the decoded level or the size limit. The tiles are stored as
+  * soon as loaded from the file (storesLoadedTiles), so the next passes and
+  * the next processes decode each tile once.
+  *
+  * A tile state goes from EMPTY to WRITING, claimed by a single writer, then
+  * to STORED once written. The slots are written with pwrite, a full drive
+  * only skipping the tile, and read from the mapped file. The processes
+  * sharing the spill file see the same pages. The spill file is reset if its
+  * header does not match the identity.
+  *
+  * The state and the data pages are written back to the disk in any order.
+  * The checksum of a tile, written before its state, is checked when the
+  * tile is fetched: after a system crash, a tile whose data did not reach
+  * the disk is a miss, and its slot is reset.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class DiskSpillTier : public ACacheTier<UserType> {
+  /// \brief State of a tile slot in the spill file
+  enum SlotState : uint8_t { EMPTY = 0, WRITING = 1, STORED = 2 };
+
+  static_assert(sizeof(std::atomic<uint8_t>) == 1,
+                "The slot states are mapped as atomic bytes");
+  static_assert(sizeof(std::atomic<uint64_t>) == 8,
+                "The slot checksums are mapped as atomic 64-bits words");
+
+  static constexpr size_t
+      headerSize = 4096;      ///< Header size, the identity included
+
+ public:
+  /// \brief DiskSpillTier constructor, create or open the spill file
+  /// \param spillDirectory Directory of the spill files, on a local drive
+  /// \param filePath Path of the image file
+  /// \param level Pyramid level
+  /// \param numTilesHeight Number of tiles in a column
+  /// \param numTilesWidth Number of tiles in a row
+  /// \param tileHeight Tile's height
+  /// \param tileWidth Tile's width
+  /// \param sizeLimit Maximum size of the tiles stored in bytes, 0 for no
+  /// limit (the decoded level size)
+  /// \param decodeIdentity Identity of the decoding, from
+  /// ATileLoader::getDecodeIdentity
+  DiskSpillTier(const std::string &spillDirectory,
+                const std::string &filePath,
+                uint32_t level,
+                uint32_t numTilesHeight, uint32_t numTilesWidth,
+                uint32_t tileHeight, uint32_t tileWidth,
+                uint64_t sizeLimit = 0,
+                const std::string &decodeIdentity = "")
+      : _numTilesWidth(numTilesWidth),
+        _nbTiles((uint64_t) numTilesHeight * numTilesWidth),
+        _tileBytes((uint64_t) tileHeight * tileWidth * sizeof(UserType)),
+        _sizeLimit(sizeLimit),
+        _nbStored(0) {
+    _identity = this->identity(filePath, level, numTilesHeight,
+                               numTilesWidth, tileHeight, tileWidth,
+                               decodeIdentity);
+    std::stringstream spillPath;
+    spillPath << spillDirectory << "/fastimage_" << std::hex
+              << std::setw(16) << std::setfill('0') << this->hash(_identity)
+              << ".spill";
+    _spillPath = spillPath.str();
+    _checksumsOffset = headerSize + roundUp(_nbTiles, headerSize);
+    _dataOffset = _checksumsOffset
+        + roundUp(_nbTiles * sizeof(uint64_t), headerSize);
+    _size = _dataOffset + _nbTiles * _tileBytes;
+    openSpillFile();
+  }
+
+  /// \brief DiskSpillTier destructor, unmap and close the spill file
+  ~DiskSpillTier() override {
+    if (_data != nullptr) { munmap(_data, _size); }
+    if (_fd >= 0) { close(_fd); }
+  }
+
+  DiskSpillTier(const DiskSpillTier &) = delete;
+  DiskSpillTier &operator=(const DiskSpillTier &) = delete;
+
+  /// \brief Get the tier name
+  /// \return Tier name
+  std::string getName() const override { return "DiskSpillTier"; }
+
+  /// \brief Test if the spill file holds a tile
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return True if the tile is stored, else False
+  bool contains(uint32_t indexRow, uint32_t indexCol) override {
+    uint64_t slot = slotIndex(indexRow, indexCol);
+    return slot < _nbTiles
+        && state(slot).load(std::memory_order_acquire) == STORED;
+  }
+
+  /// \brief Write a tile in its slot, if not already stored or being written
+  /// \details The tile is not stored if the size limit is reached, or if the
+  /// drive is full.
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile's pixels
+  /// \param nbPixels Number of pixels in the tile
+  void store(uint32_t indexRow, uint32_t indexCol,
+             const UserType *tile, size_t nbPixels) override {
+    uint64_t slot = slotIndex(indexRow, indexCol);
+    uint8_t expected = EMPTY;
+    if (slot >= _nbTiles || nbPixels * sizeof(UserType) != _tileBytes
+        || (_sizeLimit > 0 && (_nbStored + 1) * _tileBytes > _sizeLimit)
+        || !state(slot).compare_exchange_strong(expected, WRITING)) {
+      return;
+    }
+    // Written with pwrite, an allocation failure of the mapping would raise
+    // a SIGBUS
+    auto data = (const uint8_t *) tile;
+    uint64_t written = 0;
+    while (written < _tileBytes) {
+      ssize_t nbBytes = pwrite(_fd, data + written, _tileBytes - written,
+                               (off_t) (_dataOffset + slot * _tileBytes
+                                   + written));
+      if (nbBytes <= 0) {
+        if (nbBytes < 0 && errno == EINTR) { continue; }
+        state(slot).store(EMPTY, std::memory_order_release);
+        return;
+      }
+      written += (uint64_t) nbBytes;
+    }
+    checksum(slot).store(computeChecksum(data), std::memory_order_relaxed);
+    state(slot).store(STORED, std::memory_order_release);
+    ++_nbStored;
+  }
+
+  /// \brief Copy a tile from its slot
+  /// \details A tile not matching its checksum, lost by a system crash, is a
+  /// miss and its slot is reset.
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile to fill
+  /// \param nbPixels Number of pixels in the tile
+  /// \return True if the tile was stored and has been copied, else False
+  bool fetch(uint32_t indexRow, uint32_t indexCol,
+             UserType *tile, size_t nbPixels) override {
+    if (!contains(indexRow, indexCol)
+        || nbPixels * sizeof(UserType) != _tileBytes) {
+      return this->countFetch(false);
+    }
+    uint64_t slot = slotIndex(indexRow, indexCol);
+    std::memcpy(tile, slotData(slot), _tileBytes);
+    if (computeChecksum((const uint8_t *) tile)
+        != checksum(slot).load(std::memory_order_relaxed)) {
+      uint8_t expected = STORED;
+      if (state(slot).compare_exchange_strong(expected, EMPTY)) {
+        --_nbStored;
+      }
+      return this->countFetch(false);
+    }
+    return this->countFetch(true);
+  }
+
+  /// \brief Get the number of bytes of the tiles stored in the spill file
+  /// \return Number of bytes used
+  uint64_t getNbBytes() const override { return _nbStored * _tileBytes; }
+
+  /// \brief The tiles are stored once loaded, to be kept for the next
+  /// processes
+  /// \return True
+  bool storesLoadedTiles() const override { return true; }
+
+  /// \brief Get the spill file path
+  /// \return Spill file path
+  const std::string &getSpillPath() const { return _spillPath; }
+
+ private:
+  /// \brief Private function. Create or open the spill file and map it
+  /// \details The file is locked while its header is checked, and reset if it
+  /// does not match. The header, the states and the checksums are allocated
+  /// on the disk, their pages being written through the mapping. The tiles
+  /// left WRITING by a process stopped while writing are reset.
+  void openSpillFile() {
+    _fd = open(_spillPath.c_str(), O_RDWR | O_CREAT, 0644);
+    int fd = _fd;
+    if (fd < 0) { throwError("The spill file can not be opened"); }
+    if (flock(fd, LOCK_EX) != 0) {
+      closeSpillFile();
+      throwError("The spill file can not be locked");
+    }
+
+    struct stat spillStat{};
+    bool valid = fstat(fd, &spillStat) == 0
+        && (uint64_t) spillStat.st_size == _size;
+    if (valid) {
+      std::string header(headerSize, '\0');
+      valid = pread(fd, &header[0], headerSize, 0) == (ssize_t) headerSize
+          && header == createHeader();
+    }
+    if (!valid) {
+      std::string header = createHeader();
+      if (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t) _size) != 0
+          || pwrite(fd, header.data(), headerSize, 0)
+              != (ssize_t) headerSize) {
+        closeSpillFile();
+        throwError("The spill file can not be created");
+      }
+    }
+    int allocation = posix_fallocate(fd, 0, (off_t) _dataOffset);
+    if (allocation != 0) {
+      closeSpillFile();
+      errno = allocation;
+      throwError("The spill file can not be allocated");
+    }
+
+    void *data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                      0);
+    if (data == MAP_FAILED) {
+      closeSpillFile();
+      throwError("The spill file can not be mapped");
+    }
+    _data = (uint8_t *) data;
+    madvise(_data + _dataOffset, _size - _dataOffset, MADV_RANDOM);
+
+    for (uint64_t slot = 0; slot < _nbTiles; ++slot) {
+      uint8_t expected = WRITING;
+      state(slot).compare_exchange_strong(expected, EMPTY);
+      _nbStored += state(slot).load() == STORED;
+    }
+    // The file stays open for the slots written, the lock has to be released
+    // explicitly
+    flock(fd, LOCK_UN);
+  }
+
+  /// \brief Private function. Close the spill file
+  void closeSpillFile() {
+    close(_fd);
+    _fd = -1;
+  }
+
+  /// \brief Private function. Create the spill file header
+  /// \return Header of headerSize bytes
+  std::string createHeader() const {
+    std::stringstream header;
+    header << "FISPILL2\n" << _tileBytes << "\n" << _nbTiles << "\n"
+           << _identity;
+    std::string h = header.str();
+    h.resize(headerSize, '\0');
+    return h;
+  }
+
+  /// \brief Private function. Round a value up to a multiple
+  /// \param value Value
+  /// \param multiple Multiple
+  /// \return Value rounded up
+  static uint64_t roundUp(uint64_t value, uint64_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  /// \brief Private function. Get the slot index of a tile
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return Slot index
+  uint64_t slotIndex(uint32_t indexRow, uint32_t indexCol) const {
+    return (uint64_t) indexRow * _numTilesWidth + indexCol;
+  }
+
+  /// \brief Private function. Get the state of a slot
+  /// \param slot Slot index
+  /// \return Slot state, mapped
+  std::atomic<uint8_t> &state(uint64_t slot) const {
+    return *reinterpret_cast<std::atomic<uint8_t> *>(
+        _data + headerSize + slot);
+  }
+
+  /// \brief Private function. Get the checksum of a slot
+  /// \param slot Slot index
+  /// \return Slot checksum, mapped
+  std::atomic<uint64_t> &checksum(uint64_t slot) const {
+    return reinterpret_cast<std::atomic<uint64_t> *>(
+        _data + _checksumsOffset)[slot];
+  }
+
+  /// \brief Private function. Compute the checksum of a tile
+  /// \details Four interleaved multiplicative hashes of the 64-bits words,
+  /// never 0 so a checksum lost by a crash never matches.
+  /// \param tile Tile's bytes
+  /// \return Checksum of the tile
+  uint64_t computeChecksum(const uint8_t *tile) const {
+    const uint64_t prime = 0x100000001B3ull;
+    uint64_t lanes[4] = {0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full,
+                         0x165667B19E3779F9ull, 0x27D4EB2F165667C5ull};
+    uint64_t word, byte = 0;
+    for (; byte + 32 <= _tileBytes; byte += 32) {
+      for (int lane = 0; lane < 4; ++lane) {
+        std::memcpy(&word, tile + byte + lane * 8, 8);
+        lanes[lane] = (lanes[lane] ^ word) * prime;
+      }
+    }
+    for (; byte < _tileBytes; ++byte) {
+      lanes[0] = (lanes[0] ^ tile[byte]) * prime;
+    }
+    uint64_t hash = _tileBytes;
+    for (auto lane : lanes) { hash = (hash ^ (lane >> 29) ^ lane) * prime; }
+    return hash | 1;
+  }
+
+  /// \brief Private function. Get the data of a slot
+  /// \param slot Slot index
+  /// \return Slot data, mapped
+  uint8_t *slotData(uint64_t slot) const {
+    return _data + _dataOffset + slot * _tileBytes;
+  }
+
+  /// \brief Private function. Throw an exception with the errno description
+  /// \param reason Reason of the error
+  void throwError(const std::string &reason) const {
+    std::stringstream message;
+    message << "Disk Spill Tier ERROR: " << reason << " (" << _spillPath
+            << "): " << strerror(errno) << ".";
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  std::string
+      _identity,              ///< Identity of the decoded tiles
+      _spillPath;             ///< Spill file path
+
+  uint8_t *
+      _data = nullptr;        ///< Mapped spill file
+
+  int
+      _fd = -1;               ///< Spill file, the slots written with pwrite
+
+  uint64_t
+      _numTilesWidth,         ///< Number of tiles in a row
+      _nbTiles,               ///< Number of tiles in the level
+      _tileBytes,             ///< Size of a tile in bytes
+      _sizeLimit,             ///< Maximum size of the tiles stored, 0 if
+                              ///< not limited
+      _checksumsOffset = 0,   ///< Offset of the slot checksums
+      _dataOffset = 0,        ///< Offset of the first slot
+      _size = 0;              ///< Spill file size
+
+  std::atomic<uint64_t>
+      _nbStored;              ///< Number of tiles stored
+};
+}
+#endif //FASTIMAGE_DISKSPILLTIER_H
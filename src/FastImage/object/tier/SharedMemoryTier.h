@@ -0,0 +1,411 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file SharedMemoryTier.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Cache tier in POSIX shared memory, shared by the local processes
+
+#ifndef FASTIMAGE_SHAREDMEMORYTIER_H
+#define FASTIMAGE_SHAREDMEMORYTIER_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <string>
+
+#include "FastImage/object/tier/ACacheTier.h"
+#include "FastImage/exception/FastImageException.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class SharedMemoryTier SharedMemoryTier.h <FastImage/object/tier/SharedMemoryTier.h>
+  *
+  * @brief Cache tier keeping the decoded tiles of a pyramid level in a POSIX
+  * shared memory segment, shared by the processes of the node.
+  *
+  * @details The segment is named after the identity of the image file (path,
+  * inode, size and modification time), the pyramid level, the tile size, the
+  * pixel type, the decoding (ATileLoader::getDecodeIdentity) and the number
+  * of slots, so the processes opening the same image with the same options
+  * find the same segment. A tile decoded by a
+  * process is served to the others without any I/O or decoding. The tiles are
+  * stored as soon as loaded from the file (storesLoadedTiles).
+  *
+  * The segment holds a header, the shared index and the slots. The tiles are
+  * mapped to a slot by their index modulo the number of slots, the
+  * neighbouring tiles never sharing a slot. The index holds one 64-bits word
+  * per slot, the tile key, the slot state (EMPTY, WRITING, STORED) and a
+  * generation incremented at each write. It is accessed without lock: a
+  * writer claims a slot with a compare-and-swap to WRITING, and a reader
+  * checks the word did not change while it copied the slot. A tile stored in
+  * an occupied slot replaces the previous one.
+  *
+  * The segment is created on the first access and stays in /dev/shm after the
+  * processes exit, until removeSegment (or FastImage::removeSharedTierSegments)
+  * is called. A slot left WRITING by a process killed while writing is reset
+  * to EMPTY by the next process opening the segment once no other process
+  * has it mapped, the processes holding a shared lock on the segment while
+  * mapped. Until then it stays a miss. The segment memory is reserved when
+  * opened, the constructor throwing if /dev/shm is too small for it.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class SharedMemoryTier : public ACacheTier<UserType> {
+  /// \brief State of a slot in the shared index
+  enum SlotState : uint64_t { EMPTY = 0, WRITING = 1, STORED = 2 };
+
+  static_assert(sizeof(std::atomic<uint64_t>) == 8,
+                "The shared index is mapped as atomic 64-bits words");
+
+  static constexpr size_t
+      headerSize = 4096,      ///< Header size, the counters included
+      countersOffset = 2048;  ///< Offset of the counters in the header
+
+  static constexpr uint64_t
+      stateMask = 3,          ///< Bits of the slot state
+      keyShift = 2,           ///< Shift of the tile key + 1
+      keyMask = 0xFFFFFFFFull,///< Bits of the tile key + 1, once shifted
+      generationShift = 34;   ///< Shift of the slot generation
+
+ public:
+  /// \brief SharedMemoryTier constructor, create or open the shared memory
+  /// segment
+  /// \param filePath Path of the image file
+  /// \param level Pyramid level
+  /// \param numTilesHeight Number of tiles in a column
+  /// \param numTilesWidth Number of tiles in a row
+  /// \param tileHeight Tile's height
+  /// \param tileWidth Tile's width
+  /// \param memoryLimit Maximum memory of the slots in bytes
+  /// \param decodeIdentity Identity of the decoding, from
+  /// ATileLoader::getDecodeIdentity
+  SharedMemoryTier(const std::string &filePath,
+                   uint32_t level,
+                   uint32_t numTilesHeight, uint32_t numTilesWidth,
+                   uint32_t tileHeight, uint32_t tileWidth,
+                   uint64_t memoryLimit,
+                   const std::string &decodeIdentity = "")
+      : _numTilesWidth(numTilesWidth),
+        _tileBytes((uint64_t) tileHeight * tileWidth * sizeof(UserType)) {
+    _nbSlots = std::min((uint64_t) numTilesHeight * numTilesWidth,
+                        memoryLimit / _tileBytes);
+    if (_nbSlots == 0) {
+      std::stringstream message;
+      message << "Shared Memory Tier ERROR: The memory limit (" << memoryLimit
+              << " bytes) is lower than a tile (" << _tileBytes << " bytes).";
+      std::string m = message.str();
+      throw (FastImageException(m));
+    }
+    std::stringstream header;
+    header << "FISHM001\n" << _tileBytes << "\n" << _nbSlots << "\n"
+           << this->identity(filePath, level, numTilesHeight, numTilesWidth,
+                             tileHeight, tileWidth, decodeIdentity);
+    _header = header.str();
+    _header.resize(countersOffset, '\0');
+    std::stringstream name;
+    name << "/fastimage_" << std::hex << std::setw(16) << std::setfill('0')
+         << this->hash(_header);
+    _segmentName = name.str();
+    _dataOffset = headerSize
+        + roundUp(_nbSlots * sizeof(uint64_t), headerSize);
+    _size = _dataOffset + _nbSlots * _tileBytes;
+    openSegment();
+  }
+
+  /// \brief SharedMemoryTier destructor, unmap the segment
+  ~SharedMemoryTier() override {
+    if (_data != nullptr) { munmap(_data, _size); }
+    closeSegment();
+  }
+
+  SharedMemoryTier(const SharedMemoryTier &) = delete;
+  SharedMemoryTier &operator=(const SharedMemoryTier &) = delete;
+
+  /// \brief Get the tier name
+  /// \return Tier name
+  std::string getName() const override { return "SharedMemoryTier"; }
+
+  /// \brief Test if the segment holds a tile
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return True if the tile is stored, else False
+  bool contains(uint32_t indexRow, uint32_t indexCol) override {
+    uint64_t key = tileIndex(indexRow, indexCol);
+    return isStored(index(key % _nbSlots).load(std::memory_order_acquire),
+                    key);
+  }
+
+  /// \brief Write a tile in its slot, if not already stored or being written
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile's pixels
+  /// \param nbPixels Number of pixels in the tile
+  void store(uint32_t indexRow, uint32_t indexCol,
+             const UserType *tile, size_t nbPixels) override {
+    uint64_t
+        key = tileIndex(indexRow, indexCol),
+        slot = key % _nbSlots,
+        word = index(slot).load(std::memory_order_acquire);
+    if (nbPixels * sizeof(UserType) != _tileBytes || isStored(word, key)
+        || (word & stateMask) == WRITING) {
+      return;
+    }
+    uint64_t writing = (((word >> generationShift) + 1) << generationShift)
+        | ((key + 1) << keyShift) | WRITING;
+    if (!index(slot).compare_exchange_strong(word, writing,
+                                             std::memory_order_acq_rel)) {
+      return;
+    }
+    if ((word & stateMask) == STORED) { --nbStored(); }
+    std::memcpy(slotData(slot), tile, _tileBytes);
+    // The slot may have been reset by a process opening the segment
+    if (index(slot).compare_exchange_strong(
+        writing, (writing & ~stateMask) | STORED,
+        std::memory_order_release)) {
+      ++nbStored();
+    }
+  }
+
+  /// \brief Copy a tile from its slot
+  /// \details The copy is dropped if the slot has been claimed by a writer
+  /// while being copied.
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \param tile Tile to fill
+  /// \param nbPixels Number of pixels in the tile
+  /// \return True if the tile was stored and has been copied, else False
+  bool fetch(uint32_t indexRow, uint32_t indexCol,
+             UserType *tile, size_t nbPixels) override {
+    uint64_t
+        key = tileIndex(indexRow, indexCol),
+        slot = key % _nbSlots,
+        word = index(slot).load(std::memory_order_acquire);
+    if (nbPixels * sizeof(UserType) != _tileBytes || !isStored(word, key)) {
+      return this->countFetch(false);
+    }
+    std::memcpy(tile, slotData(slot), _tileBytes);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return this->countFetch(
+        index(slot).load(std::memory_order_relaxed) == word);
+  }
+
+  /// \brief Get the number of bytes of the tiles stored in the segment, by
+  /// all the processes
+  /// \return Number of bytes used
+  uint64_t getNbBytes() const override { return nbStored() * _tileBytes; }
+
+  /// \brief The tiles are stored once loaded, to be served to the other
+  /// processes
+  /// \return True
+  bool storesLoadedTiles() const override { return true; }
+
+  /// \brief Get the number of slots of the segment
+  /// \return Number of slots
+  uint64_t getNbSlots() const { return _nbSlots; }
+
+  /// \brief Get the shared memory segment name
+  /// \return Segment name
+  const std::string &getSegmentName() const { return _segmentName; }
+
+  /// \brief Remove the segment name, the memory being released once unmapped
+  /// by all the processes
+  void removeSegment() { shm_unlink(_segmentName.c_str()); }
+
+ private:
+  /// \brief Private function. Create or open the segment and map it
+  /// \details Each process holds a shared lock on the segment while it is
+  /// mapped. A process getting the exclusive lock is the only one using the
+  /// segment: it checks the header, resets the segment if it does not match,
+  /// reserves its memory, and resets to EMPTY the slots left WRITING by a
+  /// killed process, a new generation invalidating their previous writer. The
+  /// lock is then turned into a shared one. The other processes wait for the
+  /// shared lock and only check the header. A segment /dev/shm has not the
+  /// room for is removed and an exception is thrown.
+  void openSegment() {
+    _fd = shm_open(_segmentName.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_fd < 0) { throwError("The segment can not be opened"); }
+    bool alone = flock(_fd, LOCK_EX | LOCK_NB) == 0;
+    if (!alone && flock(_fd, LOCK_SH) != 0) {
+      closeSegment();
+      throwError("The segment can not be locked");
+    }
+
+    struct stat segmentStat{};
+    bool valid = fstat(_fd, &segmentStat) == 0
+        && (uint64_t) segmentStat.st_size == _size;
+    if (valid) {
+      std::string header(countersOffset, '\0');
+      valid = pread(_fd, &header[0], countersOffset, 0)
+          == (ssize_t) countersOffset && header == _header;
+    }
+    if (!valid) {
+      if (!alone) {
+        closeSegment();
+        errno = EEXIST;
+        throwError("The segment is used with an other header");
+      }
+      if (ftruncate(_fd, 0) != 0) {
+        closeSegment();
+        throwError("The segment can not be created");
+      }
+    }
+    if (alone) {
+      // Reserve the whole segment, a store in a page /dev/shm can not provide
+      // raising SIGBUS
+      int error = posix_fallocate(_fd, 0, (off_t) _size);
+      if (error != 0) {
+        shm_unlink(_segmentName.c_str());
+        closeSegment();
+        errno = error;
+        throwError("The segment can not be allocated");
+      }
+    }
+    if (!valid && pwrite(_fd, _header.data(), countersOffset, 0)
+        != (ssize_t) countersOffset) {
+      closeSegment();
+      throwError("The segment can not be created");
+    }
+
+    void *data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd,
+                      0);
+    if (data == MAP_FAILED) {
+      closeSegment();
+      throwError("The segment can not be mapped");
+    }
+    _data = (uint8_t *) data;
+    if (alone) {
+      for (uint64_t slot = 0; slot < _nbSlots; ++slot) {
+        uint64_t word = index(slot).load(std::memory_order_acquire);
+        if ((word & stateMask) == WRITING) {
+          index(slot).store(
+              ((word >> generationShift) + 1) << generationShift,
+              std::memory_order_release);
+        }
+      }
+      flock(_fd, LOCK_SH);
+    }
+  }
+
+  /// \brief Private function. Close the segment, releasing its lock
+  void closeSegment() {
+    if (_fd >= 0) {
+      close(_fd);
+      _fd = -1;
+    }
+  }
+
+  /// \brief Private function. Test if an index word holds a stored tile
+  /// \param word Index word
+  /// \param key Tile index
+  /// \return True if the word holds the tile, stored
+  static bool isStored(uint64_t word, uint64_t key) {
+    return (word & stateMask) == STORED
+        && ((word >> keyShift) & keyMask) == key + 1;
+  }
+
+  /// \brief Private function. Round a value up to a multiple
+  /// \param value Value
+  /// \param multiple Multiple
+  /// \return Value rounded up
+  static uint64_t roundUp(uint64_t value, uint64_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  /// \brief Private function. Get the index of a tile in the level
+  /// \param indexRow Tile row index
+  /// \param indexCol Tile col index
+  /// \return Tile index
+  uint64_t tileIndex(uint32_t indexRow, uint32_t indexCol) const {
+    return (uint64_t) indexRow * _numTilesWidth + indexCol;
+  }
+
+  /// \brief Private function. Get the index word of a slot
+  /// \param slot Slot index
+  /// \return Index word, mapped
+  std::atomic<uint64_t> &index(uint64_t slot) const {
+    return reinterpret_cast<std::atomic<uint64_t> *>(
+        _data + headerSize)[slot];
+  }
+
+  /// \brief Private function. Get the number of tiles stored, shared by the
+  /// processes
+  /// \return Number of tiles stored, mapped
+  std::atomic<uint64_t> &nbStored() const {
+    return *reinterpret_cast<std::atomic<uint64_t> *>(
+        _data + countersOffset);
+  }
+
+  /// \brief Private function. Get the data of a slot
+  /// \param slot Slot index
+  /// \return Slot data, mapped
+  uint8_t *slotData(uint64_t slot) const {
+    return _data + _dataOffset + slot * _tileBytes;
+  }
+
+  /// \brief Private function. Throw an exception with the errno description
+  /// \param reason Reason of the error
+  void throwError(const std::string &reason) const {
+    std::stringstream message;
+    message << "Shared Memory Tier ERROR: " << reason << " (" << _segmentName
+            << "): " << strerror(errno) << ".";
+    std::string m = message.str();
+    throw (FastImageException(m));
+  }
+
+  std::string
+      _header,                ///< Header, identity of the segment
+      _segmentName;           ///< Shared memory segment name
+
+  uint8_t *
+      _data = nullptr;        ///< Mapped segment
+
+  int
+      _fd = -1;               ///< Segment file, locked while mapped
+
+  uint64_t
+      _numTilesWidth,         ///< Number of tiles in a row
+      _tileBytes,             ///< Size of a tile in bytes
+      _nbSlots = 0,           ///< Number of slots
+      _dataOffset = 0,        ///< Offset of the first slot
+      _size = 0;              ///< Segment size
+};
+}
+#endif //FASTIMAGE_SHAREDMEMORYTIER_H
@@ -0,0 +1,92 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+
+/// @file NumaNodeRule.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Rule routing the tile requests to the NUMA node owning the tile
+
+#ifndef FASTIMAGE_NUMANODERULE_H
+#define FASTIMAGE_NUMANODERULE_H
+
+#include <htgs/api/IRule.hpp>
+#include "FastImage/data/TileRequestData.h"
+#include "FastImage/object/NumaTopology.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class NumaNodeRule NumaNodeRule.h <FastImage/rules/NumaNodeRule.h>
+  *
+  * @brief Rule routing the tile requests to the tile loader of a NUMA node
+  * @details The rule of a node only lets the requests of the tiles owned by
+  * its node (NumaTopology::getTileNode) go to the node's tile loader.
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class NumaNodeRule
+    : public htgs::IRule<fi::TileRequestData<UserType>,
+                         fi::TileRequestData<UserType>> {
+ public:
+  /// \brief NumaNodeRule constructor
+  /// \param node NUMA node of the tile loader
+  /// \param nbNodes Number of NUMA nodes
+  NumaNodeRule(uint32_t node, uint32_t nbNodes)
+      : htgs::IRule<fi::TileRequestData<UserType>,
+                    fi::TileRequestData<UserType>>(),
+        _node(node), _nbNodes(nbNodes) {}
+
+  /// \brief Get rule name
+  /// \return Rule Name
+  std::string getName() { return "NumaNodeRule " + std::to_string(_node); }
+
+  /// \brief Apply the rule to the data
+  /// \param data Tile request
+  /// \param pipelineId Pipeline id
+  void applyRule(std::shared_ptr<fi::TileRequestData<UserType>> data,
+                 size_t pipelineId) {
+    const auto &viewRequest = data->getViewRequest();
+    uint32_t numTilesWidth =
+        (viewRequest->getImageWidth() + viewRequest->getTileWidth() - 1)
+            / viewRequest->getTileWidth();
+    if (NumaTopology::getTileNode(data->getIndexColTileAsked(), numTilesWidth,
+                                  _nbNodes) == _node) {
+      this->addResult(data);
+    }
+  }
+
+ private:
+  uint32_t
+      _node,          ///< NUMA node of the tile loader
+      _nbNodes;       ///< Number of NUMA nodes
+};
+}
+
+#endif //FASTIMAGE_NUMANODERULE_H
@@ -35,6 +35,7 @@
 #define FASTIMAGE_RELEASECOUNTRULE_H
 
 #include <cstdint>
+#include <functional>
 #include <htgs/api/IMemoryReleaseRule.hpp>
 
 namespace fi {
@@ -45,6 +46,8 @@ namespace fi {
   *
   * @brief Memory management release rule based on a count that is decremented
   * after each use, and released when the count reaches 0.
+  * @details A callback can be set to free the resources held by the memory
+  * when the count reaches 0, before the memory goes back to the pool.
   **/
 class ReleaseCountRule : public htgs::IMemoryReleaseRule {
  public:
@@ -54,8 +57,17 @@ class ReleaseCountRule : public htgs::IMemoryReleaseRule {
   explicit ReleaseCountRule(uint32_t releaseCount)
       : _releaseCount(releaseCount) {}
 
-  /// \brief Indicate the memory has been used
-  void memoryUsed() override { --_releaseCount; }
+  /// \brief Set the callback called when the count reaches 0
+  /// \param releaseCallback Callback called when the memory is released
+  void setReleaseCallback(std::function<void()> releaseCallback) {
+    _releaseCallback = std::move(releaseCallback);
+  }
+
+  /// \brief Indicate the memory has been used, call the release callback if
+  /// the count reaches 0
+  void memoryUsed() override {
+    if (--_releaseCount == 0 && _releaseCallback) { _releaseCallback(); }
+  }
 
   /// \brief Test if the memory can be released
   /// \return True if the memory can be released, False else
@@ -63,6 +75,9 @@ class ReleaseCountRule : public htgs::IMemoryReleaseRule {
     return _releaseCount == 0;
   }
  private:
+  std::function<void()>
+      _releaseCallback;   ///< Callback called when the memory is released
+
   uint32_t
       _releaseCount = 1;  ///< Number of time the view need to be ask for
   ///< release to actually  be released
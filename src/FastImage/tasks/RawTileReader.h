@@ -0,0 +1,363 @@
+// NIST-developed software is provided by NIST as a public service.
+// You may use, copy and distribute copies of the  software in any  medium,
+// provided that you keep intact this entire notice. You may improve,
+// modify and create derivative works of the software or any portion of the
+// software, and you may copy and distribute such modifications or works.
+// Modified works should carry a notice stating that you changed the software
+// and should note the date and nature of any such change. Please explicitly
+// acknowledge the National Institute of Standards and Technology as the
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW,
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using
+// and distributing the software and you assume  all risks associated with
+// its use, including but not limited to the risks and costs of program
+// errors, compliance  with applicable laws, damage to or loss of data,
+// programs or equipment, and the unavailability or interruption of operation.
+// This software is not intended to be used in any situation where a failure
+// could cause risk of injury or damage to property. The software developed
+// by NIST employees is not subject to copyright protection within
+// the United States.
+
+
+/// @file RawTileReader.h
+/// @author Alexandre Bardakoff - Timothy Blattner
+/// @date  10/16/26
+/// @brief Raw tile reader task, first stage of the split tile loading.
+
+#ifndef FASTIMAGE_RAWTILEREADER_H
+#define FASTIMAGE_RAWTILEREADER_H
+
+#include <htgs/api/ITask.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+#include "FastImage/api/ATileLoader.h"
+#include "FastImage/data/TileRequestData.h"
+#include "FastImage/object/FigCache.h"
+#include "FastImage/object/io/IOUringReader.h"
+#include "FastImage/object/io/PReadPoolReader.h"
+
+namespace fi {
+/// \namespace fi FastImage namespace
+
+/**
+  * @class RawTileReader RawTileReader.h <FastImage/tasks/RawTileReader.h>
+  *
+  * @brief Raw tile reader task. Take a TileRequestData and produce the same
+  * TileRequestData with the raw tile attached.
+  *
+  * @details Optional task between the ViewLoader and the ATileLoader. It
+  * only reads the raw (compressed) tiles from the file, the ATileLoader
+  * decoding them into the cache. The disk reads and the decoding can then be
+  * tuned separately: a few threads for the RawTileReader to keep the disk
+  * busy, and as many ATileLoader threads as cores to decode.
+  * The tiles already in the cache or in its tier are not read. As the cache
+  * is only checked, a tile may be read and then found in the cache by the
+  * ATileLoader, the raw tile is then dropped.
+  * Each RawTileReader thread uses its own copy of the tile loader to read
+  * the file.
+  * The number of threads can be set with
+  * fi::FastImage->getFastImageOptions()->setNumberOfRawTileReader().
+  *
+  * With an asynchronous queue depth, and if the tile loader gives the raw
+  * tiles location (ATileLoader::getRawTileLocation), each thread reads the
+  * raw tiles asynchronously: the reads are sent in batches with io_uring, or
+  * to a pool of pread threads if io_uring is not available, up to queue depth
+  * reads in flight. In a batch, the reads of raw tiles adjacent in the file
+  * (as a row of tiles in a tiled tiff) are coalesced into a single read, up
+  * to maxCoalescedLength bytes, then split into the raw tiles. The task
+  * polls its input, so a partial batch is sent and the completed reads are
+  * forwarded when no request comes, a timed out poll returning at once if no
+  * read is waiting. The task terminates once all its reads are completed.
+  * The reader is created by createAsyncReader, which can be overridden.
+  *
+  * @tparam UserType Pixel Type asked by the end user
+  **/
+template<typename UserType>
+class RawTileReader : public htgs::ITask<fi::TileRequestData<UserType>,
+                                         fi::TileRequestData<UserType>> {
+ public:
+  /// \brief Create a raw tile reader
+  /// \param numThreads Number of threads reading the raw tiles
+  /// \param tileLoader Tile loader used to read the raw tiles, copied
+  /// \param allCache Caches for each pyramid level
+  /// \param asyncQueueDepth Maximum number of asynchronous reads in flight
+  /// per thread, 0 to read synchronously
+  RawTileReader(size_t numThreads,
+                ATileLoader<UserType> *tileLoader,
+                const std::vector<FigCache<UserType> *> &allCache,
+                uint32_t asyncQueueDepth = 0)
+      : htgs::ITask<fi::TileRequestData<UserType>,
+                    fi::TileRequestData<UserType>>(numThreads,
+                                                   false,
+                                                   asyncQueueDepth > 0,
+                                                   pollTimeout),
+        _tileLoader(tileLoader->copyTileLoader()),
+        _allCache(allCache),
+        _asyncQueueDepth(asyncQueueDepth),
+        _batchSize(std::max(asyncQueueDepth / 4, (uint32_t) 1)) {}
+
+  /// \brief RawTileReader destructor, delete the tile loader copy
+  ~RawTileReader() override { delete _tileLoader; }
+
+  /// \brief Create the asynchronous reader of the thread
+  void initialize() override {
+    if (_asyncQueueDepth == 0) { return; }
+    _asyncReader.reset(
+        createAsyncReader(_tileLoader->getFilePath(), _asyncQueueDepth));
+  }
+
+  /// \brief Read the raw tile if not in the cache and send the request to
+  /// the ATileLoader
+  /// \details With the asynchronous reads, the request is sent when its
+  /// read completes. A nullptr request means the poll timed out: the
+  /// partial batch is submitted and a read completion awaited, nothing is
+  /// done if no read is waiting.
+  /// \param tileRequestData Tile request, nullptr if the poll timed out
+  void executeTask(
+      std::shared_ptr<fi::TileRequestData<UserType>> tileRequestData) final {
+    if (tileRequestData == nullptr) {
+      if (_asyncReader != nullptr && !_pendingReads.empty()) {
+        if (!_batch.empty()) { submitBatch(); }
+        completeReads(true);
+      }
+      return;
+    }
+
+    uint32_t
+        row = tileRequestData->getIndexRowTileAsked(),
+        col = tileRequestData->getIndexColTileAsked();
+    uint64_t
+        offset = 0,
+        length = 0;
+
+    FigCache<UserType> *cache = _allCache[this->getPipelineId()];
+    if (cache->isCached(row, col) || cache->isInTier(row, col)) {
+      this->addResult(tileRequestData);
+    } else if (_asyncReader != nullptr
+        && _tileLoader->getRawTileLocation(row, col, offset, length)) {
+      readAsync(tileRequestData, offset, length);
+    } else {
+      tileRequestData->setRawTileRead(
+          _tileLoader->readRawTile(row, col, tileRequestData->getRawTile()));
+      this->addResult(tileRequestData);
+    }
+    if (_asyncReader != nullptr && !_pendingReads.empty()) {
+      completeReads(false);
+    }
+  }
+
+  /// \brief Test if the task can terminate, once its input is terminated
+  /// and all its asynchronous reads are completed
+  /// \param inputConnector Task input connector
+  /// \return True if the task can terminate, else False
+  bool canTerminate(std::shared_ptr<htgs::AnyConnector> inputConnector)
+  override {
+    return inputConnector->isInputTerminated() && _pendingReads.empty();
+  }
+
+  /// \brief Get task name
+  /// \return Task name
+  std::string getName() override { return "RawTileReader"; }
+
+  /// \brief Task copy operator
+  /// \return New Task
+  RawTileReader *copy() override {
+    return new RawTileReader(this->getNumThreads(), _tileLoader, _allCache,
+                             _asyncQueueDepth);
+  }
+
+ protected:
+  /// \brief Create the asynchronous reader of a thread, io_uring if
+  /// available, else a pool of pread threads
+  /// \param filePath Path of the file to read
+  /// \param queueDepth Maximum number of reads in flight
+  /// \return The asynchronous reader
+  virtual AAsyncReader *createAsyncReader(const std::string &filePath,
+                                          uint32_t queueDepth) {
+    if (IOUringReader::isSupported()) {
+      return new IOUringReader(filePath, queueDepth);
+    }
+    return new PReadPoolReader(filePath, queueDepth);
+  }
+
+ private:
+  /// \brief A request waiting for its raw tile read
+  struct PendingRead {
+    std::shared_ptr<fi::TileRequestData<UserType>>
+        tileRequestData;        ///< Tile request
+    std::chrono::high_resolution_clock::time_point
+        begin;                  ///< Read queuing time
+  };
+
+  /// \brief A raw tile read in the batch
+  struct BatchedRead {
+    uint64_t offset;            ///< Raw tile offset in the file
+    uint64_t length;            ///< Raw tile length
+    uint64_t id;                ///< Read identifier
+  };
+
+  /// \brief A read of adjacent raw tiles
+  struct CoalescedRead {
+    std::vector<uint8_t> buffer;          ///< Buffer holding the raw tiles
+    std::vector<BatchedRead> reads;       ///< Raw tiles read, offsets
+                                          ///< relative to the buffer
+  };
+
+  /// \brief Private function. Add the asynchronous read of a raw tile to
+  /// the batch, and submit the batch once full
+  /// \param tileRequestData Tile request
+  /// \param offset Raw tile offset in the file
+  /// \param length Raw tile length
+  void readAsync(
+      const std::shared_ptr<fi::TileRequestData<UserType>> &tileRequestData,
+      uint64_t offset,
+      uint64_t length) {
+    std::vector<uint8_t> &rawTile = tileRequestData->getRawTile();
+    rawTile.resize(length);
+    // Sparse tile, nothing to read
+    if (length == 0) {
+      tileRequestData->setRawTileRead(0);
+      this->addResult(tileRequestData);
+      return;
+    }
+    _pendingReads[_nextReadId] =
+        {tileRequestData, std::chrono::high_resolution_clock::now()};
+    _batch.push_back({offset, length, _nextReadId++});
+    if (_batch.size() >= _batchSize) { submitBatch(); }
+  }
+
+  /// \brief Private function. Submit the batch, coalescing the reads of
+  /// adjacent raw tiles
+  void submitBatch() {
+    std::sort(_batch.begin(), _batch.end(),
+              [](const BatchedRead &lhs, const BatchedRead &rhs) {
+                return lhs.offset < rhs.offset;
+              });
+    for (size_t first = 0, last = 0; first < _batch.size(); first = last) {
+      uint64_t end = _batch[first].offset + _batch[first].length;
+      for (last = first + 1;
+           last < _batch.size() && _batch[last].offset == end
+               && end + _batch[last].length - _batch[first].offset
+                   <= maxCoalescedLength;
+           ++last) {
+        end += _batch[last].length;
+      }
+
+      // Wait for a free slot in the queue
+      while (_asyncReader->getNbPending() >= _asyncQueueDepth) {
+        _asyncReader->submit();
+        completeReads(true);
+      }
+
+      if (last - first == 1) {
+        _asyncReader->read(
+            _pendingReads[_batch[first].id].tileRequestData->getRawTile()
+                .data(),
+            _batch[first].length, _batch[first].offset, _batch[first].id);
+      } else {
+        CoalescedRead &coalescedRead = _coalescedReads[_nextReadId];
+        coalescedRead.buffer.resize(end - _batch[first].offset);
+        for (size_t read = first; read < last; ++read) {
+          coalescedRead.reads.push_back(
+              {_batch[read].offset - _batch[first].offset,
+               _batch[read].length, _batch[read].id});
+        }
+        _asyncReader->read(coalescedRead.buffer.data(),
+                           coalescedRead.buffer.size(),
+                           _batch[first].offset, _nextReadId++);
+      }
+    }
+    _batch.clear();
+    _asyncReader->submit();
+  }
+
+  /// \brief Private function. Send the requests which raw tile read
+  /// completed to the ATileLoader
+  /// \param wait If true, wait for at least one read completion
+  void completeReads(bool wait) {
+    _completedReads.clear();
+    _asyncReader->complete(_completedReads, wait);
+    auto end = std::chrono::high_resolution_clock::now();
+    for (uint64_t id : _completedReads) {
+      auto coalescedRead = _coalescedReads.find(id);
+      if (coalescedRead == _coalescedReads.end()) {
+        completeRead(id, end);
+        continue;
+      }
+      // Split the coalesced read into the raw tiles
+      for (const BatchedRead &read : coalescedRead->second.reads) {
+        std::memcpy(
+            _pendingReads[read.id].tileRequestData->getRawTile().data(),
+            coalescedRead->second.buffer.data() + read.offset, read.length);
+        completeRead(read.id, end);
+      }
+      _coalescedReads.erase(coalescedRead);
+    }
+  }
+
+  /// \brief Private function. Send a request which raw tile is read to the
+  /// ATileLoader
+  /// \param id Read identifier
+  /// \param end Read completion time
+  void completeRead(uint64_t id,
+                    std::chrono::high_resolution_clock::time_point end) {
+    auto pendingRead = _pendingReads.find(id);
+    pendingRead->second.tileRequestData->setRawTileRead(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end - pendingRead->second.begin).count());
+    this->addResult(pendingRead->second.tileRequestData);
+    _pendingReads.erase(pendingRead);
+  }
+
+  /// Input poll timeout in microseconds, with the asynchronous reads
+  static constexpr size_t pollTimeout = 100;
+
+  /// Maximum length of a coalesced read in bytes
+  static constexpr uint64_t maxCoalescedLength = 16 << 20;
+
+  ATileLoader<UserType> *
+      _tileLoader;        ///< Tile loader copy used to read the raw tiles
+
+  std::vector<FigCache<UserType> *>
+      _allCache;          ///< All caches for each pyramid levels
+
+  uint32_t
+      _asyncQueueDepth = 0,   ///< Maximum number of asynchronous reads in
+                              ///< flight, 0 for the synchronous reads
+      _batchSize = 1;         ///< Number of reads submitted together
+
+  // Declared after the pending and coalesced reads, to be destroyed first,
+  // waiting for the reads in flight into their buffers
+  std::unordered_map<uint64_t, PendingRead>
+      _pendingReads{};        ///< Requests waiting for their read
+
+  std::unordered_map<uint64_t, CoalescedRead>
+      _coalescedReads{};      ///< Coalesced reads in flight
+
+  std::unique_ptr<AAsyncReader>
+      _asyncReader{};         ///< Asynchronous reader of the thread
+
+  std::vector<BatchedRead>
+      _batch{};               ///< Reads not submitted yet
+
+  std::vector<uint64_t>
+      _completedReads{};      ///< Identifiers of the completed reads
+
+  uint64_t
+      _nextReadId = 0;        ///< Identifier of the next read
+};
+}
+
+#endif //FASTIMAGE_RAWTILEREADER_H
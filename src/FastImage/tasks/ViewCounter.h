@@ -35,6 +35,7 @@
 #define FASTIMAGE_VIEWCOUNTER_H
 
 #include <algorithm>
+#include <vector>
 
 #include <htgs/api/ITask.hpp>
 #include "FastImage/data/CachedTile.h"
@@ -48,10 +49,12 @@ namespace fi {
   *
   * @brief View Counter, graph's last task, finalise the view.
   *
-  * @details Finalize the view, wait for each pieces of the view to be loaded
-  * from the file. When done, if there is a radius, then a ghost region will
-  * be filled in as needed.
-  * Insure also the order if the option is set.
+  * @details Receives each view once, completed by the tile loaders: the
+  * tile loader copying the last tile of a view, counted atomically in the
+  * view (View::tileLoaded), fills the ghost region and sends the view.
+  * Insure the order if the option is set, else only forwards the views. The
+  * views are ordered by their sequence number, given when requested, in a
+  * ring buffer of the size of the reorder window.
   *
   * @tparam UserType Pixel Type asked by the end user
   **/
@@ -60,10 +63,13 @@ class ViewCounter : public htgs::ITask<fi::TileRequestData<UserType>,
                                        htgs::MemoryData<fi::View<UserType>>> {
  public:
   /// \brief View counter constructor, set if the view are send in ordered way
-  /// or not, and set the filling type.
-  explicit ViewCounter(FillingType fillingType = FillingType::FILL,
-                       bool ordered = false)
-      : _fillingType(fillingType), _ordered(ordered) {}
+  /// or not.
+  /// \param ordered True if the views are sent in the requested order
+  /// \param reorderWindow Number of views the reorder buffer holds at first,
+  /// grown if a view arrives further ahead
+  explicit ViewCounter(bool ordered = false, uint32_t reorderWindow = 1)
+      : _reorderBuffer(std::max(reorderWindow, (uint32_t) 1)),
+        _ordered(ordered) {}
 
   /// \brief View counter destructor
   ~ViewCounter() = default;
@@ -72,209 +78,82 @@ class ViewCounter : public htgs::ITask<fi::TileRequestData<UserType>,
   /// \return Task name
   std::string getName() { return "ViewCounter"; }
 
-  /// \brief Add a traversal to insure ordering.
-  void addTraversal(std::queue<std::pair<uint32_t, uint32_t>> traversal) {
-    _queueTraversals.push(traversal);
-  }
-
-  /// \brief Wait for the view data to be fully loaded from the file data,
-  /// Fill the ghost region if needed, send the viewData when completed
-  /// \param tileRequestData Tile from the tile loader to test
+  /// \brief Send the view completed by the tile loaders, in the requested
+  /// order if the order is preserved
+  /// \details The tile loader copying the last tile of a view fills the
+  /// ghost region and sends only this tile request, so each view is received
+  /// once.
+  /// \param tileRequestData Tile request of the tile completing the view
   void executeTask(
       std::shared_ptr<fi::TileRequestData<UserType>> tileRequestData) {
-    auto data = tileRequestData->getViewData();
-
-    // Tile without radius
-    if (tileRequestData->getViewRequest()->getNumberTilesToLoad() == 1 ||
-        tileRequestData->getViewRequest()->getRadius() == 0) {
-      fillGhostRegion(tileRequestData);
-      dataReady(data);
-      //this->addResult(data);
-    } else {
-      // Tile with radius
-      auto itPos = _countMap.find(data);
-      if (itPos != _countMap.end()) {
-        // Found pointer, so increment
-        (*itPos).second++;
-        auto val = (*itPos).second;
-        // If all the tiles have been collected for the view, then the view is
-        // complete
-        if (val == tileRequestData->getViewRequest()->getNumberTilesToLoad()) {
-          _countMap.erase(data);
-          fillGhostRegion(tileRequestData);
-          dataReady(data);
-          //this->addResult(data);
-        }
-      } else {
-        // Pointer was not found, so add it in with initial count of 1
-        _countMap.
-        insert(std::pair<htgs::m_data_t<View<UserType>>, uint32_t>(data, 1));
-      }
-    }
+    dataReady(tileRequestData->getViewData());
   }
 
+  /// \brief Get the number of views the reorder buffer holds
+  /// \return Reorder window
+  size_t getReorderWindow() const { return _reorderBuffer.size(); }
+
   /// \brief Copy operator
   /// \return New task
-  ViewCounter *copy() { return new ViewCounter(); }
-
- private:
-  /// \brief Filling type where the data are duplicated from the nearest
-  /// border :
-  /// radius 1 for a 3x3 tile with only ghost region
-  ///      a  abc  c
-  ///
-  ///      a  abc  c
-  ///      d  def  f
-  ///      g  ghi  i
-  ///
-  ///      g  ghi  i
-  ///
-  /// \param tileRequestData
-  void fill(
-      std::shared_ptr<fi::TileRequestData<UserType>> tileRequestData) {
-
-    UserType *tile = tileRequestData->getViewData()->get()->getData();
-
-    uint32_t
-        topFill = tileRequestData->getTopToFill(),
-        bottomFill = tileRequestData->getBottomToFill(),
-        leftFill = tileRequestData->getLeftToFill(),
-        rightFill = tileRequestData->getRightToFill(),
-        viewHeight = tileRequestData->getViewHeight(),
-        viewWidth = tileRequestData->getViewWidth();
-
-    for (uint32_t row = topFill; row < viewHeight - bottomFill; ++row) {
-      // L
-      std::fill_n(
-          tile + (row * viewWidth),
-          leftFill,
-          tile[row * viewWidth + leftFill]);
-      // R
-      std::fill_n(
-          tile + (row * viewWidth + viewWidth - rightFill),
-          rightFill,
-          tile[row * viewWidth + viewWidth - rightFill - 1]);
-    }
-    for (uint32_t row = 0; row < topFill; ++row) {
-      // UL
-      std::fill_n(
-          tile + (row * viewWidth),
-          leftFill,
-          tile[topFill * viewWidth + leftFill]);
-      // U
-      std::copy_n(
-          tile + (topFill * viewWidth + leftFill),
-          viewWidth - leftFill - rightFill,
-          tile + (row * viewWidth + leftFill));
-      // UR
-      std::fill_n(
-          tile + (row * viewWidth + viewWidth - rightFill),
-          rightFill,
-          tile[row * viewWidth + viewWidth - rightFill - 1]);
-    }
-    for (uint32_t row = viewHeight - bottomFill; row < viewHeight; ++row) {
-      // BL
-      std::fill_n(
-          tile + (row * viewWidth),
-          leftFill,
-          tile[(viewHeight - bottomFill - 1) * viewWidth + leftFill]);
-      // B
-      std::copy_n(
-          tile + ((viewHeight - bottomFill - 1) * viewWidth + leftFill),
-          viewWidth - leftFill - rightFill,
-          tile + (row * viewWidth + leftFill));
-      // BR
-      std::fill_n(
-          tile + (row * viewWidth + viewWidth - rightFill),
-          rightFill,
-          tile[(viewHeight - bottomFill) * viewWidth - rightFill - 1]);
-    }
+  ViewCounter *copy() {
+    return new ViewCounter(_ordered, (uint32_t) _reorderBuffer.size());
   }
 
-  /// \brief Switch for the selected filling and fill the ghost region
-  /// \param tileRequestData tile to fill
-  void fillGhostRegion(
-      std::shared_ptr<fi::TileRequestData<UserType>> tileRequestData) {
-    switch (_fillingType) {
-      case FillingType::FILL:fill(tileRequestData);
-        break;
-    }
-  }
-
-  /// \brief Update the current traversal, used for insure ordering
-  void updateCurrentTraversal() {
-    if (_currentTraversal.size() == 0 && _queueTraversals.size() > 0) {
-      _currentTraversal = _queueTraversals.front();
-      _queueTraversals.pop();
-    }
-  }
-
-  /// \brief Test if the view received is next one to be send if order needed.
-  /// \param view View to test
-  /// \return True if the view is the next one to be sent, else Fasle
-  bool viewIsNext(htgs::m_data_t<fi::View<UserType>> view) {
-    return view->get()->getRow() == _currentTraversal.front().first
-        && view->get()->getCol() == _currentTraversal.front().second;
-  }
-
-  /// \brief Try to send already stored view
-  void handleStoredViews() {
-    bool elementFound = true;
-    std::pair<uint32_t, uint32_t> frontCoord;
-    while (elementFound) {
-      elementFound = false;
-      updateCurrentTraversal();
-      frontCoord = _currentTraversal.front();
-      for (auto view = _waitingList.begin(); view != _waitingList.end();
-           ++view) {
-        if (viewIsNext(*view)) {
-          this->addResult(*view);
-          _waitingList.remove(*view);
-          _currentTraversal.pop();
-          updateCurrentTraversal();
-          elementFound = true;
-          break;
-        }
+ private:
+  /// \brief Grow the reorder buffer to hold a view further ahead
+  /// \details The views held are moved to their slot in the new buffer.
+  /// \param sequenceNumber Sequence number of the view to hold
+  void growReorderBuffer(uint64_t sequenceNumber) {
+    std::vector<htgs::m_data_t<fi::View<UserType>>> reorderBuffer(
+        std::max(2 * _reorderBuffer.size(),
+                 (size_t) (sequenceNumber - _nextSequenceNumber + 1)));
+    for (auto &view : _reorderBuffer) {
+      if (view != nullptr) {
+        reorderBuffer[view->get()->getSequenceNumber()
+            % reorderBuffer.size()] = std::move(view);
       }
     }
+    _reorderBuffer = std::move(reorderBuffer);
   }
 
-  /// \brief Send the current view if no ordered, or handle the traversal and
-  /// the views.
+  /// \brief Send the current view if no ordered, or hold it in the reorder
+  /// buffer and send the views following the last one sent.
+  /// \details The views are held in a ring buffer indexed by their sequence
+  /// number, so each view is held and sent in constant time.
   /// \param view View ready to be sent or stored.
   void dataReady(htgs::m_data_t<fi::View<UserType>> view) {
     if (!_ordered) {
       this->addResult(view);
-    } else {
-      updateCurrentTraversal();
-      if (viewIsNext(view)) {
-        this->addResult(view);
-        _currentTraversal.pop();
-        handleStoredViews();
-      } else {
-        _waitingList.push_back(view);
-      }
+      return;
     }
-  }
-
-  FillingType
-      _fillingType;   ///< Filling Type to choose the fill
-
-  std::unordered_map<htgs::m_data_t<fi::View<UserType>>, uint32_t>
-      _countMap;  ///< Map between the view, and the number of tiles loaded
 
-  std::list<htgs::m_data_t<fi::View<UserType>>>
-      _waitingList; ///< Views stored because not in the right order
+    uint64_t sequenceNumber = view->get()->getSequenceNumber();
+    if (sequenceNumber - _nextSequenceNumber >= _reorderBuffer.size()) {
+      growReorderBuffer(sequenceNumber);
+    }
+    _reorderBuffer[sequenceNumber % _reorderBuffer.size()] = std::move(view);
+
+    // Send the views following the last one sent
+    auto *next = &_reorderBuffer[_nextSequenceNumber % _reorderBuffer.size()];
+    while (*next != nullptr) {
+      this->addResult(std::move(*next));
+      *next = nullptr;
+      ++_nextSequenceNumber;
+      next = &_reorderBuffer[_nextSequenceNumber % _reorderBuffer.size()];
+    }
+  }
 
-  std::queue<std::queue<std::pair<uint32_t, uint32_t>>>
-      _queueTraversals; ///< List of traversals
+  std::vector<htgs::m_data_t<fi::View<UserType>>>
+      _reorderBuffer;               ///< Views held until the views before them
+                                    ///< are sent, per sequence number modulo
+                                    ///< the buffer size
 
-  std::queue<std::pair<uint32_t, uint32_t>>
-      _currentTraversal; ///< Current traversal
+  uint64_t
+      _nextSequenceNumber = 0;      ///< Sequence number of the next view to
+                                    ///< send
 
   bool
-      _ordered; ///< Order preserved
-
+      _ordered;                     ///< Order preserved
 };
 }
 #endif //FASTIMAGE_VIEWCOUNTER_H
@@ -38,6 +38,7 @@
 
 #include <htgs/api/ITask.hpp>
 
+#include "FastImage/memory/RequestPool.h"
 #include "FastImage/rules/ReleaseCountRule.h"
 #include "FastImage/data/ViewRequestData.h"
 #include "FastImage/data/TileRequestData.h"
@@ -61,6 +62,11 @@ namespace fi {
   * been released. The number of views available to the memory manager can
   * be specified from
   * fi::FastImage->getFastImageOptions()->setNumberOfViewParallel().
+  * A prefetch view request does not take a view from the MemoryManager, its
+  * tile requests are only used to load the tiles in the cache ahead of the
+  * views needing them.
+  * The tile requests are allocated from a fi::RequestPool, recycling the
+  * requests released by the ATileLoader.
   *
   * @tparam UserType Pixel Type asked by the end user
   **/
@@ -86,11 +92,20 @@ class ViewLoader : public htgs::ITask<fi::ViewRequestData<UserType>,
     if (_nbReleasePyramid[this->getPipelineId()] == 0) {
       return;
     }
+    if (viewRequest->isPrefetch()) {
+      prefetchView(viewRequest);
+      return;
+    }
+    auto releaseRule =
+        new ReleaseCountRule(_nbReleasePyramid[this->getPipelineId()]);
     htgs::m_data_t<View<UserType>> viewMemory = ViewLoader<UserType>::template getMemory<View<UserType>>(
-            "viewMem",
-            new ReleaseCountRule(_nbReleasePyramid[this->getPipelineId()]));
+            "viewMem", releaseRule);
     viewMemory->get()->init(viewRequest);
 
+    // Release the cached tile referenced by a zero-copy view with the view
+    View<UserType> *view = viewMemory->get();
+    releaseRule->setReleaseCallback([view]() { view->releaseTile(); });
+
     uint32_t
         tileHeight = viewRequest->getTileHeight(),
         tileWidth = viewRequest->getTileWidth(),
@@ -132,8 +147,8 @@ class ViewLoader : public htgs::ITask<fi::ViewRequestData<UserType>,
 
         // Create the tile request
         auto tileRequestData =
-            new fi::TileRequestData<UserType>(r, c, viewMemory,
-                                                  viewRequest);
+            makePooled<fi::TileRequestData<UserType>>(
+                r, c, viewMemory, viewRequest);
         tileRequestData->setRowFrom(rowFrom);
         tileRequestData->setColFrom(colFrom);
         tileRequestData->setRowDest(rowAlreadyFilled);
@@ -160,6 +175,21 @@ class ViewLoader : public htgs::ITask<fi::ViewRequestData<UserType>,
   ViewLoader *copy() { return new ViewLoader(this->_nbReleasePyramid); }
 
  private:
+  /// \brief Private function. Generate the tile requests to prefetch the
+  /// view's tiles, without view attached.
+  /// \param viewRequest Prefetch view request
+  void prefetchView(
+      const std::shared_ptr<fi::ViewRequestData<UserType>> &viewRequest) {
+    for (uint32_t r = viewRequest->getIndexRowMinTile();
+         r < viewRequest->getIndexRowMaxTile(); r++) {
+      for (uint32_t c = viewRequest->getIndexColMinTile();
+           c < viewRequest->getIndexColMaxTile(); c++) {
+        this->addResult(makePooled<fi::TileRequestData<UserType>>(
+            r, c, nullptr, viewRequest));
+      }
+    }
+  }
+
   std::vector<uint32_t>
       _nbReleasePyramid; ///< Nb of release per level
 };
@@ -43,6 +43,7 @@
 #include "testFastImageGlobal.h"
 #include "testViewLoader.h"
 #include "testFITGT.h"
+#include "testPixelConverter.h"
 
 void mosaicCreation() {
   auto
@@ -150,6 +151,91 @@ TEST(TEST_CACHE, GET_TILES) {
   ASSERT_NO_FATAL_FAILURE(getNewTiles(10, 1, 5, 16, 16));
 }
 
+TEST(TEST_CACHE, GET_TILES_CONCURRENTLY) {
+  ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(0, 5, 5, 8));
+  ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(25, 5, 5, 8));
+  ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(4, 5, 5, 8));
+}
+
+TEST(TEST_CACHE, SHARED_READS) {
+  ASSERT_NO_FATAL_FAILURE(readTilesConcurrently(25, 5, 5, 8));
+  ASSERT_NO_FATAL_FAILURE(readTilesConcurrently(4, 5, 5, 8));
+}
+
+TEST(TEST_CACHE, SHARDED_CACHE) {
+  ASSERT_NO_FATAL_FAILURE(createInitShardedCache(0, 4, 5, 5));
+  ASSERT_NO_FATAL_FAILURE(createInitShardedCache(3, 8, 5, 5));
+  ASSERT_NO_FATAL_FAILURE(createInitShardedCache(25, 0, 5, 5));
+  ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(0, 5, 5, 8, 4));
+  ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(25, 5, 5, 8, 5));
+  ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(8, 5, 5, 8, 8));
+}
+
+TEST(TEST_CACHE, EVICTION_POLICIES) {
+  for (auto policy : {fi::EvictionPolicyType::LRU,
+                      fi::EvictionPolicyType::CLOCK,
+                      fi::EvictionPolicyType::ARC,
+                      fi::EvictionPolicyType::MIN}) {
+    ASSERT_NO_FATAL_FAILURE(getTilesWithPolicy(policy, 4, 5, 5));
+    ASSERT_NO_FATAL_FAILURE(getTilesWithPolicy(policy, 25, 5, 5));
+    ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(4, 5, 5, 8, 1, policy));
+    ASSERT_NO_FATAL_FAILURE(getTilesConcurrently(8, 5, 5, 8, 4, policy));
+  }
+  ASSERT_NO_FATAL_FAILURE(compareMinToLru(8, 5));
+  ASSERT_NO_FATAL_FAILURE(ignoreUnregisteredAccesses());
+  ASSERT_NO_FATAL_FAILURE(compareArcToLru());
+}
+
+TEST(TEST_CACHE, RESIZE_CACHE) {
+  for (auto policy : {fi::EvictionPolicyType::LRU,
+                      fi::EvictionPolicyType::CLOCK,
+                      fi::EvictionPolicyType::ARC,
+                      fi::EvictionPolicyType::MIN}) {
+    ASSERT_NO_FATAL_FAILURE(resizeCache(policy));
+  }
+  ASSERT_NO_FATAL_FAILURE(shareCacheBudget());
+}
+
+TEST(TEST_CACHE, COMPACT_TIER) {
+  ASSERT_NO_FATAL_FAILURE(compactTierRoundTrip<uint8_t>());
+  ASSERT_NO_FATAL_FAILURE(compactTierRoundTrip<uint16_t>());
+  ASSERT_NO_FATAL_FAILURE(compactTierRoundTrip<int32_t>());
+  ASSERT_NO_FATAL_FAILURE(compactTierRoundTrip<uint64_t>());
+  ASSERT_NO_FATAL_FAILURE(compactTierRoundTrip<float>());
+  ASSERT_NO_FATAL_FAILURE(compactTierRoundTrip<double>());
+  ASSERT_NO_FATAL_FAILURE(recycleTilesInTier());
+  ASSERT_NO_FATAL_FAILURE(storeTilesOutOfShardLock());
+}
+
+TEST(TEST_CACHE, SPILL_TIER) {
+  ASSERT_NO_FATAL_FAILURE(spillTilesToDisk());
+  ASSERT_NO_FATAL_FAILURE(limitSpillFile());
+}
+
+TEST(TEST_CACHE, SHARE_CACHE) {
+  ASSERT_NO_FATAL_FAILURE(shareCacheRegistry());
+}
+
+TEST(TEST_CACHE, SHARED_MEMORY_TIER) {
+  ASSERT_NO_FATAL_FAILURE(shareTilesBetweenProcesses());
+}
+
+TEST(TEST_CACHE, TILE_ARENA) {
+  ASSERT_NO_FATAL_FAILURE(allocateTilesInArena());
+}
+
+TEST(TEST_CACHE, NUMA_CACHE) {
+  ASSERT_NO_FATAL_FAILURE(partitionCacheByNumaNode());
+}
+
+TEST(TEST_CACHE, CACHE_SIMULATOR) {
+  ASSERT_NO_FATAL_FAILURE(simulateCache());
+}
+
+TEST(TEST_CACHE, CACHE_METRICS) {
+  ASSERT_NO_FATAL_FAILURE(collectCacheMetrics());
+}
+
 TEST(TEST_VIEW_LOADER, TEST_VIEW_REQUEST_DATA) {
   ASSERT_NO_FATAL_FAILURE(testViewRequestData());
 }
@@ -159,14 +245,31 @@ TEST(TEST_VIEW_LOADER, TEST_VIEW_LOADING) {
   ASSERT_NO_FATAL_FAILURE(testViewLoaderTileGhostBR());
 }
 
+TEST(TEST_VIEW_LOADER, TEST_REQUEST_POOL) {
+  ASSERT_NO_FATAL_FAILURE(recycleRequests());
+}
+
 TEST(TEST_TILE_LOADER, TEST_TILE_LOADING) {
   ASSERT_NO_FATAL_FAILURE(testTileLoading());
+  ASSERT_NO_FATAL_FAILURE(testTileDecoding());
+  ASSERT_NO_FATAL_FAILURE(testRawTileDecoding());
+  ASSERT_NO_FATAL_FAILURE(testFailedTileLoading());
+}
+
+TEST(TEST_TILE_LOADER, TEST_MMAP_LOADING) {
+  ASSERT_NO_FATAL_FAILURE(testMMapTiffTileLoading());
+  ASSERT_NO_FATAL_FAILURE(testMMapRawTileLoading());
+}
+
+TEST(TEST_TILE_LOADER, TEST_PIXEL_CONVERSION) {
+  ASSERT_NO_FATAL_FAILURE(testPixelConversion());
 }
 
 TEST(TEST_VIEW_COUNTER, TEST_VIEW_CREATION) {
   ASSERT_NO_FATAL_FAILURE(testViewCounterNoRadius());
   ASSERT_NO_FATAL_FAILURE(testViewCounterRadiusUL());
   ASSERT_NO_FATAL_FAILURE(testViewCounterRadiusBR());
+  ASSERT_NO_FATAL_FAILURE(testViewCompletedByLoader());
 }
 
 TEST(TEST_GLOBAL, TEST_PROCESS) {
@@ -175,6 +278,34 @@ TEST(TEST_GLOBAL, TEST_PROCESS) {
   ASSERT_NO_FATAL_FAILURE(testSingleTile());
 }
 
+TEST(TEST_GLOBAL, TEST_PREFETCH) {
+  ASSERT_NO_FATAL_FAILURE(testWholeImagePrefetch());
+}
+
+TEST(TEST_GLOBAL, TEST_RAW_TILE_READER) {
+  ASSERT_NO_FATAL_FAILURE(testWholeImageRawTileReader());
+}
+
+TEST(TEST_GLOBAL, TEST_ASYNC_READ) {
+  ASSERT_NO_FATAL_FAILURE(testWholeImageAsyncRead());
+  ASSERT_NO_FATAL_FAILURE(testAsyncRawTileReading<fi::IOUringReader>());
+  ASSERT_NO_FATAL_FAILURE(testAsyncRawTileReading<fi::PReadPoolReader>());
+  ASSERT_NO_FATAL_FAILURE(testCoalescedRawTileReading());
+}
+
+TEST(TEST_GLOBAL, TEST_ZERO_COPY) {
+  ASSERT_NO_FATAL_FAILURE(testWholeImageZeroCopy());
+  ASSERT_NO_FATAL_FAILURE(referenceCachedTile());
+  ASSERT_NO_FATAL_FAILURE(waitForUnpinnedTile());
+  ASSERT_NO_FATAL_FAILURE(testZeroCopyCacheBudget());
+}
+
+TEST(TEST_GLOBAL, TEST_REGION) {
+  ASSERT_NO_FATAL_FAILURE(testRegion());
+  ASSERT_NO_FATAL_FAILURE(testRegionFailedTile());
+  ASSERT_NO_FATAL_FAILURE(testRegionPyramid());
+}
+
 TEST(TEST_EXCEPTION, TEST_FAILURE) {
   ASSERT_NO_FATAL_FAILURE(testOutOfBounds());
   ASSERT_NO_FATAL_FAILURE(testCacheOutOfBounds());
@@ -182,6 +313,7 @@ TEST(TEST_EXCEPTION, TEST_FAILURE) {
 
 TEST(TEST_ORDERING, TEST_ORDERING) {
   ASSERT_TRUE(testOrdered());
+  ASSERT_TRUE(testOrdered(1));
 }
 
 TEST(TEST_FITGTASK, TEST_TGTASK){
@@ -34,8 +34,31 @@
 #define FASTIMAGE_TESTCACHE_H
 
 #include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/statvfs.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <vector>
 #include "FastImage/object/FigCache.h"
+#include "FastImage/object/CacheBudget.h"
+#include "FastImage/object/CacheRegistry.h"
+#include "FastImage/object/CacheSimulator.h"
+#include "FastImage/object/CacheMetrics.h"
+#include "FastImage/api/View.h"
+#include "FastImage/rules/ReleaseCountRule.h"
+#include "FastImage/memory/TileArena.h"
+#include "FastImage/object/NumaTopology.h"
+#include "FastImage/object/tier/CompactMemoryTier.h"
+#include "FastImage/object/tier/SharedMemoryTier.h"
+#include "FastImage/object/tier/DiskSpillTier.h"
+#include "FastImage/TileLoaders/GrayscaleTiffTileLoader.h"
 
 void createNewCache(uint32_t numTileCache) {
   fi::FigCache<int> cache(numTileCache);
@@ -128,4 +151,1024 @@ void getNewTiles(uint32_t numTileCache,
   ASSERT_EQ(cache.getLru().front(), cache.getMapCache()[0][0]);
 }
 
+void createInitShardedCache(uint32_t numTileCache,
+                            uint32_t nbShards,
+                            uint32_t numTilesHeight,
+                            uint32_t numTilesWidth) {
+  fi::FigCache<int> cache(numTileCache, nbShards);
+  cache.initCache(numTilesHeight, numTilesWidth, 16, 16);
+
+  ASSERT_LE(cache.getNbShards(), cache.getNbTilesCache());
+  ASSERT_LE(cache.getNbShards(), std::max(nbShards, (uint32_t) 1));
+  size_t nbTilesInShards = 0;
+  for (uint32_t shard = 0; shard < cache.getNbShards(); ++shard) {
+    ASSERT_GE(cache.getPool(shard).size(), (size_t) 1);
+    nbTilesInShards += cache.getPool(shard).size();
+  }
+  ASSERT_EQ(nbTilesInShards, cache.getNbTilesCache());
+  for (uint32_t row = 0; row < numTilesHeight; ++row) {
+    for (uint32_t col = 0; col < numTilesWidth; ++col) {
+      ASSERT_LT(cache.shardIndex(row, col), cache.getNbShards());
+    }
+  }
+}
+
+void getTilesConcurrently(uint32_t numTileCache,
+                          uint32_t numTilesHeight,
+                          uint32_t numTilesWidth,
+                          uint32_t numThreads,
+                          uint32_t nbShards = 1,
+                          fi::EvictionPolicyType policy =
+                          fi::EvictionPolicyType::LRU) {
+  fi::FigCache<int> cache(numTileCache, nbShards, policy);
+  cache.initCache(numTilesHeight, numTilesWidth, 4, 4);
+
+  std::atomic<uint32_t>
+      nbLoads(0),
+      nbErrors(0);
+  std::vector<std::thread> threads;
+
+  for (uint32_t thread = 0; thread < numThreads; ++thread) {
+    threads.emplace_back([&]() {
+      for (uint32_t round = 0; round < 3; ++round) {
+        for (uint32_t row = 0; row < numTilesHeight; ++row) {
+          for (uint32_t col = 0; col < numTilesWidth; ++col) {
+            auto tile = cache.getLockedTile(row, col);
+            if (tile->isNewTile()) {
+              std::fill_n(tile->getData(), 16, row * numTilesWidth + col);
+              tile->setNewTile(false);
+              ++nbLoads;
+            }
+            if (tile->getData()[15] != (int) (row * numTilesWidth + col)) {
+              ++nbErrors;
+            }
+            tile->unlock();
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  ASSERT_EQ(nbErrors, (uint32_t) 0);
+  ASSERT_EQ(cache.getHit() + cache.getMiss(),
+            3 * numThreads * numTilesHeight * numTilesWidth);
+  size_t nbTilesInShards = 0;
+  for (uint32_t shard = 0; shard < cache.getNbShards(); ++shard) {
+    nbTilesInShards += cache.getPool(shard).size() + cache.getLru(shard).size();
+  }
+  ASSERT_EQ(nbTilesInShards, cache.getNbTilesCache());
+  if (cache.getNbTilesCache() == numTilesHeight * numTilesWidth) {
+    ASSERT_EQ(nbLoads, numTilesHeight * numTilesWidth);
+  }
+}
+
+void readTilesConcurrently(uint32_t numTileCache,
+                           uint32_t numTilesHeight,
+                           uint32_t numTilesWidth,
+                           uint32_t numThreads) {
+  fi::FigCache<int> cache(numTileCache);
+  cache.initCache(numTilesHeight, numTilesWidth, 4, 4);
+
+  std::atomic<uint32_t>
+      nbLoads(0),
+      nbErrors(0);
+  std::vector<std::thread> threads;
+
+  // Every thread reads the same tiles at the same time, only one loads each
+  for (uint32_t thread = 0; thread < numThreads; ++thread) {
+    threads.emplace_back([&]() {
+      for (uint32_t round = 0; round < 3; ++round) {
+        for (uint32_t row = 0; row < numTilesHeight; ++row) {
+          for (uint32_t col = 0; col < numTilesWidth; ++col) {
+            auto tile = cache.getPinnedTile(row, col);
+            if (tile->beginLoading()) {
+              std::fill_n(tile->getData(), 16, row * numTilesWidth + col);
+              tile->setReady();
+              ++nbLoads;
+            }
+            if (tile->getState() != fi::TileState::READY
+                || tile->getData()[15] != (int) (row * numTilesWidth + col)) {
+              ++nbErrors;
+            }
+            tile->release();
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+
+  ASSERT_EQ(nbErrors, (uint32_t) 0);
+  ASSERT_EQ(cache.getHit() + cache.getMiss(),
+            3 * numThreads * numTilesHeight * numTilesWidth);
+  ASSERT_EQ(nbLoads, cache.getMiss());
+  if (cache.getNbTilesCache() == numTilesHeight * numTilesWidth) {
+    ASSERT_EQ(nbLoads, numTilesHeight * numTilesWidth);
+  }
+}
+
+uint32_t countHits(fi::FigCache<int> &cache,
+                   const std::vector<std::pair<uint32_t, uint32_t>> &accesses) {
+  for (auto &access : accesses) {
+    auto tile = cache.getLockedTile(access.first, access.second);
+    tile->setNewTile(false);
+    tile->unlock();
+  }
+  return cache.getHit();
+}
+
+void getTilesWithPolicy(fi::EvictionPolicyType policy,
+                        uint32_t numTileCache,
+                        uint32_t numTilesHeight,
+                        uint32_t numTilesWidth) {
+  fi::FigCache<int> cache(numTileCache, 1, policy);
+  cache.initCache(numTilesHeight, numTilesWidth, 4, 4);
+  uint32_t nbTilesCache = cache.getNbTilesCache();
+
+  std::vector<std::pair<uint32_t, uint32_t>> accesses;
+  for (uint32_t round = 0; round < 2; ++round) {
+    for (uint32_t row = 0; row < numTilesHeight; ++row) {
+      for (uint32_t col = 0; col < numTilesWidth; ++col) {
+        accesses.emplace_back(row, col);
+      }
+    }
+  }
+  countHits(cache, accesses);
+
+  ASSERT_EQ(cache.getHit() + cache.getMiss(), accesses.size());
+  ASSERT_EQ(cache.getPool().size() + cache.getLru().size(), nbTilesCache);
+  uint32_t nbTilesInMap = 0;
+  for (auto &row : cache.getMapCache()) {
+    for (auto tile : row) { nbTilesInMap += (tile != nullptr); }
+  }
+  ASSERT_EQ(nbTilesInMap, cache.getLru().size());
+  for (auto tile : cache.getLru()) {
+    ASSERT_EQ(cache.getMapCache()[tile->getIndexRowGlobal()]
+                                 [tile->getIndexColGlobal()], tile);
+  }
+}
+
+void compareMinToLru(uint32_t numTileCache, uint32_t numTilesSide) {
+  // Cyclic accesses over more tiles than the cache can hold, LRU never hits
+  std::vector<std::pair<uint32_t, uint32_t>> accesses;
+  for (uint32_t round = 0; round < 4; ++round) {
+    for (uint32_t row = 0; row < numTilesSide; ++row) {
+      for (uint32_t col = 0; col < numTilesSide; ++col) {
+        accesses.emplace_back(row, col);
+      }
+    }
+  }
+
+  fi::FigCache<int> lru(numTileCache, 1, fi::EvictionPolicyType::LRU);
+  lru.initCache(numTilesSide, numTilesSide, 4, 4);
+  fi::FigCache<int> min(numTileCache, 1, fi::EvictionPolicyType::MIN);
+  min.initCache(numTilesSide, numTilesSide, 4, 4);
+  ASSERT_FALSE(lru.needsFutureAccesses());
+  ASSERT_TRUE(min.needsFutureAccesses());
+  std::vector<uint64_t> positions;
+  for (auto &access : accesses) {
+    positions.push_back(min.addFutureAccess(access.first, access.second));
+  }
+
+  uint32_t hitsLru = countHits(lru, accesses);
+  for (size_t access = 0; access < accesses.size(); ++access) {
+    auto tile = min.getLockedTile(accesses[access].first,
+                                  accesses[access].second, positions[access]);
+    tile->setNewTile(false);
+    tile->unlock();
+  }
+  ASSERT_EQ(hitsLru, (uint32_t) 0);
+  ASSERT_GT(min.getHit(), hitsLru);
+}
+
+void ignoreUnregisteredAccesses() {
+  // Registered accesses: A, B, C, A, B
+  fi::FigCache<int> cache(2, 1, fi::EvictionPolicyType::MIN);
+  cache.initCache(1, 3, 4, 4);
+  std::vector<uint64_t> positions;
+  for (uint32_t col : {0, 1, 2, 0, 1}) {
+    positions.push_back(cache.addFutureAccess(0, col));
+  }
+  cache.getPinnedTile(0, 0, positions[0])->release();
+  cache.getPinnedTile(0, 1, positions[1])->release();
+
+  // A region access to A does not consume its next access, B accessed after
+  // A is recycled for C
+  cache.getPinnedTile(0, 0)->release();
+  cache.getPinnedTile(0, 2, positions[2])->release();
+  ASSERT_TRUE(cache.isCached(0, 0));
+  ASSERT_FALSE(cache.isCached(0, 1));
+
+  cache.getPinnedTile(0, 0, positions[3])->release();
+  ASSERT_EQ(cache.getHit(), (uint32_t) 2);
+}
+
+void registerAccessesToCachedTiles(uint32_t colKept) {
+  // Accesses A, B registered and made, then C and one of A, B registered as
+  // the tiles are already cached: the tile without next access is recycled
+  // for C, whatever the order of the tiles with no next access before
+  fi::FigCache<int> cache(2, 1, fi::EvictionPolicyType::MIN);
+  cache.initCache(1, 4, 4, 4);
+  uint64_t positionA = cache.addFutureAccess(0, 0);
+  uint64_t positionB = cache.addFutureAccess(0, 1);
+  cache.getPinnedTile(0, 0, positionA)->release();
+  cache.getPinnedTile(0, 1, positionB)->release();
+
+  uint64_t positionC = cache.addFutureAccess(0, 2);
+  uint64_t positionKept = cache.addFutureAccess(0, colKept);
+  cache.getPinnedTile(0, 2, positionC)->release();
+  ASSERT_TRUE(cache.isCached(0, colKept));
+  ASSERT_FALSE(cache.isCached(0, 1 - colKept));
+
+  cache.getPinnedTile(0, colKept, positionKept)->release();
+  ASSERT_EQ(cache.getHit(), (uint32_t) 1);
+  ASSERT_EQ(cache.getMetrics().reloads, (uint64_t) 0);
+}
+
+void compareArcToLru() {
+  // A hot set of 4 tiles accessed twice between scans of new tiles. LRU
+  // flushes the hot set at each scan, ARC keeps it
+  std::vector<std::pair<uint32_t, uint32_t>> accesses;
+  uint32_t scanned = 4;
+  for (uint32_t round = 0; round < 20; ++round) {
+    for (uint32_t hot = 0; hot < 8; ++hot) {
+      accesses.emplace_back(0, hot % 4);
+    }
+    for (uint32_t scan = 0; scan < 6; ++scan, ++scanned) {
+      accesses.emplace_back(scanned / 12, scanned % 12);
+    }
+  }
+
+  fi::FigCache<int> lru(8, 1, fi::EvictionPolicyType::LRU);
+  lru.initCache(12, 12, 4, 4);
+  fi::FigCache<int> arc(8, 1, fi::EvictionPolicyType::ARC);
+  arc.initCache(12, 12, 4, 4);
+  ASSERT_GT(countHits(arc, accesses), countHits(lru, accesses));
+}
+
+void resizeCache(fi::EvictionPolicyType policy) {
+  fi::FigCache<int> cache(6, 2, policy);
+  cache.initCache(4, 4, 4, 4);
+  std::vector<std::pair<uint32_t, uint32_t>> accesses;
+  for (uint32_t tile = 0; tile < 6; ++tile) {
+    accesses.emplace_back(tile / 4, tile % 4);
+  }
+  countHits(cache, accesses);
+
+  // The pinned tile is only deleted once released
+  auto pinned = cache.getPinnedTile(0, 0);
+  cache.resize(1);
+  ASSERT_EQ(cache.getNbTilesCache(), cache.getNbShards());
+  ASSERT_TRUE(cache.isCached(0, 0));
+  pinned->release();
+  for (uint32_t tile = 6; tile < 16; ++tile) {
+    accesses.emplace_back(tile / 4, tile % 4);
+  }
+  countHits(cache, accesses);
+  uint32_t nbTilesInMap = 0;
+  for (auto &row : cache.getMapCache()) {
+    for (auto tile : row) { nbTilesInMap += (tile != nullptr); }
+  }
+  ASSERT_EQ(nbTilesInMap, cache.getNbTilesCache());
+
+  // The new tiles are added to the pools, bounded by the image
+  cache.resize(100);
+  ASSERT_EQ(cache.getNbTilesCache(), (uint32_t) 16);
+  uint32_t nbTiles = 0;
+  for (uint32_t shard = 0; shard < cache.getNbShards(); ++shard) {
+    nbTiles += cache.getPool(shard).size() + cache.getLru(shard).size();
+  }
+  ASSERT_EQ(nbTiles, (uint32_t) 16);
+  countHits(cache, accesses);
+}
+
+void shareCacheBudget() {
+  // Two levels, 8x8 and 4x4 tiles of 1 KB
+  fi::FigCache<int> level0(0), level1(0);
+  level0.initCache(8, 8, 16, 16);
+  level1.initCache(4, 4, 16, 16);
+  uint64_t tileBytes = level0.getTileBytes();
+  ASSERT_EQ(tileBytes, (uint64_t) 1024);
+
+  fi::CacheBudget<int> tooSmall(tileBytes);
+  tooSmall.addCache(&level0);
+  tooSmall.addCache(&level1);
+  ASSERT_THROW(tooSmall.distribute(), fi::FastImageException);
+
+  // The budget is divided following the levels working set, 16 and 8 tiles
+  fi::CacheBudget<int> budget(20 * tileBytes, 1024);
+  budget.addCache(&level0);
+  budget.addCache(&level1);
+  budget.distribute();
+  ASSERT_EQ(level0.getNbTilesCache(), (uint32_t) 13);
+  ASSERT_EQ(level1.getNbTilesCache(), (uint32_t) 7);
+  ASSERT_EQ(budget.getCacheBytes(0), 13 * tileBytes);
+
+  // Level 1 is scanned and misses, level 0 always hits: the budget moves to
+  // level 1, until it is fully cached
+  std::vector<std::pair<uint32_t, uint32_t>> hot(64, {0, 0}), scan;
+  for (uint32_t tile = 0; tile < 16; ++tile) {
+    scan.emplace_back(tile / 4, tile % 4);
+  }
+  for (uint32_t round = 0; round < 20; ++round) {
+    countHits(level0, hot);
+    countHits(level1, scan);
+    budget.rebalance();
+    ASSERT_LE(budget.getCacheBytes(0) + budget.getCacheBytes(1),
+              budget.getBudgetBytes());
+  }
+  ASSERT_GT(budget.getNbRebalances(), (uint32_t) 0);
+  ASSERT_EQ(level1.getNbTilesCache(), (uint32_t) 16);
+  ASSERT_EQ(level0.getNbTilesCache(), (uint32_t) 4);
+  uint32_t hits = level1.getHit();
+  countHits(level1, scan);
+  ASSERT_EQ(level1.getHit(), hits + 16);
+
+  // A level keeping pinned tiles is never shrunk below its minimum
+  fi::FigCache<int> pinned0(0), pinned1(0);
+  pinned0.setMinNbTilesCache(6);
+  pinned0.initCache(8, 8, 16, 16);
+  pinned1.initCache(4, 4, 16, 16);
+  ASSERT_EQ(pinned0.getMinNbTilesCache(), (uint32_t) 6);
+  ASSERT_EQ(pinned1.getMinNbTilesCache(), (uint32_t) 1);
+  fi::CacheBudget<int> pinnedBudget(20 * tileBytes, 1024);
+  pinnedBudget.addCache(&pinned0);
+  pinnedBudget.addCache(&pinned1);
+  pinnedBudget.distribute();
+  for (uint32_t round = 0; round < 20; ++round) {
+    countHits(pinned0, hot);
+    countHits(pinned1, scan);
+    pinnedBudget.rebalance();
+    ASSERT_GE(pinned0.getNbTilesCache(), (uint32_t) 6);
+  }
+  ASSERT_EQ(pinned0.getNbTilesCache(), (uint32_t) 6);
+  ASSERT_EQ(pinned1.getNbTilesCache(), (uint32_t) 14);
+  pinned0.resize(1);
+  ASSERT_EQ(pinned0.getNbTilesCache(), (uint32_t) 6);
+}
+
+template<typename T>
+void compactTierRoundTrip() {
+  fi::CompactMemoryTier<T> tier(1 << 20);
+  std::vector<T> tile(256), expanded(256);
+
+  // Pixels of a 8 bits image, packed on 8 bits
+  for (uint32_t pixel = 0; pixel < 256; ++pixel) {
+    tile[pixel] = (T) ((pixel * 7) % 256);
+  }
+  tier.store(0, 0, tile.data(), tile.size());
+  ASSERT_TRUE(tier.contains(0, 0));
+  ASSERT_TRUE(tier.fetch(0, 0, expanded.data(), expanded.size()));
+  ASSERT_EQ(tile, expanded);
+  if (sizeof(T) > 1) { ASSERT_LT(tier.getNbBytes(), 256 * sizeof(T)); }
+
+  // Constant tile
+  std::fill(tile.begin(), tile.end(), (T) 3);
+  tier.store(0, 1, tile.data(), tile.size());
+  ASSERT_TRUE(tier.fetch(0, 1, expanded.data(), expanded.size()));
+  ASSERT_EQ(tile, expanded);
+
+  // Fractional or full range pixels are kept as they are
+  for (uint32_t pixel = 0; pixel < 256; ++pixel) {
+    tile[pixel] = std::is_floating_point<T>::value ?
+                  (T) (pixel * 0.37 - 20) : std::numeric_limits<T>::max()
+                      - (T) pixel * (std::numeric_limits<T>::max() / 255);
+  }
+  tier.store(1, 0, tile.data(), tile.size());
+  ASSERT_TRUE(tier.fetch(1, 0, expanded.data(), expanded.size()));
+  ASSERT_EQ(tile, expanded);
+
+  ASSERT_FALSE(tier.fetch(1, 1, expanded.data(), expanded.size()));
+  ASSERT_EQ(tier.getHit(), (uint64_t) 3);
+  ASSERT_EQ(tier.getMiss(), (uint64_t) 1);
+}
+
+void recycleTilesInTier() {
+  // 2 tiles cached, 8 tiles in the image, the tier holds them all
+  fi::FigCache<float> cache(2);
+  cache.initCache(2, 4, 4, 4);
+  cache.addTier(std::unique_ptr<fi::ACacheTier<float>>(
+      new fi::CompactMemoryTier<float>(1 << 20)));
+  for (uint32_t round = 0; round < 2; ++round) {
+    for (uint32_t tile = 0; tile < 8; ++tile) {
+      auto cachedTile = cache.getPinnedTile(tile / 4, tile % 4);
+      if (cachedTile->beginLoading()) {
+        if (round == 0) {
+          ASSERT_FALSE(cache.loadFromTier(tile / 4, tile % 4,
+                                          cachedTile->getData()));
+          std::fill_n(cachedTile->getData(), 16, (float) tile);
+        } else {
+          ASSERT_TRUE(cache.loadFromTier(tile / 4, tile % 4,
+                                         cachedTile->getData()));
+        }
+        cachedTile->setReady();
+      }
+      for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        ASSERT_EQ(cachedTile->getData()[pixel], (float) tile);
+      }
+      cachedTile->release();
+    }
+  }
+  ASSERT_EQ(cache.getMiss(), (uint32_t) 16);
+  ASSERT_EQ(cache.getTier()->getHit(), (uint64_t) 8);
+  ASSERT_TRUE(cache.isInTier(1, 3));
+}
+
+/// Tier blocking the tiles stored until allowed to store them
+class BlockingTier : public fi::ACacheTier<float> {
+ public:
+  std::string getName() const override { return "BlockingTier"; }
+  bool contains(uint32_t, uint32_t) override { return false; }
+  void store(uint32_t, uint32_t, const float *, size_t) override {
+    storing = true;
+    while (!canStore) { std::this_thread::yield(); }
+  }
+  bool fetch(uint32_t, uint32_t, float *, size_t) override {
+    return this->countFetch(false);
+  }
+  uint64_t getNbBytes() const override { return 0; }
+
+  std::atomic<bool> storing{false}, canStore{false};
+};
+
+void storeTilesOutOfShardLock() {
+  // 2 tiles cached in 1 shard, the tile (0, 0) evicted is stored in the tier
+  fi::FigCache<float> cache(2);
+  cache.initCache(2, 4, 4, 4);
+  auto tier = new BlockingTier();
+  cache.addTier(std::unique_ptr<fi::ACacheTier<float>>(tier));
+  for (uint32_t col = 0; col < 2; ++col) {
+    auto cachedTile = cache.getPinnedTile(0, col);
+    ASSERT_TRUE(cachedTile->beginLoading());
+    cachedTile->setReady();
+    cachedTile->release();
+  }
+  std::thread evicting([&cache]() {
+    cache.getPinnedTile(0, 2)->release();
+  });
+  while (!tier->storing) { std::this_thread::yield(); }
+
+  // The shard serves its tiles while the evicted tile is stored
+  auto hit = std::async(std::launch::async, [&cache]() {
+    cache.getPinnedTile(0, 1)->release();
+  });
+  auto hitStatus = hit.wait_for(std::chrono::seconds(10));
+  tier->canStore = true;
+  evicting.join();
+  ASSERT_EQ(hitStatus, std::future_status::ready);
+  ASSERT_EQ(cache.getHit(), (uint32_t) 1);
+  ASSERT_FALSE(cache.isInCache(0, 0));
+  ASSERT_TRUE(cache.isInCache(0, 2));
+}
+
+void spillTilesToDisk() {
+  ASSERT_THROW(fi::DiskSpillTier<float>("notADirectory", "mosaic.tif", 0,
+                                        2, 4, 4, 4), fi::FastImageException);
+  std::vector<float> tile(16), copied(16);
+  std::string spillPath;
+  {
+    // First pass: the tiles loaded are written in the spill file
+    fi::FigCache<float> cache(2);
+    cache.initCache(2, 4, 4, 4);
+    cache.addTier(std::unique_ptr<fi::ACacheTier<float>>(
+        new fi::DiskSpillTier<float>(".", "mosaic.tif", 0, 2, 4, 4, 4)));
+    ASSERT_TRUE(cache.getTier()->storesLoadedTiles());
+    spillPath = dynamic_cast<fi::DiskSpillTier<float> *>(
+        cache.getTier())->getSpillPath();
+    for (uint32_t index = 0; index < 8; ++index) {
+      std::fill(tile.begin(), tile.end(), index + 0.5f);
+      ASSERT_FALSE(cache.loadFromTier(index / 4, index % 4, copied.data()));
+      cache.tileLoaded(index / 4, index % 4, tile.data());
+    }
+    ASSERT_EQ(cache.getTier()->getNbBytes(), 8 * 16 * sizeof(float));
+  }
+
+  // Next pass or process: the tiles are read back from the spill file
+  fi::DiskSpillTier<float> tier(".", "mosaic.tif", 0, 2, 4, 4, 4);
+  ASSERT_EQ(tier.getSpillPath(), spillPath);
+  ASSERT_EQ(tier.getNbBytes(), 8 * 16 * sizeof(float));
+  for (uint32_t index = 0; index < 8; ++index) {
+    ASSERT_TRUE(tier.fetch(index / 4, index % 4, copied.data(), 16));
+    for (auto pixel : copied) { ASSERT_EQ(pixel, index + 0.5f); }
+  }
+
+  // The spill file is opened while mapped by an other tier
+  fi::DiskSpillTier<float> sameFile(".", "mosaic.tif", 0, 2, 4, 4, 4);
+  ASSERT_TRUE(sameFile.contains(1, 3));
+
+  // An other level or pixel type has its own spill file
+  fi::DiskSpillTier<float> otherLevel(".", "mosaic.tif", 1, 2, 4, 4, 4);
+  fi::DiskSpillTier<double> otherType(".", "mosaic.tif", 0, 2, 4, 4, 4);
+  ASSERT_FALSE(otherLevel.contains(0, 0));
+  ASSERT_FALSE(otherType.contains(0, 0));
+
+  // An other normalization has its own spill file
+  fi::GrayscaleTiffTileLoader<float>
+      loader("mosaic.tif"),
+      normalized("mosaic.tif");
+  normalized.setNormalization(2, 1);
+  ASSERT_NE(loader.getDecodeIdentity(), normalized.getDecodeIdentity());
+  fi::DiskSpillTier<float> otherDecoding(".", "mosaic.tif", 0, 2, 4, 4, 4, 0,
+                                         normalized.getDecodeIdentity());
+  ASSERT_NE(otherDecoding.getSpillPath(), spillPath);
+  ASSERT_FALSE(otherDecoding.contains(0, 0));
+  for (auto &path : {spillPath, otherLevel.getSpillPath(),
+                     otherType.getSpillPath(),
+                     otherDecoding.getSpillPath()}) {
+    std::remove(path.c_str());
+  }
+}
+
+void limitSpillFile() {
+  std::vector<float> tile(16, 1.5f), copied(16);
+  // The tiles stored stop at the size limit
+  auto limited = std::unique_ptr<fi::DiskSpillTier<float>>(
+      new fi::DiskSpillTier<float>(".", "mosaic.tif", 0, 2, 4, 4, 4,
+                                   3 * 16 * sizeof(float)));
+  std::string spillPath = limited->getSpillPath();
+  for (uint32_t index = 0; index < 8; ++index) {
+    limited->store(index / 4, index % 4, tile.data(), 16);
+  }
+  ASSERT_EQ(limited->getNbBytes(), 3 * 16 * sizeof(float));
+  ASSERT_TRUE(limited->contains(0, 2));
+  ASSERT_FALSE(limited->contains(0, 3));
+  limited.reset();
+
+  // A tile whose data did not reach the disk does not match its checksum,
+  // it is a miss and its slot is reset
+  std::vector<float> lost(16, 0.f);
+  {
+    std::fstream spillFile(spillPath,
+                           std::ios::in | std::ios::out | std::ios::binary);
+    spillFile.seekp(-(std::streamoff) (7 * 16 * sizeof(float)),
+                    std::ios::end);
+    spillFile.write((const char *) lost.data(), 16 * sizeof(float));
+  }
+  fi::DiskSpillTier<float> tier(".", "mosaic.tif", 0, 2, 4, 4, 4);
+  ASSERT_TRUE(tier.contains(0, 1));
+  ASSERT_FALSE(tier.fetch(0, 1, copied.data(), 16));
+  ASSERT_FALSE(tier.contains(0, 1));
+  ASSERT_EQ(tier.getNbBytes(), 2 * 16 * sizeof(float));
+  ASSERT_TRUE(tier.fetch(0, 0, copied.data(), 16));
+  for (auto pixel : copied) { ASSERT_EQ(pixel, 1.5f); }
+  ASSERT_EQ(tier.getMiss(), (uint64_t) 1);
+
+  // The slot is written again
+  tier.store(0, 1, tile.data(), 16);
+  ASSERT_TRUE(tier.fetch(0, 1, copied.data(), 16));
+  std::remove(spillPath.c_str());
+}
+
+void shareCacheRegistry() {
+  auto &registry = fi::CacheRegistry<float>::getInstance();
+  uint32_t nbCreated = 0;
+  auto createCache = [&nbCreated]() {
+    ++nbCreated;
+    auto cache = new fi::FigCache<float>(4);
+    cache->initCache(2, 4, 4, 4);
+    return cache;
+  };
+  {
+    // The FastImage on the same file and level share the same cache
+    auto first = registry.getCache("mosaic.tif", 0, 4, 4, "", 0, createCache);
+    auto second =
+        registry.getCache("./mosaic.tif", 0, 4, 4, "", 0, createCache);
+    auto otherLevel =
+        registry.getCache("mosaic.tif", 1, 4, 4, "", 0, createCache);
+    ASSERT_EQ(first.get(), second.get());
+    ASSERT_NE(first.get(), otherLevel.get());
+    ASSERT_EQ(nbCreated, (uint32_t) 2);
+    ASSERT_EQ(registry.getNbCaches(), (size_t) 2);
+
+    // An other tile size or decoding gets its own cache
+    auto otherTileSize =
+        registry.getCache("mosaic.tif", 0, 8, 8, "", 0, createCache);
+    auto otherDecoding =
+        registry.getCache("mosaic.tif", 0, 4, 4, "scale=2", 0, createCache);
+    ASSERT_NE(first.get(), otherTileSize.get());
+    ASSERT_NE(first.get(), otherDecoding.get());
+    ASSERT_NE(otherTileSize.get(), otherDecoding.get());
+    ASSERT_EQ(nbCreated, (uint32_t) 4);
+
+    // A registered cache is grown to the minimum of the caller
+    ASSERT_EQ(first->getNbTilesCache(), (uint32_t) 4);
+    auto zeroCopy =
+        registry.getCache("mosaic.tif", 0, 4, 4, "", 6, createCache);
+    ASSERT_EQ(zeroCopy.get(), first.get());
+    ASSERT_EQ(first->getMinNbTilesCache(), (uint32_t) 6);
+    ASSERT_EQ(first->getNbTilesCache(), (uint32_t) 6);
+    first->resize(1);
+    ASSERT_EQ(first->getNbTilesCache(), (uint32_t) 6);
+    ASSERT_EQ(nbCreated, (uint32_t) 4);
+
+    // A tile loaded through a FastImage is a hit for the other
+    auto tile = first->getPinnedTile(1, 2);
+    ASSERT_TRUE(tile->beginLoading());
+    tile->setReady();
+    tile->release();
+    tile = second->getPinnedTile(1, 2);
+    ASSERT_FALSE(tile->beginLoading());
+    ASSERT_EQ(tile->getState(), fi::TileState::READY);
+    tile->release();
+    ASSERT_EQ(second->getHitMissCache(), std::make_pair((uint32_t) 1,
+                                                        (uint32_t) 1));
+
+    // The memory budget is shared as well
+    uint32_t nbBudgets = 0;
+    auto createBudget = [&nbBudgets, &first]() {
+      ++nbBudgets;
+      auto budget = new fi::CacheBudget<float>(8 * 4 * 4 * sizeof(float));
+      budget->addCache(first.get());
+      budget->distribute();
+      return budget;
+    };
+    auto firstBudget =
+        registry.getCacheBudget("mosaic.tif", "", createBudget);
+    auto secondBudget =
+        registry.getCacheBudget("./mosaic.tif", "", createBudget);
+    auto otherBudget =
+        registry.getCacheBudget("mosaic.tif", "scale=2", createBudget);
+    ASSERT_EQ(firstBudget.get(), secondBudget.get());
+    ASSERT_NE(firstBudget.get(), otherBudget.get());
+    ASSERT_EQ(nbBudgets, (uint32_t) 2);
+  }
+
+  // The caches released by all the FastImage are deleted
+  ASSERT_EQ(registry.getNbCaches(), (size_t) 0);
+  auto cache = registry.getCache("mosaic.tif", 0, 4, 4, "", 0, createCache);
+  ASSERT_EQ(nbCreated, (uint32_t) 5);
+  ASSERT_EQ(cache->getHitMissCache(), std::make_pair((uint32_t) 0,
+                                                     (uint32_t) 0));
+}
+
+void shareTilesBetweenProcesses() {
+  const uint32_t nbProcesses = 4, nbRounds = 200;
+  // 4 slots for the 8 tiles of the level
+  auto openTier = []() {
+    return std::unique_ptr<fi::SharedMemoryTier<float>>(
+        new fi::SharedMemoryTier<float>("mosaic.tif", 0, 2, 4, 4, 4,
+                                        4 * 16 * sizeof(float)));
+  };
+  ASSERT_THROW(fi::SharedMemoryTier<float>("mosaic.tif", 0, 2, 4, 4, 4, 16),
+               fi::FastImageException);
+  // A segment bigger than /dev/shm is not created, instead of raising SIGBUS
+  // once stored
+  struct statvfs shmStat{};
+  ASSERT_EQ(statvfs("/dev/shm", &shmStat), 0);
+  ASSERT_THROW(fi::SharedMemoryTier<float>(
+      "mosaic.tif", 0, 2048, 2048, 1024, 1024,
+      2 * (uint64_t) shmStat.f_blocks * shmStat.f_frsize),
+               fi::FastImageException);
+  openTier()->removeSegment();
+  auto tier = openTier();
+  ASSERT_EQ(tier->getNbSlots(), (uint64_t) 4);
+  ASSERT_EQ(tier->getNbBytes(), (uint64_t) 0);
+
+  // The processes decode and store the tiles, and check the ones fetched
+  std::vector<pid_t> processes;
+  for (uint32_t process = 0; process < nbProcesses; ++process) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      auto processTier = openTier();
+      std::vector<float> tile(16);
+      int nbErrors = 0;
+      for (uint32_t round = 0; round < nbRounds; ++round) {
+        uint32_t index = (round + process) % 8;
+        if (processTier->fetch(index / 4, index % 4, tile.data(), 16)) {
+          for (auto pixel : tile) { nbErrors += pixel != index + 0.5f; }
+        } else {
+          std::fill(tile.begin(), tile.end(), index + 0.5f);
+          processTier->store(index / 4, index % 4, tile.data(), 16);
+        }
+      }
+      _exit(nbErrors == 0 ? 0 : 1);
+    }
+    ASSERT_GT(pid, 0);
+    processes.push_back(pid);
+  }
+  for (auto pid : processes) {
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  // The tiles stored by the other processes are served without decoding
+  std::vector<float> tile(16);
+  ASSERT_EQ(tier->getNbBytes(), 4 * 16 * sizeof(float));
+  for (uint32_t index = 0; index < 4; ++index) {
+    std::fill(tile.begin(), tile.end(), index + 0.5f);
+    tier->store(index / 4, index % 4, tile.data(), 16);
+    ASSERT_TRUE(tier->fetch(index / 4, index % 4, tile.data(), 16));
+    for (auto pixel : tile) { ASSERT_EQ(pixel, index + 0.5f); }
+  }
+  // A tile stored in an occupied slot replaces the previous one
+  std::fill(tile.begin(), tile.end(), 4.5f);
+  tier->store(1, 0, tile.data(), 16);
+  ASSERT_TRUE(tier->contains(1, 0));
+  ASSERT_FALSE(tier->contains(0, 0));
+  ASSERT_EQ(tier->getNbBytes(), 4 * 16 * sizeof(float));
+
+  // The index words follow the 4096 bytes of header
+  int fd = shm_open(tier->getSegmentName().c_str(), O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  void *segment = mmap(nullptr, 4096 + 4 * sizeof(uint64_t),
+                       PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  ASSERT_NE(segment, MAP_FAILED);
+  auto indexWords = reinterpret_cast<std::atomic<uint64_t> *>(
+      (uint8_t *) segment + 4096);
+  tier.reset();
+
+  // A live process is writing the tile (0, 1) while the segment is reopened,
+  // its slot is left WRITING
+  int toWriter[2], fromWriter[2];
+  ASSERT_EQ(pipe(toWriter), 0);
+  ASSERT_EQ(pipe(fromWriter), 0);
+  pid_t writer = fork();
+  if (writer == 0) {
+    auto writerTier = openTier();
+    indexWords[1] = ((indexWords[1] >> 34) + 1) << 34 | (2 << 2) | 1;
+    char byte = 0;
+    bool synchronized = write(fromWriter[1], &byte, 1) == 1
+        && read(toWriter[0], &byte, 1) == 1;
+    _exit(synchronized ? 0 : 1);
+  }
+  ASSERT_GT(writer, 0);
+  char byte = 0;
+  ASSERT_EQ(read(fromWriter[0], &byte, 1), 1);
+  tier = openTier();
+  ASSERT_EQ(indexWords[1] & 3, (uint64_t) 1);
+  tier->store(0, 1, tile.data(), 16);
+  ASSERT_FALSE(tier->contains(0, 1));
+
+  // Once the writer is gone, the slot is reset by the next process opening
+  // the segment alone
+  ASSERT_EQ(write(toWriter[1], &byte, 1), 1);
+  int status = 0;
+  ASSERT_EQ(waitpid(writer, &status, 0), writer);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  for (int end : {toWriter[0], toWriter[1], fromWriter[0], fromWriter[1]}) {
+    close(end);
+  }
+  ASSERT_EQ(indexWords[1] & 3, (uint64_t) 1);
+  tier.reset();
+  tier = openTier();
+  ASSERT_EQ(indexWords[1] & 3, (uint64_t) 0);
+  tier->store(0, 1, tile.data(), 16);
+  ASSERT_TRUE(tier->contains(0, 1));
+  munmap(segment, 4096 + 4 * sizeof(uint64_t));
+  tier->removeSegment();
+}
+
+void allocateTilesInArena() {
+  for (bool hugePages : {false, true}) {
+    // 3 buffers of 17 pixels, each aligned on a cache line
+    fi::TileArena<float> arena(17, 3, hugePages);
+    ASSERT_EQ(arena.getStride(), (size_t) 128);
+    ASSERT_EQ(arena.getRegionBytes() % 4096, (size_t) 0);
+    std::vector<float *> buffers;
+    for (uint32_t buffer = 0; buffer < 3; ++buffer) {
+      buffers.push_back(arena.allocate());
+      ASSERT_TRUE(arena.isInRegion(buffers.back()));
+      ASSERT_EQ((uintptr_t) buffers.back() % fi::TileArena<float>::alignment,
+                (uintptr_t) 0);
+      std::fill_n(buffers.back(), 17, (float) buffer);
+    }
+    ASSERT_EQ((char *) buffers[2] - (char *) buffers[0], 256);
+
+    // The region exhausted, the buffers come from the heap
+    float *heapBuffer = arena.allocate();
+    ASSERT_FALSE(arena.isInRegion(heapBuffer));
+    ASSERT_EQ((uintptr_t) heapBuffer % fi::TileArena<float>::alignment,
+              (uintptr_t) 0);
+    arena.deallocate(heapBuffer);
+
+    // A buffer deallocated is given back
+    arena.deallocate(buffers[1]);
+    ASSERT_EQ(arena.allocate(), buffers[1]);
+    for (auto buffer : buffers) { arena.deallocate(buffer); }
+  }
+
+  // The cache tiles are allocated in the shards' arena, and the tiles added
+  // by a resize on the heap
+  fi::FigCache<int> cache(4, 2);
+  cache.initCache(4, 4, 16, 16, true);
+  cache.resize(8);
+  for (uint32_t tile = 0; tile < 8; ++tile) {
+    auto cachedTile = cache.getPinnedTile(tile / 4, tile % 4);
+    ASSERT_EQ((uintptr_t) cachedTile->getData()
+                  % fi::TileArena<int>::alignment, (uintptr_t) 0);
+    ASSERT_TRUE(cachedTile->beginLoading());
+    std::fill_n(cachedTile->getData(), 256, (int) tile);
+    cachedTile->setReady();
+    cachedTile->release();
+  }
+  cache.resize(2);
+}
+
+void partitionCacheByNumaNode() {
+  ASSERT_EQ(fi::NumaTopology::parseList("0-3,8,10-11\n"),
+            std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+  auto &topology = fi::NumaTopology::getInstance();
+  ASSERT_GE(topology.getNbNodes(), (uint32_t) 1);
+  ASSERT_FALSE(topology.pinThread(topology.getNbNodes()));
+
+  // The columns of tiles are split in a band per node
+  for (uint32_t col = 0; col < 8; ++col) {
+    ASSERT_EQ(fi::NumaTopology::getTileNode(col, 8, 2), col / 4);
+    ASSERT_EQ(fi::NumaTopology::getTileNode(col, 8, 1), (uint32_t) 0);
+  }
+
+  // With the default shard, each node gets a shard
+  fi::FigCache<int> defaultCache(8);
+  defaultCache.setNumaNodes(2);
+  defaultCache.initCache(4, 8, 4, 4);
+  ASSERT_EQ(defaultCache.getNbShards(), (uint32_t) 2);
+  ASSERT_EQ(defaultCache.getNbNumaNodes(), (uint32_t) 2);
+  // Without enough tiles, the shards are rounded down
+  fi::FigCache<int> smallCache(3, 3);
+  smallCache.setNumaNodes(2);
+  smallCache.initCache(4, 8, 4, 4);
+  ASSERT_EQ(smallCache.getNbShards(), (uint32_t) 2);
+
+  // The shards are split between the nodes, 5 shards rounded up to 6
+  fi::FigCache<int> cache(8, 5);
+  cache.setNumaNodes(2);
+  cache.initCache(4, 8, 4, 4);
+  ASSERT_EQ(cache.getNbShards(), (uint32_t) 6);
+  ASSERT_EQ(cache.getNbNumaNodes(), (uint32_t) 2);
+  for (uint32_t row = 0; row < 4; ++row) {
+    for (uint32_t col = 0; col < 8; ++col) {
+      ASSERT_EQ(cache.shardIndex(row, col) / 3, cache.getTileNumaNode(col));
+      auto tile = cache.getPinnedTile(row, col);
+      ASSERT_TRUE(tile->beginLoading());
+      std::fill_n(tile->getData(), 16, (int) (row * 8 + col));
+      tile->setReady();
+      tile->release();
+    }
+  }
+  ASSERT_EQ(cache.getHitMissCache(), std::make_pair((uint32_t) 0,
+                                                    (uint32_t) 32));
+}
+
+void simulateCache() {
+  // 8x8 tiles of 16x16, each view reading its 3x3 neighbour tiles
+  fi::CacheSimulator simulator(128, 128, 16, 16, 16, fi::TraversalType::SNAKE);
+  ASSERT_EQ(simulator.getNbTiles(), (uint32_t) 64);
+  ASSERT_EQ(simulator.getNbAccesses(), (size_t) (8 * 8 * 9 - 4 * 8 * 3 + 4));
+
+  // Caching the whole image, only the first access of each tile misses
+  double maxHitRate = 1 - 64. / simulator.getNbAccesses();
+  ASSERT_NEAR(simulator.simulate(64), maxHitRate, 1e-9);
+
+  // The miss ratio decreases with the cache size
+  auto curve = simulator.getMissRatioCurve({1, 4, 8, 16, 24, 32, 64});
+  ASSERT_EQ(curve.size(), (size_t) 7);
+  for (size_t point = 1; point < curve.size(); ++point) {
+    ASSERT_LE(curve[point].second, curve[point - 1].second);
+  }
+
+  // Smallest cache reaching the target, the whole image if unreachable
+  uint32_t cacheSize = simulator.findCacheSize(0.6);
+  ASSERT_GE(simulator.simulate(cacheSize), 0.6);
+  ASSERT_LT(simulator.simulate(cacheSize - 1), 0.6);
+  ASSERT_LT(cacheSize, (uint32_t) 64);
+  ASSERT_EQ(simulator.findCacheSize(1), (uint32_t) 64);
+
+  // MIN never does worse than LRU, even with several tile loaders
+  fi::CacheSimulator
+      lru(128, 128, 16, 16, 16, fi::TraversalType::SNAKE, 4),
+      min(128, 128, 16, 16, 16, fi::TraversalType::SNAKE, 4,
+          fi::EvictionPolicyType::MIN);
+  for (uint32_t size : {8, 16, 24}) {
+    ASSERT_GE(min.simulate(size), lru.simulate(size));
+  }
+
+  // Each shard evicts its own tiles, a small cache split in 8 shards misses
+  // more
+  fi::CacheSimulator
+      sharded(128, 128, 16, 16, 16, fi::TraversalType::SNAKE, 4,
+              fi::EvictionPolicyType::LRU, 8);
+  ASSERT_NEAR(sharded.simulate(64), maxHitRate, 1e-9);
+  ASSERT_GE(sharded.simulate(4), 0.);
+  ASSERT_LT(sharded.simulate(8), lru.simulate(8));
+  ASSERT_GT(sharded.findCacheSize(0.6), lru.findCacheSize(0.6));
+}
+
+void collectCacheMetrics() {
+  // Histogram in power of 2 buckets
+  fi::LatencyHistogram histogram;
+  for (uint64_t duration : {1, 3, 1000}) { histogram.record(duration); }
+  ASSERT_EQ(fi::LatencyHistogram::getBucket(1000), (uint32_t) 9);
+  ASSERT_EQ(histogram.getCount(), (uint64_t) 3);
+  ASSERT_EQ(histogram.getTotal(), (uint64_t) 1004);
+  ASSERT_EQ(histogram.getPercentile(0.5), (uint64_t) 4);
+  ASSERT_EQ(histogram.getPercentile(1), (uint64_t) 1024);
+
+  // 00 miss, 01 miss, 00 hit, 10 miss evicting 01, 01 reloaded evicting 00
+  fi::FigCache<int> cache(2);
+  cache.initCache(2, 2, 4, 4);
+  for (auto tile : std::vector<std::pair<uint32_t, uint32_t>>{
+      {0, 0}, {0, 1}, {0, 0}, {1, 0}, {0, 1}}) {
+    auto cachedTile = cache.getPinnedTile(tile.first, tile.second);
+    if (cachedTile->beginLoading()) { cachedTile->setReady(); }
+    cachedTile->release();
+  }
+
+  // A loader waits for the tile being loaded by another one
+  auto loading = cache.getPinnedTile(1, 1);
+  ASSERT_TRUE(loading->beginLoading());
+  std::thread waiter([&cache]() {
+    auto tile = cache.getPinnedTile(1, 1);
+    bool waited;
+    ASSERT_FALSE(tile->beginLoading(waited));
+    if (waited) { cache.recordInFlightWait(); }
+    cache.recordLatency(fi::LatencyType::COPY, 100);
+    tile->release();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  loading->setReady();
+  loading->release();
+  waiter.join();
+  cache.addTimeDisk(2000);
+  cache.recordLatency(fi::LatencyType::COPY, 100);
+
+  // The counters of the threads are merged in the snapshot
+  fi::CacheMetrics metrics = cache.getMetrics();
+  ASSERT_EQ(metrics.hits, (uint64_t) 2);
+  ASSERT_EQ(metrics.misses, (uint64_t) 5);
+  ASSERT_EQ(metrics.evictions, (uint64_t) 3);
+  ASSERT_EQ(metrics.reloads, (uint64_t) 1);
+  ASSERT_EQ(metrics.inFlightWaits, (uint64_t) 1);
+  ASSERT_EQ(metrics.lookup.getCount(), (uint64_t) 7);
+  ASSERT_EQ(metrics.diskRead.getTotal(), (uint64_t) 2000);
+  ASSERT_EQ(metrics.copy.getCount(), (uint64_t) 2);
+  ASSERT_EQ(metrics.decode.getCount(), (uint64_t) 0);
+  ASSERT_NEAR(metrics.getHitRate(), 2. / 7, 1e-9);
+
+  std::stringstream stats;
+  cache.printStats(1, stats);
+  ASSERT_NE(stats.str().find("reloads = 1"), std::string::npos);
+}
+
+void referenceCachedTile() {
+  fi::FigCache<int> cache(1);
+  cache.initCache(2, 2, 4, 4);
+  auto tile = cache.getPinnedTile(0, 0);
+  ASSERT_TRUE(tile->beginLoading());
+  std::fill_n(tile->getData(), 16, 7);
+  tile->setReady();
+
+  // The view references the pinned tile, released with the view
+  fi::View<int> view(4, 4);
+  int *ownData = view.getData();
+  view.referenceTile(tile);
+  ASSERT_TRUE(view.isReferencingTile());
+  ASSERT_EQ(view.getData(), tile->getData());
+  fi::ReleaseCountRule releaseRule(2);
+  releaseRule.setReleaseCallback([&view]() { view.releaseTile(); });
+  releaseRule.memoryUsed();
+  ASSERT_TRUE(tile->isPinned());
+  releaseRule.memoryUsed();
+  ASSERT_TRUE(releaseRule.canReleaseMemory());
+  ASSERT_FALSE(tile->isPinned());
+  ASSERT_FALSE(view.isReferencingTile());
+  ASSERT_EQ(view.getData(), ownData);
+
+  // Once released, the tile can be evicted
+  auto other = cache.getPinnedTile(1, 1);
+  ASSERT_FALSE(cache.isInCache(0, 0));
+  other->release();
+}
+
+void waitForUnpinnedTile() {
+  // 1 tile cached, pinned by a view
+  fi::FigCache<int> cache(1);
+  cache.initCache(2, 2, 4, 4);
+  auto pinned = cache.getPinnedTile(0, 0);
+
+  // The loader asking for an other tile sleeps until the tile is released
+  auto timeCpu = []() {
+    timespec time{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return (double) time.tv_sec + time.tv_nsec * 1e-9;
+  };
+  double cpuBegin = timeCpu();
+  auto waiting = std::async(std::launch::async, [&cache]() {
+    cache.getPinnedTile(1, 1)->release();
+  });
+  ASSERT_EQ(waiting.wait_for(std::chrono::milliseconds(300)),
+            std::future_status::timeout);
+  ASSERT_LT(timeCpu() - cpuBegin, 0.1);
+
+  pinned->release();
+  ASSERT_EQ(waiting.wait_for(std::chrono::seconds(10)),
+            std::future_status::ready);
+  ASSERT_TRUE(cache.isInCache(1, 1));
+  ASSERT_FALSE(cache.isInCache(0, 0));
+}
+
 #endif //FASTIMAGE_TESTCACHE_H
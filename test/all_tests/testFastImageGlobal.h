@@ -38,12 +38,12 @@
 #include <FastImage/FeatureCollection/FeatureCollection.h>
 #include <include/gtest/gtest.h>
 #include "Statistics.h"
+#include "testTileLoader.h"
 
-void testWholeImage() {
-
-  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif");
-  auto fi = new fi::FastImage<int>(tileLoader, 0);
-
+/// \brief Run a configured Fast Image over the whole mosaic and check its
+/// statistics
+/// \param fi Fast Image to run, deleted at the end
+void checkWholeImage(fi::FastImage<int> *fi) {
   int
       pixValue = 0;
 
@@ -96,6 +96,40 @@ void testWholeImage() {
 
 }
 
+void testWholeImage() {
+  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif");
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  ASSERT_NO_FATAL_FAILURE(checkWholeImage(fi));
+}
+
+void testWholeImagePrefetch() {
+  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif");
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  fi->getFastImageOptions()->setPrefetchDepth(4);
+  ASSERT_NO_FATAL_FAILURE(checkWholeImage(fi));
+}
+
+void testWholeImageRawTileReader() {
+  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif");
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  fi->getFastImageOptions()->setNumberOfRawTileReader(2);
+  ASSERT_NO_FATAL_FAILURE(checkWholeImage(fi));
+}
+
+void testWholeImageAsyncRead() {
+  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif");
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  fi->getFastImageOptions()->setAsyncReadQueueDepth(32);
+  ASSERT_NO_FATAL_FAILURE(checkWholeImage(fi));
+}
+
+void testWholeImageZeroCopy() {
+  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif");
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  fi->getFastImageOptions()->setZeroCopyViews(true);
+  ASSERT_NO_FATAL_FAILURE(checkWholeImage(fi));
+}
+
 void testPartImage() {
   fc::FeatureCollection featureCollection;
   auto tileLoader = new fi::GrayscaleTiffTileLoader<float>("mosaic.tif");
@@ -234,4 +268,155 @@ void testSingleTile() {
 
 }
 
+void testZeroCopyCacheBudget() {
+  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif", 2);
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  fi->getFastImageOptions()->setZeroCopyViews(true);
+  fi->getFastImageOptions()->setPreserveOrder(true);
+  fi->getFastImageOptions()->setNumberOfViewParallel(4);
+  // The budget only holds the tiles pinned by the views and the loaders
+  fi->getFastImageOptions()->setCacheMemoryBudget(
+      (4 + 2) * tileLoader->getTileHeight() * tileLoader->getTileWidth()
+          * sizeof(int));
+
+  uint64_t sum = 0, numberPixels = 0;
+  fi->configureAndRun();
+  fi->requestAllTiles(true);
+  while (fi->isGraphProcessingTiles()) {
+    auto pView = fi->getAvailableViewBlocking();
+    if (pView != nullptr) {
+      auto view = pView->get();
+      for (int32_t r = 0; r < view->getTileHeight(); ++r) {
+        for (int32_t c = 0; c < view->getTileWidth(); ++c) {
+          sum += view->getPixel(r, c);
+        }
+      }
+      numberPixels += view->getTileHeight() * view->getTileWidth();
+      pView->releaseMemory();
+    }
+  }
+  fi->waitForGraphComplete();
+
+  ASSERT_NEAR((double) sum / numberPixels, 115.6, 0.1);
+  delete fi;
+}
+
+void testRegion() {
+  auto tileLoader = new fi::GrayscaleTiffTileLoader<int>("mosaic.tif");
+  fi::GrayscaleTiffTileLoader<int> fileLoader("mosaic.tif");
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  fi->getFastImageOptions()->setNumberOfViewParallel(2);
+  fi->configureAndRun();
+
+  uint32_t
+      tileHeight = fi->getTileHeight(),
+      tileWidth = fi->getTileWidth(),
+      row = tileHeight / 2,
+      col = tileWidth / 3,
+      height = std::min(tileHeight + 7, fi->getImageHeight() - row),
+      width = std::min(2 * tileWidth, fi->getImageWidth() - col);
+
+  // The region is made of the parts of the tiles it overlaps
+  auto region = fi->requestRegion(0, row, col, height, width);
+  ASSERT_EQ(region->getRegionHeight(), height);
+  ASSERT_EQ(region->getRegionWidth(), width);
+  ASSERT_EQ(region->getGlobalRow(), row);
+  ASSERT_EQ(region->getGlobalCol(), col);
+  std::vector<int> tile(tileHeight * tileWidth);
+  for (uint32_t r = row / tileHeight; r <= (row + height - 1) / tileHeight;
+       ++r) {
+    for (uint32_t c = col / tileWidth; c <= (col + width - 1) / tileWidth;
+         ++c) {
+      fileLoader.loadTileFromFile(tile.data(), r, c);
+      for (uint32_t pixelRow = std::max(row, r * tileHeight);
+           pixelRow < std::min(row + height, (r + 1) * tileHeight);
+           ++pixelRow) {
+        for (uint32_t pixelCol = std::max(col, c * tileWidth);
+             pixelCol < std::min(col + width, (c + 1) * tileWidth);
+             ++pixelCol) {
+          ASSERT_EQ(region->getPixel(pixelRow - row, pixelCol - col),
+                    tile[(pixelRow - r * tileHeight) * tileWidth
+                        + pixelCol - c * tileWidth]);
+        }
+      }
+    }
+  }
+
+  // A region of the same size reuses the released region's pixels
+  int *pixels = region->getData();
+  region.reset();
+  region = fi->requestRegion(0, 0, 0, height, width);
+  ASSERT_EQ(region->getData(), pixels);
+  fileLoader.loadTileFromFile(tile.data(), 0, 0);
+  ASSERT_EQ(region->getPixel(0, 0), tile[0]);
+  region.reset();
+
+  ASSERT_THROW(fi->requestRegion(0, fi->getImageHeight(), 0, 1, 1),
+               fi::FastImageException);
+  ASSERT_THROW(fi->requestRegion(0, 0, 0, 0, 1), fi::FastImageException);
+  ASSERT_THROW(fi->requestRegion(1, 0, 0, 1, 1), fi::FastImageException);
+
+  fi->waitForGraphComplete();
+  delete fi;
+}
+
+void testRegionFailedTile() {
+  auto tileLoader = new FailingTileLoader(
+      "mosaic.tif", 0, 1, std::make_shared<std::atomic<int>>(1));
+  auto fi = new fi::FastImage<int>(tileLoader, 0);
+  fi->configureAndRun();
+
+  // The region fails with its tile, which is loaded again by the next region
+  uint32_t tileWidth = fi->getTileWidth();
+  ASSERT_THROW(fi->requestRegion(0, 0, tileWidth, 1, 1),
+               fi::FastImageException);
+  auto region = fi->requestRegion(0, 0, tileWidth, 1, 1);
+  fi::GrayscaleTiffTileLoader<int> fileLoader("mosaic.tif");
+  std::vector<int> tile(fi->getTileHeight() * tileWidth);
+  fileLoader.loadTileFromFile(tile.data(), 0, 1);
+  ASSERT_EQ(region->getPixel(0, 0), tile[0]);
+  region.reset();
+
+  // The graph loads all the tiles, the failed one included
+  uint32_t nbViews = 0;
+  fi->requestAllTiles(true);
+  while (fi->isGraphProcessingTiles()) {
+    auto pView = fi->getAvailableViewBlocking();
+    if (pView != nullptr) {
+      ++nbViews;
+      pView->releaseMemory();
+    }
+  }
+  fi->waitForGraphComplete();
+  ASSERT_EQ(nbViews, fi->getNumberTilesHeight() * fi->getNumberTilesWidth());
+  delete fi;
+}
+
+void testRegionPyramid() {
+  auto fi = new fi::FastImage<int>(new PyramidTileLoader(2), 0);
+  fi->configureAndRun();
+
+  // The tiles of a region are loaded at the region's level
+  for (uint32_t level = 0; level < fi->getNbPyramidLevels(); ++level) {
+    auto region = fi->requestRegion(level, 5, 7, 20, 18);
+    for (uint32_t r = 0; r < 20; ++r) {
+      for (uint32_t c = 0; c < 18; ++c) {
+        ASSERT_EQ(region->getPixel(r, c),
+                  PyramidTileLoader::pixel(level, 5 + r, 7 + c));
+      }
+    }
+  }
+  ASSERT_THROW(fi->requestRegion(1, 40, 0, 11, 1), fi::FastImageException);
+
+  // The cached tiles of the level are served to the views of the level
+  fi->requestTile(1, 0, 1, true);
+  auto pView = fi->getAvailableViewBlocking();
+  ASSERT_NE(pView, nullptr);
+  ASSERT_EQ(pView->get()->getPyramidLevel(), (uint32_t) 1);
+  ASSERT_EQ(pView->get()->getPixel(0, 0), PyramidTileLoader::pixel(1, 16, 0));
+  pView->releaseMemory();
+  fi->waitForGraphComplete();
+  delete fi;
+}
+
 #endif //FASTIMAGE_TESTFASTIMAGEGLOBAL_H
@@ -36,7 +36,7 @@
 #include <iostream>
 #include "FastImage/api/FastImage.h"
 #include "FastImage/TileLoaders/GrayscaleTiffTileLoader.h"
-bool testOrdered() {
+bool testOrdered(uint32_t reorderWindow = 0) {
   uint32_t
       prevRow = 0,
       prevCol = 0,
@@ -54,17 +54,29 @@ bool testOrdered() {
   orderedFi->getFastImageOptions()->setTraversalType(
       fi::TraversalType::DIAGONAL);
   orderedFi->getFastImageOptions()->setNumberOfViewParallel(50);
+  orderedFi->getFastImageOptions()->setReorderWindow(reorderWindow);
   orderedFi->configureAndRun();
   orderedFi->requestAllTiles(false);
   orderedFi->requestAllTiles(false);
   orderedFi->requestAllTiles(true);
 
+  // The views come in the traversal order, once per request
+  auto traversal = fi::Traversal(fi::TraversalType::DIAGONAL,
+                                 orderedFi->getNumberTilesHeight(),
+                                 orderedFi->getNumberTilesWidth())
+      .getTraversal();
+  size_t nbViews = 0;
+
   while (orderedFi->isGraphProcessingTiles()) {
     auto pView = orderedFi->getAvailableViewBlocking();
     if (pView != nullptr) {
       auto view = pView->get();
       row = view->getRow();
       col = view->getCol();
+      if (std::make_pair(row, col) != traversal[nbViews % traversal.size()]) {
+        pass = false;
+      }
+      ++nbViews;
 
       if (row > prevRow || row == 0) {
         prevCol = 0;
@@ -80,7 +92,7 @@ bool testOrdered() {
   }
   orderedFi->waitForGraphComplete();
   delete (orderedFi);
-  return pass;
+  return pass && nbViews == 3 * traversal.size();
 }
 
 #endif //FASTIMAGE_TESTORDERED_H
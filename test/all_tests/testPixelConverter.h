@@ -0,0 +1,151 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+#ifndef FASTIMAGE_TESTPIXELCONVERTER_H
+#define FASTIMAGE_TESTPIXELCONVERTER_H
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <limits>
+#include "FastImage/object/PixelConverter.h"
+
+template<typename FileType, typename UserType>
+void testConversion(double scale, double offset) {
+  using ComputeType =
+  typename std::conditional<std::is_same<UserType, float>::value,
+                            float, double>::type;
+  // Sizes around the vector widths, to test the remainders
+  for (size_t nbPixels : {0, 1, 7, 8, 9, 15, 16, 17, 31, 256, 1000}) {
+    std::vector<FileType> src(nbPixels);
+    std::vector<UserType> dest(nbPixels);
+    for (size_t pixel = 0; pixel < nbPixels; ++pixel) {
+      src[pixel] = (FileType) ((pixel * 37) % 120);
+    }
+    fi::PixelConverter<FileType, UserType>::convert(
+        src.data(), dest.data(), nbPixels, scale, offset);
+    for (size_t pixel = 0; pixel < nbPixels; ++pixel) {
+      ASSERT_EQ(dest[pixel],
+                (UserType) ((ComputeType) src[pixel] * (ComputeType) scale
+                    + (ComputeType) offset));
+    }
+  }
+}
+
+template<typename FileType>
+void testConversionFrom() {
+  ASSERT_NO_FATAL_FAILURE((testConversion<FileType, float>(1, 0)));
+  ASSERT_NO_FATAL_FAILURE((testConversion<FileType, float>(0.5, 2)));
+  ASSERT_NO_FATAL_FAILURE((testConversion<FileType, double>(1, 0)));
+  ASSERT_NO_FATAL_FAILURE((testConversion<FileType, double>(0.25, -1)));
+  ASSERT_NO_FATAL_FAILURE((testConversion<FileType, int>(1, 0)));
+  ASSERT_NO_FATAL_FAILURE((testConversion<FileType, uint8_t>(1, 0)));
+  ASSERT_NO_FATAL_FAILURE((testConversion<FileType, uint16_t>(2, 1)));
+}
+
+void testUInt32Conversion(float scale, float offset) {
+  // Values rounded when converted to float, and with the highest bit set
+  std::vector<uint32_t> src = {0, 1, 0xFFFF, 0x10000, 0x1000001, 0x1000003,
+                               0x7FFFFFFF, 0x80000000, 0x80000081,
+                               0xFFFFFF7F, 0xFFFFFF80, 0xFFFFFFFF};
+  for (uint32_t pixel = 0; pixel < 1000; ++pixel) {
+    src.push_back(pixel * 2654435761u);
+  }
+  std::vector<float> dest(src.size());
+  fi::PixelConverter<uint32_t, float>::convert(
+      src.data(), dest.data(), src.size(), scale, offset);
+  for (size_t pixel = 0; pixel < src.size(); ++pixel) {
+    ASSERT_EQ(dest[pixel], (float) src[pixel] * scale + offset);
+  }
+}
+
+template<typename FileType, typename UserType>
+void testFullRangeConversion(double scale, double offset) {
+  using ComputeType =
+  typename std::conditional<std::is_same<UserType, float>::value,
+                            float, double>::type;
+  // Negative values and the limits of the file type, to test the sign and
+  // zero extensions
+  std::vector<FileType> src = {0, 1, std::numeric_limits<FileType>::min(),
+                               std::numeric_limits<FileType>::max(),
+                               (FileType) (std::numeric_limits<FileType>::min()
+                                   + 1),
+                               (FileType) (std::numeric_limits<FileType>::max()
+                                   - 1)};
+  for (uint32_t pixel = 0; pixel < 1000; ++pixel) {
+    src.push_back((FileType) (pixel * 2654435761u));
+  }
+  std::vector<UserType> dest(src.size());
+  fi::PixelConverter<FileType, UserType>::convert(
+      src.data(), dest.data(), src.size(), scale, offset);
+  for (size_t pixel = 0; pixel < src.size(); ++pixel) {
+    if (scale == 1 && offset == 0) {
+      ASSERT_EQ(dest[pixel], (UserType) src[pixel]);
+    } else {
+      ASSERT_EQ(dest[pixel],
+                (UserType) ((ComputeType) src[pixel] * (ComputeType) scale
+                    + (ComputeType) offset));
+    }
+  }
+}
+
+template<typename FileType>
+void testFullRangeConversionFrom() {
+  ASSERT_TRUE((fi::PixelConverter<FileType, double>::isVectorized()));
+  ASSERT_TRUE((fi::PixelConverter<FileType, int32_t>::isVectorized()));
+  ASSERT_TRUE((fi::PixelConverter<FileType, uint32_t>::isVectorized()));
+  ASSERT_NO_FATAL_FAILURE((testFullRangeConversion<FileType, float>(1, 0)));
+  ASSERT_NO_FATAL_FAILURE((testFullRangeConversion<FileType, double>(1, 0)));
+  ASSERT_NO_FATAL_FAILURE(
+      (testFullRangeConversion<FileType, double>(0.25, -1)));
+  ASSERT_NO_FATAL_FAILURE((testFullRangeConversion<FileType, int32_t>(1, 0)));
+  ASSERT_NO_FATAL_FAILURE(
+      (testFullRangeConversion<FileType, uint32_t>(1, 0)));
+}
+
+void testPixelConversion() {
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<uint8_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<int8_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<uint16_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<int16_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<uint32_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<int32_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<uint64_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<int64_t>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<float>());
+  ASSERT_NO_FATAL_FAILURE(testConversionFrom<double>());
+  ASSERT_NO_FATAL_FAILURE(testUInt32Conversion(1, 0));
+  ASSERT_NO_FATAL_FAILURE(testUInt32Conversion(0.5, 2));
+  ASSERT_NO_FATAL_FAILURE(testFullRangeConversionFrom<uint8_t>());
+  ASSERT_NO_FATAL_FAILURE(testFullRangeConversionFrom<int8_t>());
+  ASSERT_NO_FATAL_FAILURE(testFullRangeConversionFrom<uint16_t>());
+  ASSERT_NO_FATAL_FAILURE(testFullRangeConversionFrom<int16_t>());
+  ASSERT_NO_FATAL_FAILURE(testFullRangeConversionFrom<uint32_t>());
+  ASSERT_NO_FATAL_FAILURE(testFullRangeConversionFrom<int32_t>());
+}
+
+#endif //FASTIMAGE_TESTPIXELCONVERTER_H
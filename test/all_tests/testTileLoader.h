@@ -38,8 +38,134 @@
 #include <htgs/api/TaskGraphRuntime.hpp>
 #include <FastImage/memory/ViewAllocator.h>
 #include <FastImage/TileLoaders/GrayscaleTiffTileLoader.h>
+#include <FastImage/TileLoaders/MMapTiffTileLoader.h>
+#include <FastImage/TileLoaders/MMapRawTileLoader.h>
+#include <FastImage/object/io/IOUringReader.h>
+#include <FastImage/object/io/PReadPoolReader.h>
+#include <FastImage/tasks/RawTileReader.h>
+#include <fstream>
+#include <thread>
 #include <include/gtest/gtest.h>
 
+/// TIFF tile loader failing to load a tile its first nbFailures times
+class FailingTileLoader : public fi::GrayscaleTiffTileLoader<int> {
+ public:
+  FailingTileLoader(const std::string &fileName, uint32_t row, uint32_t col,
+                    std::shared_ptr<std::atomic<int>> nbFailures)
+      : fi::GrayscaleTiffTileLoader<int>(fileName), _row(row), _col(col),
+        _nbFailures(std::move(nbFailures)) {}
+
+  double loadTileFromFile(int *tile, uint32_t indexRowGlobalTile,
+                          uint32_t indexColGlobalTile) override {
+    if (indexRowGlobalTile == _row && indexColGlobalTile == _col
+        && (*_nbFailures)-- > 0) {
+      // Let the other threads wait for the tile
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      throw fi::FastImageException("Failing Tile Loader ERROR: The tile can "
+                                   "not be read.");
+    }
+    return fi::GrayscaleTiffTileLoader<int>::loadTileFromFile(
+        tile, indexRowGlobalTile, indexColGlobalTile);
+  }
+
+  fi::ATileLoader<int> *copyTileLoader() override {
+    return new FailingTileLoader(getFilePath(), _row, _col, _nbFailures);
+  }
+
+ private:
+  uint32_t _row, _col;
+  std::shared_ptr<std::atomic<int>> _nbFailures;
+};
+
+/// Synthetic pyramid of 2 levels of 16x16 tiles, each pixel giving its level
+/// and its position in the level. The level loaded is the pipeline id.
+class PyramidTileLoader : public fi::ATileLoader<int> {
+ public:
+  explicit PyramidTileLoader(size_t numThreads = 1)
+      : fi::ATileLoader<int>("pyramid", numThreads) {}
+
+  static int pixel(uint32_t level, uint32_t row, uint32_t col) {
+    return (int) (level * 1000000 + row * 1000 + col);
+  }
+
+  double loadTileFromFile(int *tile, uint32_t indexRowGlobalTile,
+                          uint32_t indexColGlobalTile) override {
+    auto level = (uint32_t) getPipelineId();
+    for (uint32_t r = 0; r < 16; ++r) {
+      for (uint32_t c = 0; c < 16; ++c) {
+        tile[r * 16 + c] = pixel(level, indexRowGlobalTile * 16 + r,
+                                 indexColGlobalTile * 16 + c);
+      }
+    }
+    return 0;
+  }
+
+  std::string getName() override { return "Pyramid Tile Loader"; }
+
+  fi::ATileLoader<int> *copyTileLoader() override {
+    return new PyramidTileLoader(getNumThreads());
+  }
+
+  uint32_t getImageHeight(uint32_t level = 0) const override {
+    return 100 >> level;
+  }
+  uint32_t getImageWidth(uint32_t level = 0) const override {
+    return 80 >> level;
+  }
+  uint32_t getTileWidth(uint32_t level = 0) const override { return 16; }
+  uint32_t getTileHeight(uint32_t level = 0) const override { return 16; }
+  short getBitsPerSample() const override { return 32; }
+  uint32_t getNbPyramidLevels() const override { return 2; }
+};
+
+/// pread pool reader recording the length of the reads queued
+class CountingAsyncReader : public fi::PReadPoolReader {
+ public:
+  CountingAsyncReader(const std::string &filePath, uint32_t queueDepth,
+                      std::shared_ptr<std::vector<size_t>> readLengths)
+      : fi::PReadPoolReader(filePath, queueDepth),
+        _readLengths(std::move(readLengths)) {}
+
+  void read(void *buffer, size_t length, uint64_t offset,
+            uint64_t id) override {
+    _readLengths->push_back(length);
+    fi::PReadPoolReader::read(buffer, length, offset, id);
+  }
+
+ private:
+  std::shared_ptr<std::vector<size_t>> _readLengths;
+};
+
+/// Raw tile reader reading with a CountingAsyncReader
+class CountingRawTileReader : public fi::RawTileReader<int> {
+ public:
+  CountingRawTileReader(fi::ATileLoader<int> *tileLoader,
+                        const std::vector<fi::FigCache<int> *> &allCache,
+                        uint32_t asyncQueueDepth,
+                        std::shared_ptr<std::vector<size_t>> readLengths)
+      : fi::RawTileReader<int>(1, tileLoader, allCache, asyncQueueDepth),
+        _tileLoader(tileLoader), _allCache(allCache),
+        _asyncQueueDepth(asyncQueueDepth),
+        _readLengths(std::move(readLengths)) {}
+
+  CountingRawTileReader *copy() override {
+    return new CountingRawTileReader(_tileLoader, _allCache,
+                                     _asyncQueueDepth, _readLengths);
+  }
+
+ protected:
+  fi::AAsyncReader *createAsyncReader(const std::string &filePath,
+                                      uint32_t queueDepth) override {
+    return new CountingAsyncReader(filePath, queueDepth, _readLengths);
+  }
+
+ private:
+  fi::ATileLoader<int> *_tileLoader;
+  std::vector<fi::FigCache<int> *> _allCache;
+  uint32_t _asyncQueueDepth;
+  std::shared_ptr<std::vector<size_t>> _readLengths;
+};
+
 std::pair<htgs::TaskGraphRuntime *,
           htgs::TaskGraphConf<fi::ViewRequestData<int>,
                               fi::TileRequestData<int> > *>
@@ -133,4 +259,293 @@ void testTileLoading() {
   delete (runtime);
 }
 
+void testTileDecoding() {
+  // The uint8_t loader decodes directly into the tile, the int loader converts
+  fi::GrayscaleTiffTileLoader<uint8_t> directLoader("mosaic.tif");
+  fi::GrayscaleTiffTileLoader<int> convertLoader("mosaic.tif");
+  uint32_t
+      tileSize = directLoader.getTileHeight() * directLoader.getTileWidth(),
+      numberTilesHeight =
+      (uint32_t) ceil((double) directLoader.getImageHeight()
+                          / (double) directLoader.getTileHeight()),
+      numberTilesWidth =
+      (uint32_t) ceil((double) directLoader.getImageWidth()
+                          / (double) directLoader.getTileWidth());
+  std::vector<uint8_t> directTile(tileSize);
+  std::vector<int> convertedTile(tileSize);
+
+  for (uint32_t row = 0; row < numberTilesHeight; ++row) {
+    for (uint32_t col = 0; col < numberTilesWidth; ++col) {
+      directLoader.loadTileFromFile(directTile.data(), row, col);
+      convertLoader.loadTileFromFile(convertedTile.data(), row, col);
+      for (uint32_t i = 0; i < tileSize; ++i) {
+        ASSERT_EQ((int) directTile[i], convertedTile[i]);
+      }
+    }
+  }
+}
+
+void testRawTileDecoding() {
+  fi::GrayscaleTiffTileLoader<int> tileLoader("mosaic.tif");
+  if (!tileLoader.hasRawTileReader()) { return; }
+  uint32_t
+      tileSize = tileLoader.getTileHeight() * tileLoader.getTileWidth(),
+      numberTilesHeight =
+      (uint32_t) ceil((double) tileLoader.getImageHeight()
+                          / (double) tileLoader.getTileHeight()),
+      numberTilesWidth =
+      (uint32_t) ceil((double) tileLoader.getImageWidth()
+                          / (double) tileLoader.getTileWidth());
+  std::vector<int> loadedTile(tileSize), decodedTile(tileSize);
+  std::vector<uint8_t> rawTile;
+
+  for (uint32_t row = 0; row < numberTilesHeight; ++row) {
+    for (uint32_t col = 0; col < numberTilesWidth; ++col) {
+      tileLoader.loadTileFromFile(loadedTile.data(), row, col);
+      tileLoader.readRawTile(row, col, rawTile);
+      tileLoader.decodeTile(decodedTile.data(), row, col, rawTile);
+      ASSERT_EQ(loadedTile, decodedTile);
+    }
+  }
+}
+
+void testMMapTiffTileLoading() {
+  fi::GrayscaleTiffTileLoader<int> tiffLoader("mosaic.tif");
+  fi::MMapTiffTileLoader<int> *mmapLoader = nullptr;
+  // Only the uncompressed images can be mapped
+  try {
+    mmapLoader = new fi::MMapTiffTileLoader<int>("mosaic.tif");
+  } catch (fi::FastImageException &) { return; }
+  uint32_t
+      tileHeight = tiffLoader.getTileHeight(),
+      tileWidth = tiffLoader.getTileWidth(),
+      numberTilesHeight =
+      (uint32_t) ceil((double) tiffLoader.getImageHeight() / tileHeight),
+      numberTilesWidth =
+      (uint32_t) ceil((double) tiffLoader.getImageWidth() / tileWidth);
+  std::vector<int>
+      tiffTile(tileHeight * tileWidth),
+      mmapTile(tileHeight * tileWidth);
+
+  mmapLoader->setTraversalType(fi::TraversalType::HILBERT);
+  for (uint32_t row = 0; row < numberTilesHeight; ++row) {
+    for (uint32_t col = 0; col < numberTilesWidth; ++col) {
+      tiffLoader.loadTileFromFile(tiffTile.data(), row, col);
+      mmapLoader->loadTileFromFile(mmapTile.data(), row, col);
+      // The pixels outside of the image are not compared
+      for (uint32_t r = 0; r < tileHeight
+          && row * tileHeight + r < tiffLoader.getImageHeight(); ++r) {
+        for (uint32_t c = 0; c < tileWidth
+            && col * tileWidth + c < tiffLoader.getImageWidth(); ++c) {
+          ASSERT_EQ(tiffTile[r * tileWidth + c], mmapTile[r * tileWidth + c]);
+        }
+      }
+    }
+  }
+  delete mmapLoader;
+}
+
+void testMMapRawTileLoading() {
+  uint32_t
+      imageHeight = 50,
+      imageWidth = 70,
+      tileSize = 16;
+  {
+    // Header of 6 bytes followed by 2 planes of 16 bits pixels
+    std::ofstream rawFile("mmapRaw.raw", std::ios::binary);
+    rawFile.write("HEADER", 6);
+    for (uint16_t pixel = 0; pixel < 2 * imageHeight * imageWidth; ++pixel) {
+      rawFile.write((const char *) &pixel, sizeof(pixel));
+    }
+  }
+  // Second plane
+  fi::MMapRawTileLoader<float> rawLoader("mmapRaw.raw", imageHeight,
+                                         imageWidth, tileSize, tileSize, 1, 16,
+                                         6 + 2 * imageHeight * imageWidth);
+  std::vector<float> tile(tileSize * tileSize);
+  for (uint32_t row = 0; row < 4; ++row) {
+    for (uint32_t col = 0; col < 5; ++col) {
+      rawLoader.loadTileFromFile(tile.data(), row, col);
+      for (uint32_t i = 0; i < tileSize * tileSize; ++i) {
+        uint32_t
+            rowImage = row * tileSize + i / tileSize,
+            colImage = col * tileSize + i % tileSize;
+        float expected = rowImage < imageHeight && colImage < imageWidth ?
+                         (float) ((imageHeight + rowImage) * imageWidth
+                             + colImage) : 0.f;
+        ASSERT_EQ(expected, tile[i]);
+      }
+    }
+  }
+
+  // Half floats are not supported, the pixels would be read as 32 bits floats
+  {
+    std::string header =
+        "{'descr': '<f2', 'fortran_order': False, 'shape': (4, 4), }";
+    header.append(128 - 10 - header.size() - 1, ' ').push_back('\n');
+    std::ofstream npyFile("mmapHalf.npy", std::ios::binary);
+    npyFile.write("\x93NUMPY\x01\x00", 8);
+    uint16_t headerSize = (uint16_t) header.size();
+    npyFile.write((const char *) &headerSize, sizeof(headerSize));
+    npyFile << header << std::string(4 * 4 * 2, '\0');
+  }
+  ASSERT_THROW(fi::MMapRawTileLoader<float>("mmapHalf.npy", 4, 4),
+               fi::FastImageException);
+  ASSERT_THROW(fi::MMapRawTileLoader<float>("mmapRaw.raw", 4, 4, 4, 4, 3, 16),
+               fi::FastImageException);
+  std::remove("mmapHalf.npy");
+  std::remove("mmapRaw.raw");
+}
+
+void testFailedTileLoading() {
+  fi::GrayscaleTiffTileLoader<int> fileLoader("mosaic.tif");
+  FailingTileLoader loader(
+      "mosaic.tif", 0, 0, std::make_shared<std::atomic<int>>(1));
+  uint32_t
+      tileHeight = fileLoader.getTileHeight(),
+      tileWidth = fileLoader.getTileWidth();
+  fi::FigCache<int> cache(4);
+  cache.initCache(
+      (fileLoader.getImageHeight() + tileHeight - 1) / tileHeight,
+      (fileLoader.getImageWidth() + tileWidth - 1) / tileWidth,
+      tileHeight, tileWidth);
+
+  // The thread waiting for the tile claims its loading once the first
+  // loading failed
+  fi::CachedTile<int> *waitedTile = nullptr;
+  std::thread waiting([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    waitedTile = loader.getReadyTile(&cache, 0, 0);
+  });
+  ASSERT_THROW(loader.getReadyTile(&cache, 0, 0), fi::FastImageException);
+  waiting.join();
+  ASSERT_NE(waitedTile, nullptr);
+  ASSERT_EQ(waitedTile->getState(), fi::TileState::READY);
+  std::vector<int> tile(tileHeight * tileWidth);
+  fileLoader.loadTileFromFile(tile.data(), 0, 0);
+  ASSERT_TRUE(std::equal(tile.begin(), tile.end(), waitedTile->getData()));
+  waitedTile->release();
+  ASSERT_FALSE(waitedTile->isPinned());
+}
+
+template<class AsyncReader>
+void testAsyncRawTileReading() {
+  fi::GrayscaleTiffTileLoader<int> tileLoader("mosaic.tif");
+  if (!tileLoader.hasRawTileReader()
+      || (std::is_same<AsyncReader, fi::IOUringReader>::value
+          && !fi::IOUringReader::isSupported())) { return; }
+  uint32_t
+      queueDepth = 8,
+      tileSize = tileLoader.getTileHeight() * tileLoader.getTileWidth(),
+      numberTilesWidth =
+      (uint32_t) ceil((double) tileLoader.getImageWidth()
+                          / (double) tileLoader.getTileWidth()),
+      numberTiles = numberTilesWidth *
+      (uint32_t) ceil((double) tileLoader.getImageHeight()
+                          / (double) tileLoader.getTileHeight());
+  uint64_t
+      offset = 0,
+      length = 0;
+  std::vector<std::vector<uint8_t>> rawTiles(numberTiles);
+  std::vector<uint64_t> completed;
+  std::vector<int> loadedTile(tileSize), decodedTile(tileSize);
+
+  {
+    AsyncReader reader("mosaic.tif", queueDepth);
+    for (uint32_t tile = 0; tile < numberTiles; ++tile) {
+      ASSERT_TRUE(tileLoader.getRawTileLocation(tile / numberTilesWidth,
+                                                tile % numberTilesWidth,
+                                                offset, length));
+      rawTiles[tile].resize(length);
+      if (reader.getNbPending() == queueDepth) {
+        reader.submit();
+        reader.complete(completed, true);
+      }
+      reader.read(rawTiles[tile].data(), length, offset, tile);
+    }
+    while (reader.getNbPending() > 0) {
+      reader.submit();
+      reader.complete(completed, true);
+    }
+  }
+  ASSERT_EQ(numberTiles, completed.size());
+
+  for (uint32_t tile = 0; tile < numberTiles; ++tile) {
+    tileLoader.loadTileFromFile(loadedTile.data(), tile / numberTilesWidth,
+                                tile % numberTilesWidth);
+    tileLoader.decodeTile(decodedTile.data(), tile / numberTilesWidth,
+                          tile % numberTilesWidth, rawTiles[tile]);
+    ASSERT_EQ(loadedTile, decodedTile);
+  }
+}
+
+void testCoalescedRawTileReading() {
+  fi::GrayscaleTiffTileLoader<int> tileLoader("mosaic.tif");
+  if (!tileLoader.hasRawTileReader()) { return; }
+  uint32_t
+      tileHeight = tileLoader.getTileHeight(),
+      tileWidth = tileLoader.getTileWidth(),
+      numberTilesHeight =
+      (uint32_t) ceil((double) tileLoader.getImageHeight() / tileHeight),
+      numberTilesWidth =
+      (uint32_t) ceil((double) tileLoader.getImageWidth() / tileWidth);
+  fi::FigCache<int> cache(4);
+  cache.initCache(numberTilesHeight, numberTilesWidth, tileHeight, tileWidth);
+  std::vector<fi::FigCache<int> *> allCache = {&cache};
+
+  // A batch of a row of tiles, the reads queued being a quarter of the
+  // queue depth
+  auto readLengths = std::make_shared<std::vector<size_t>>();
+  auto rawTileReader = new CountingRawTileReader(
+      &tileLoader, allCache, 4 * numberTilesWidth, readLengths);
+  auto graph = new htgs::TaskGraphConf<fi::TileRequestData<int>,
+                                       fi::TileRequestData<int>>();
+  graph->setGraphConsumerTask(rawTileReader);
+  graph->addGraphProducerTask(rawTileReader);
+  // The requests are queued before the task starts, each batch is full
+  for (uint32_t row = 0; row < numberTilesHeight; ++row) {
+    for (uint32_t col = 0; col < numberTilesWidth; ++col) {
+      graph->produceData(std::make_shared<fi::TileRequestData<int>>(
+          row, col, nullptr, nullptr));
+    }
+  }
+  graph->finishedProducingData();
+  auto runtime = new htgs::TaskGraphRuntime(graph);
+  runtime->executeRuntime();
+  std::vector<std::shared_ptr<fi::TileRequestData<int>>> rawTiles;
+  while (!graph->isOutputTerminated()) {
+    auto tileRequestData = graph->consumeData();
+    if (tileRequestData != nullptr) { rawTiles.push_back(tileRequestData); }
+  }
+  runtime->waitForRuntime();
+  delete runtime;
+
+  // The tiles of a row, adjacent in the file, are read at once
+  ASSERT_EQ(rawTiles.size(), (size_t) numberTilesHeight * numberTilesWidth);
+  ASSERT_EQ(readLengths->size(), (size_t) numberTilesHeight);
+  uint64_t
+      offset = 0,
+      length = 0,
+      rowLength = 0;
+  for (uint32_t col = 0; col < numberTilesWidth; ++col) {
+    ASSERT_TRUE(tileLoader.getRawTileLocation(0, col, offset, length));
+    rowLength += length;
+  }
+  for (size_t readLength : *readLengths) { ASSERT_EQ(readLength, rowLength); }
+
+  // The raw tiles split from the reads decode to the tiles of the file
+  std::vector<int>
+      loadedTile(tileHeight * tileWidth),
+      decodedTile(tileHeight * tileWidth);
+  for (auto &tileRequestData : rawTiles) {
+    uint32_t
+        row = tileRequestData->getIndexRowTileAsked(),
+        col = tileRequestData->getIndexColTileAsked();
+    tileLoader.loadTileFromFile(loadedTile.data(), row, col);
+    tileLoader.decodeTile(decodedTile.data(), row, col,
+                          tileRequestData->getRawTile());
+    ASSERT_EQ(loadedTile, decodedTile);
+  }
+}
+
 #endif //FASTIMAGE_TESTTILELOADER_H
@@ -34,6 +34,9 @@
 #define FASTIMAGE_TESTVIEWCOUNTER_H
 
 #include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "FastImage/api/FastImage.h"
 #include "FastImage/TileLoaders/GrayscaleTiffTileLoader.h"
 #include <include/gtest/gtest.h>
@@ -104,4 +107,37 @@ void testViewCounterRadiusBR() {
   delete (fi);
 }
 
+void testViewCompletedByLoader() {
+  // Upper left view of radius 4, made of 2x2 tiles of 16x16
+  auto viewRequest = std::make_shared<fi::ViewRequestData<int>>(
+      0, 0, 4, 4, 4, 16, 16, 64, 64, 0);
+  fi::View<int> view(24, 24);
+  view.init(viewRequest);
+  ASSERT_EQ(viewRequest->getNumberTilesToLoad(), (uint32_t) 4);
+
+  // Only the loader of the last tile completes the view
+  std::atomic<uint32_t> nbCompleted(0);
+  std::vector<std::thread> loaders;
+  for (uint32_t loader = 0; loader < 4; ++loader) {
+    loaders.emplace_back([&view, &nbCompleted]() {
+      if (view.tileLoaded()) { ++nbCompleted; }
+    });
+  }
+  for (auto &loader : loaders) { loader.join(); }
+  ASSERT_EQ(nbCompleted.load(), (uint32_t) 1);
+
+  // The ghost region duplicates the nearest pixels from the image
+  for (int32_t r = 0; r < 20; ++r) {
+    for (int32_t c = 0; c < 20; ++c) { view.setPixel(r, c, r * 20 + c); }
+  }
+  view.fillGhostRegion();
+  ASSERT_EQ(view.getPixel(-4, -4), view.getPixel(0, 0));
+  ASSERT_EQ(view.getPixel(-1, 5), view.getPixel(0, 5));
+  ASSERT_EQ(view.getPixel(7, -3), view.getPixel(7, 0));
+
+  // The count restarts when the view is reused
+  view.init(viewRequest);
+  ASSERT_FALSE(view.tileLoaded());
+}
+
 #endif //FASTIMAGE_TESTVIEWCOUNTER_H
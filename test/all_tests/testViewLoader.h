@@ -34,6 +34,7 @@
 #define FASTIMAGE_TESTVIEWLOADER_H
 
 #include <cstdint>
+#include <thread>
 #include <FastImage/data/ViewRequestData.h>
 #include <FastImage/data/TileRequestData.h>
 #include <htgs/api/MemoryData.hpp>
@@ -42,6 +43,7 @@
 #include <htgs/api/TaskGraphRuntime.hpp>
 #include <include/gtest/gtest.h>
 #include <FastImage/memory/ViewAllocator.h>
+#include <FastImage/memory/RequestPool.h>
 
 std::pair<htgs::TaskGraphRuntime *,
           htgs::TaskGraphConf<fi::ViewRequestData<int>,
@@ -376,4 +378,47 @@ void testViewLoaderTileGhostBR() {
   delete (runtime);
 }
 
+void recycleRequests() {
+  using Pool = fi::PoolAllocator<fi::ViewRequestData<int>>::Pool;
+  std::vector<std::shared_ptr<fi::ViewRequestData<int>>> requests;
+  for (uint32_t r = 0; r < 3; ++r) {
+    requests.push_back(fi::makePooled<fi::ViewRequestData<int>>(
+        r, 1, 4, 4, 2, 5, 5, 20, 20, 0));
+    ASSERT_EQ(requests.back()->getIndexRowCenterTile(), r);
+  }
+
+  // A released request gives its block to the next one of the thread
+  auto released = requests.back().get();
+  requests.pop_back();
+  requests.push_back(fi::makePooled<fi::ViewRequestData<int>>(
+      3, 3, 4, 4, 2, 5, 5, 20, 20, 0));
+  ASSERT_EQ(requests.back().get(), released);
+  ASSERT_EQ(requests.back()->getIndexColCenterTile(), (uint32_t) 3);
+  requests.clear();
+
+  // The requests released by an other thread come back to the pool and are
+  // recycled without carving new blocks
+  fi::PoolAllocator<fi::ViewRequestData<int>> allocator;
+  std::vector<fi::ViewRequestData<int> *> blocks;
+  size_t nbBlocks = 5 * Pool::blocksPerBatch;
+  for (size_t b = 0; b < nbBlocks; ++b) {
+    blocks.push_back(allocator.allocate(1));
+  }
+  size_t nbBlocksCarved = Pool::getNbBlocks();
+  std::thread releasing([&]() {
+    for (auto block : blocks) { allocator.deallocate(block, 1); }
+    ASSERT_EQ(Pool::getNbLocalFreeBlocks(), 2 * Pool::blocksPerBatch);
+  });
+  releasing.join();
+  for (auto &block : blocks) { block = allocator.allocate(1); }
+  ASSERT_EQ(Pool::getNbBlocks(), nbBlocksCarved);
+  for (auto block : blocks) { allocator.deallocate(block, 1); }
+
+  // An allocation of more than one object is made on the heap
+  auto heapBlock = allocator.allocate(2);
+  ASSERT_NE(heapBlock, nullptr);
+  allocator.deallocate(heapBlock, 2);
+  ASSERT_EQ(Pool::getNbBlocks(), nbBlocksCarved);
+}
+
 #endif //FASTIMAGE_TESTVIEWLOADER_H
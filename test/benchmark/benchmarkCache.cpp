@@ -0,0 +1,153 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+/// @file benchmarkCache.cpp
+/// @brief Measure the FigCache throughput with multiple tile loader threads
+/// @details Each thread simulates an ATileLoader: it asks the tiles of the
+/// views following a snake traversal, and simulates the disk access with a
+/// sleep when the tile is not in the cache. The radius makes neighbouring
+/// views share tiles, so loaders often ask for a tile still being loaded.
+/// The tiles are accessed as the tile loaders do, pinned with
+/// getPinnedTile and loaded by the user claiming beginLoading, the READY
+/// tiles being read without lock. For comparison, the simulation is run
+/// again with the exclusive per tile lock of getLockedTile.
+///
+/// Usage: benchmarkCache [diskLatencyUs] [numTilesSide] [maxThreads] [nbShards]
+/// nbShards set to 0 uses one shard per thread.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "FastImage/object/FigCache.h"
+#include "FastImage/object/Traversal.h"
+
+/// \brief Protocol used to access the tiles of the cache
+enum class TileAccess {
+  PINNED,   ///< getPinnedTile, beginLoading / setReady, release: the tile
+            ///< loaders protocol
+  LOCKED    ///< getLockedTile, setNewTile, unlock: exclusive per tile lock,
+            ///< for comparison
+};
+
+/// \brief Run the simulation for a number of loader threads
+/// \param access Protocol used to access the tiles
+/// \param numThreads Number of loader threads
+/// \param numTilesSide Number of tiles in a row and in a column
+/// \param diskLatency Simulated time to load a tile from the disk
+/// \param nbShards Number of cache shards
+/// \return Number of views per second
+double runSimulation(TileAccess access,
+                     uint32_t numThreads,
+                     uint32_t numTilesSide,
+                     std::chrono::microseconds diskLatency,
+                     uint32_t nbShards) {
+  const uint32_t tileSize = 64;
+  fi::FigCache<float> cache(0, nbShards == 0 ? numThreads : nbShards);
+  cache.initCache(numTilesSide, numTilesSide, tileSize, tileSize);
+
+  fi::Traversal traversal(fi::TraversalType::SNAKE, numTilesSide, numTilesSide);
+  const auto &steps = traversal.getTraversal();
+  std::atomic<size_t> nextView(0);
+
+  auto begin = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (uint32_t thread = 0; thread < numThreads; ++thread) {
+    threads.emplace_back([&]() {
+      std::vector<float> localView(tileSize * tileSize);
+      for (size_t v = nextView++; v < steps.size(); v = nextView++) {
+        // Radius of one tile: 3x3 tiles per view
+        uint32_t
+            rowMin = steps[v].first == 0 ? 0 : steps[v].first - 1,
+            colMin = steps[v].second == 0 ? 0 : steps[v].second - 1,
+            rowMax = std::min(steps[v].first + 2, numTilesSide),
+            colMax = std::min(steps[v].second + 2, numTilesSide);
+        for (uint32_t row = rowMin; row < rowMax; ++row) {
+          for (uint32_t col = colMin; col < colMax; ++col) {
+            if (access == TileAccess::PINNED) {
+              auto tile = cache.getPinnedTile(row, col);
+              if (tile->beginLoading()) {
+                std::this_thread::sleep_for(diskLatency);
+                tile->setReady();
+              }
+              std::copy_n(tile->getData(), tileSize * tileSize,
+                          localView.data());
+              tile->release();
+            } else {
+              auto tile = cache.getLockedTile(row, col);
+              if (tile->isNewTile()) {
+                tile->setNewTile(false);
+                std::this_thread::sleep_for(diskLatency);
+              }
+              std::copy_n(tile->getData(), tileSize * tileSize,
+                          localView.data());
+              tile->unlock();
+            }
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return (double) steps.size()
+      / std::chrono::duration<double>(end - begin).count();
+}
+
+int main(int argc, char **argv) {
+  auto diskLatency = std::chrono::microseconds(argc > 1 ? atoi(argv[1]) : 500);
+  uint32_t
+      numTilesSide = argc > 2 ? (uint32_t) atoi(argv[2]) : 48,
+      maxThreads = argc > 3 ? (uint32_t) atoi(argv[3]) : 32,
+      nbShards = argc > 4 ? (uint32_t) atoi(argv[4]) : 1;
+
+  double reference = 0, lockedReference = 0;
+  std::cout << "threads, views/s, speedup, "
+               "getLockedTile views/s, getLockedTile speedup" << std::endl;
+  for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+    double
+        viewsPerSecond = runSimulation(TileAccess::PINNED, numThreads,
+                                       numTilesSide, diskLatency, nbShards),
+        lockedViewsPerSecond = runSimulation(TileAccess::LOCKED, numThreads,
+                                             numTilesSide, diskLatency,
+                                             nbShards);
+    if (numThreads == 1) {
+      reference = viewsPerSecond;
+      lockedReference = lockedViewsPerSecond;
+    }
+    std::cout << numThreads << ", " << viewsPerSecond << ", "
+              << viewsPerSecond / reference << ", " << lockedViewsPerSecond
+              << ", " << lockedViewsPerSecond / lockedReference << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+/// @file benchmarkConversion.cpp
+/// @brief Measure the pixel conversion throughput of fi::PixelConverter
+/// @details Converts a tile from uint16_t to float, the most common
+/// conversion on a cache miss, with the scalar loop and with the vectorized
+/// kernel chosen at runtime.
+///
+/// Usage: benchmarkConversion [tileSide] [nbRepetitions]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "FastImage/object/PixelConverter.h"
+
+/// \brief Measure a conversion function
+/// \param convert Conversion function
+/// \param nbRepetitions Number of conversions
+/// \return Number of pixels converted per second
+template<typename Function>
+double measure(Function convert, uint32_t nbRepetitions, size_t nbPixels) {
+  auto begin = std::chrono::high_resolution_clock::now();
+  for (uint32_t repetition = 0; repetition < nbRepetitions; ++repetition) {
+    convert();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return (double) nbPixels * nbRepetitions
+      / std::chrono::duration<double>(end - begin).count();
+}
+
+int main(int argc, char **argv) {
+  size_t tileSide = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+  uint32_t nbRepetitions =
+      argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 10) : 200;
+  size_t nbPixels = tileSide * tileSide;
+
+  std::vector<uint16_t> src(nbPixels);
+  std::vector<float> dest(nbPixels);
+  for (size_t pixel = 0; pixel < nbPixels; ++pixel) {
+    src[pixel] = (uint16_t) pixel;
+  }
+
+  using Converter = fi::PixelConverter<uint16_t, float>;
+  double
+      scalar = measure([&]() {
+        Converter::convertScalar(src.data(), dest.data(), nbPixels);
+      }, nbRepetitions, nbPixels),
+      scalarNormalized = measure([&]() {
+        Converter::convertScalar(src.data(), dest.data(), nbPixels,
+                                 1.f / 65535, 0.f);
+      }, nbRepetitions, nbPixels),
+      dispatched = measure([&]() {
+        Converter::convert(src.data(), dest.data(), nbPixels);
+      }, nbRepetitions, nbPixels),
+      dispatchedNormalized = measure([&]() {
+        Converter::convert(src.data(), dest.data(), nbPixels, 1. / 65535, 0.);
+      }, nbRepetitions, nbPixels);
+
+  std::cout << "SIMD level: " << (int) Converter::getSIMDLevel() << std::endl
+            << "uint16_t -> float, Mpixels/s" << std::endl
+            << "  scalar:                " << scalar / 1e6 << std::endl
+            << "  scalar normalized:     " << scalarNormalized / 1e6
+            << std::endl
+            << "  dispatched:            " << dispatched / 1e6 << std::endl
+            << "  dispatched normalized: " << dispatchedNormalized / 1e6
+            << std::endl;
+  return 0;
+}
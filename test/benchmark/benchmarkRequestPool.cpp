@@ -0,0 +1,132 @@
+// NIST-developed software is provided by NIST as a public service. 
+// You may use, copy and distribute copies of the  software in any  medium, 
+// provided that you keep intact this entire notice. You may improve, 
+// modify and create derivative works of the software or any portion of the 
+// software, and you may copy and distribute such modifications or works. 
+// Modified works should carry a notice stating that you changed the software 
+// and should note the date and nature of any such change. Please explicitly 
+// acknowledge the National Institute of Standards and Technology as the 
+// source of the software.
+// NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+// OF ANY KIND, EXPRESS, IMPLIED, IN FACT  OR ARISING BY OPERATION OF LAW, 
+// INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT AND DATA ACCURACY. NIST 
+// NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION  OF THE SOFTWARE WILL 
+// BE UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST 
+// DOES NOT WARRANT  OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE 
+// SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE 
+// CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+// You are solely responsible for determining the appropriateness of using 
+// and distributing the software and you assume  all risks associated with 
+// its use, including but not limited to the risks and costs of program 
+// errors, compliance  with applicable laws, damage to or loss of data, 
+// programs or equipment, and the unavailability or interruption of operation. 
+// This software is not intended to be used in any situation where a failure 
+// could cause risk of injury or damage to property. The software developed 
+// by NIST employees is not subject to copyright protection within 
+// the United States.
+
+/// @file benchmarkRequestPool.cpp
+/// @brief Measure the request allocation throughput of fi::makePooled
+/// @details Each thread creates requests held by std::shared_ptr, like the
+/// tile requests of the ViewLoader, and hands them to the next thread which
+/// releases them: the requests are released by an other thread than the one
+/// which created them. The requests are created with fi::makePooled and
+/// with std::make_shared.
+///
+/// Usage: benchmarkRequestPool [nbRequests] [maxThreads]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "FastImage/memory/RequestPool.h"
+
+/// \brief Request of the size of a tile request
+struct Request {
+  /// \brief Request constructor
+  /// \param row Tile row index
+  /// \param col Tile col index
+  Request(uint32_t row, uint32_t col) : row(row), col(col) {}
+
+  uint32_t
+      row,                            ///< Tile row index
+      col;                            ///< Tile col index
+
+  std::shared_ptr<void>
+      view,                           ///< View filled by the tile
+      viewRequest;                    ///< View request of the tile
+};
+
+/// \brief Create and release the requests with a number of threads
+/// \tparam Create Function type creating a request
+/// \param create Function creating a request
+/// \param numThreads Number of threads
+/// \param nbRequests Number of requests created by each thread
+/// \return Number of requests per second
+template<typename Create>
+double measure(Create create, uint32_t numThreads, uint32_t nbRequests) {
+  const uint32_t batchSize = 32;
+  // Each thread releases the batches of the previous one
+  std::vector<std::vector<std::shared_ptr<Request>>> mailboxes(numThreads);
+  std::vector<std::mutex> mailboxMutexes(numThreads);
+
+  auto begin = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (uint32_t thread = 0; thread < numThreads; ++thread) {
+    threads.emplace_back([&, thread]() {
+      uint32_t next = (thread + 1) % numThreads;
+      std::vector<std::shared_ptr<Request>> batch, received;
+      for (uint32_t request = 0; request < nbRequests; ++request) {
+        batch.push_back(create(request, thread));
+        if (batch.size() == batchSize) {
+          {
+            std::lock_guard<std::mutex> lock(mailboxMutexes[next]);
+            mailboxes[next].insert(mailboxes[next].end(), batch.begin(),
+                                   batch.end());
+          }
+          batch.clear();
+          {
+            std::lock_guard<std::mutex> lock(mailboxMutexes[thread]);
+            received.swap(mailboxes[thread]);
+          }
+          received.clear();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) { thread.join(); }
+  mailboxes.clear();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return (double) nbRequests * numThreads
+      / std::chrono::duration<double>(end - begin).count();
+}
+
+int main(int argc, char **argv) {
+  uint32_t
+      nbRequests =
+      argc > 1 ? (uint32_t) std::strtoul(argv[1], nullptr, 10) : 1000000,
+      maxThreads =
+      argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 10) : 16;
+
+  std::cout << "threads, pooled Mrequests/s, make_shared Mrequests/s"
+            << std::endl;
+  for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+    double
+        pooled = measure([](uint32_t row, uint32_t col) {
+          return fi::makePooled<Request>(row, col);
+        }, numThreads, nbRequests),
+        heap = measure([](uint32_t row, uint32_t col) {
+          return std::make_shared<Request>(row, col);
+        }, numThreads, nbRequests);
+    std::cout << numThreads << ", " << pooled / 1e6 << ", " << heap / 1e6
+              << std::endl;
+  }
+  return 0;
+}